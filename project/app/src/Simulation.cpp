@@ -56,6 +56,7 @@ namespace RTR {
             cubePos = Vector3::zero;
             cubeRot = Vector3::zero;
         }
+        RenderingSystem::DrawQualityGovernorUI();
         ImGui::End();
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
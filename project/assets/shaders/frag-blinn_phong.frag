@@ -1,7 +1,5 @@
 #version 460 core
 
-#define MAX_LIGHTS 1
-
 struct PointLight{
     vec3 pos;
     vec3 emission;
@@ -12,8 +10,10 @@ struct PointLight{
 in vec3 fragPos;
 in vec2 TexCoords;
 in vec3 fragNormal;
+#ifdef NORMAL_MAP
 in vec3 fragTan;
 in vec3 fragBitan;
+#endif
 
 // vec3s
 uniform vec3 diffuse;
@@ -34,12 +34,27 @@ uniform sampler2D nMap;
 // Lighting-related Input
 uniform PointLight[MAX_LIGHTS] lights;
 uniform int nLights;
-uniform int LOD;
+
+
+// Clustered lighting input (see LightClusters)
+struct ClusterLight{
+    vec4 posRange;      // world position, range of influence
+    vec4 emissionI;     // emission, intensity
+};
+layout(std430, binding = 0) readonly buffer ClusterLightBuffer { ClusterLight clusterLights[]; };
+layout(std430, binding = 1) readonly buffer ClusterIndexBuffer { uint clusterIndices[]; };
+layout(std430, binding = 2) readonly buffer ClusterRangeBuffer { uvec2 clusterRanges[]; };
+uniform int clustered;
+uniform vec3 clusterDims;
+uniform vec3 clusterSlices;
+uniform vec2 screenSize;
+uniform mat4 view;
 
 // Output(s)
 out vec4 fragColor;
 
 vec3 getNormalInWorldSpace(){
+#ifdef NORMAL_MAP
     vec3 mapNormal = texture(nMap, TexCoords * tiling).xyz;
     mapNormal = normalize(2 * (mapNormal - vec3(0.5)));
 
@@ -50,45 +65,74 @@ vec3 getNormalInWorldSpace(){
     mat3 tanSpaceMat = mat3(tan, bitan, normal);
 
     return normalize(tanSpaceMat * mapNormal);
+#else
+    return normalize(fragNormal);
+#endif
 }
 
-vec3 calculateFragColor(vec4 base){
+// finds the range of light indices of the cluster containing this fragment.
+uvec2 getClusterRange(){
+    float depth = -(view * vec4(fragPos, 1.0)).z;
+    float s = clusterSlices.z > 0.5 ? log(max(depth, 0.0001)) : depth;
+    uint slice = uint(clamp(floor(s * clusterSlices.x + clusterSlices.y), 0.0, clusterDims.z - 1.0));
+    uvec2 tile = uvec2(clamp(floor(gl_FragCoord.xy / screenSize * clusterDims.xy), vec2(0.0), clusterDims.xy - 1.0));
+    uint index = tile.x + uint(clusterDims.x) * (tile.y + uint(clusterDims.y) * slice);
+    return clusterRanges[index];
+}
+
+PointLight getClusterLight(uint i){
+    ClusterLight light = clusterLights[clusterIndices[i]];
+    return PointLight(light.posRange.xyz, light.emissionI.xyz, light.emissionI.w);
+}
+
+vec3 shadeLight(PointLight light, vec3 normal, vec4 base){
+    vec3 result = vec3(0.0);
     float shiny = 1.0 - roughness;
+    // diffuse:
+    vec3 lightDir = normalize(light.pos - fragPos);
+    // calculate distance between light src and obj.
+    float dist = max(distance(light.pos, fragPos), 0.01);
+    float attenuation = light.I / (dist*dist);
+    result += light.emission * base.xyz * max(0, dot(normal, lightDir)) * attenuation;
+
+    // specular:
+    float NdotL = dot(normal, lightDir);
+    // only render if light in front of fragment
+    if(NdotL > 0.0){
+        vec3 view = normalize(camPos - fragPos);
+        vec3 vHalf = normalize(lightDir + view);
+        float shinyFactor = mix(1.0, specular, shiny);
+        float angle = max(0.001, dot(normal, vHalf));
+        result += light.emission * pow(angle, shinyFactor) * attenuation;
+    }
+    return result;
+}
+
+vec3 calculateFragColor(vec4 base){
     vec3 result = ambient * base.xyz;
 
     // calculate normal accounting for nMap
     vec3 normal = getNormalInWorldSpace();
     // apply diffuse and specular changes for each light affecting the object.
-    for(int i = 0; i < nLights; i++){
-        PointLight light = lights[i];
-        // diffuse:
-        vec3 lightDir = normalize(light.pos - fragPos);
-        // calculate distance between light src and obj.
-        float dist = max(distance(light.pos, fragPos), 0.01);
-        float attenuation = light.I / (dist*dist);
-        result += light.emission * base.xyz * max(0, dot(normal, lightDir)) * attenuation;
-
-        // specular:
-        float NdotL = dot(normal, lightDir);
-        // only render if light in front of fragment
-        if(NdotL > 0.0){
-            vec3 view = normalize(camPos - fragPos);
-            vec3 vHalf = normalize(lightDir + view);
-            float shinyFactor = mix(1.0, specular, shiny);
-            float angle = max(0.001, dot(normal, vHalf));
-            result += light.emission * pow(angle, shinyFactor) * attenuation;
-        }
+    if(clustered == 1){
+        uvec2 range = getClusterRange();
+        for(uint i = range.x; i < range.x + range.y; i++)
+            result += shadeLight(getClusterLight(i), normal, base);
+    }
+    else{
+        for(int i = 0; i < nLights; i++)
+            result += shadeLight(lights[i], normal, base);
     }
     return result;
 }
 
 void main()
 {
-    if(LOD == 0) {
-        vec4 base_color = ambient * vec4(diffuse.xyz, alpha) * texture(image, TexCoords * tiling);
-        fragColor = vec4(base_color.xyz, alpha);
-        return;
-    }
-
+#ifdef UNLIT
+    // out of range of every loader: ambient light only.
+    vec4 base_color = ambient * vec4(diffuse.xyz, alpha) * texture(image, TexCoords * tiling);
+    fragColor = vec4(base_color.xyz, alpha);
+#else
     fragColor = vec4(calculateFragColor(vec4(diffuse, 1.0)).xyz, alpha) * texture(image, TexCoords * tiling);
+#endif
 }
@@ -1,6 +1,5 @@
 #version 460 core
 
-#define MAX_LIGHTS 1
 #define PI 3.1415
 
 struct PointLight{
@@ -13,8 +12,10 @@ struct PointLight{
 in vec3 fragPos;
 in vec2 TexCoords;
 in vec3 fragNormal;
+#ifdef NORMAL_MAP
 in vec3 fragTan;
 in vec3 fragBitan;
+#endif
 
 // vec3s
 uniform vec3 diffuse;
@@ -35,12 +36,27 @@ uniform sampler2D nMap;
 // Lighting-related Input
 uniform PointLight[MAX_LIGHTS] lights;
 uniform int nLights;
-uniform int LOD;
+
+
+// Clustered lighting input (see LightClusters)
+struct ClusterLight{
+    vec4 posRange;      // world position, range of influence
+    vec4 emissionI;     // emission, intensity
+};
+layout(std430, binding = 0) readonly buffer ClusterLightBuffer { ClusterLight clusterLights[]; };
+layout(std430, binding = 1) readonly buffer ClusterIndexBuffer { uint clusterIndices[]; };
+layout(std430, binding = 2) readonly buffer ClusterRangeBuffer { uvec2 clusterRanges[]; };
+uniform int clustered;
+uniform vec3 clusterDims;
+uniform vec3 clusterSlices;
+uniform vec2 screenSize;
+uniform mat4 view;
 
 // output(s)
 out vec4 fragColor;
 
 vec3 getNormalInWorldSpace(){
+#ifdef NORMAL_MAP
     // bump val to [-1, 1] for negative displacement (craters)
     vec3 mapNormal = texture(nMap, TexCoords).xyz;
     mapNormal = normalize(2 * (mapNormal - vec3(0.5)));
@@ -52,6 +68,67 @@ vec3 getNormalInWorldSpace(){
     mat3 tanSpaceMat = mat3(tan, bitan, normal);
 
     return normalize(tanSpaceMat * mapNormal);
+#else
+    return normalize(fragNormal);
+#endif
+}
+
+// finds the range of light indices of the cluster containing this fragment.
+uvec2 getClusterRange(){
+    float depth = -(view * vec4(fragPos, 1.0)).z;
+    float s = clusterSlices.z > 0.5 ? log(max(depth, 0.0001)) : depth;
+    uint slice = uint(clamp(floor(s * clusterSlices.x + clusterSlices.y), 0.0, clusterDims.z - 1.0));
+    uvec2 tile = uvec2(clamp(floor(gl_FragCoord.xy / screenSize * clusterDims.xy), vec2(0.0), clusterDims.xy - 1.0));
+    uint index = tile.x + uint(clusterDims.x) * (tile.y + uint(clusterDims.y) * slice);
+    return clusterRanges[index];
+}
+
+PointLight getClusterLight(uint i){
+    ClusterLight light = clusterLights[clusterIndices[i]];
+    return PointLight(light.posRange.xyz, light.emissionI.xyz, light.emissionI.w);
+}
+
+vec3 shadeLight(PointLight light, vec3 normal, vec4 base){
+    vec3 result = vec3(0.0);
+
+    // diffuse:
+    vec3 lightDir = normalize(light.pos - fragPos);
+    float brightness = max(0, dot(normal, lightDir));
+    // calculate distance between light src and obj.
+    float dist = max(distance(light.pos, fragPos), 0.01);
+    float attenuation = light.I / pow(dist, 3);
+    result += light.emission * base.xyz * brightness * attenuation;
+
+    // specular:
+    vec3 view = normalize(camPos - fragPos);
+    vec3 vHalf = normalize(lightDir + view);
+
+    // fresnel reflectance approximation
+    float m = max(0, dot(lightDir, vHalf));
+    float F = pow((1 - m), 5) * (1 - specular) + specular;
+
+    // beckmann facet vis - surface scattering approximation
+    float angle = max(0, dot(normal, vHalf));
+    float r1 = 1 / (4 * roughness * roughness * pow(angle, 4));
+    float r2 = 0;
+    if (angle > 0.001)
+        // need alt value if roughness = 0
+        r2 = (angle * angle - 1) / (roughness * roughness * angle * angle);
+    float D = r1 * exp(r2);
+
+    // Geometric shadowing (specular attenuation)
+    float g = max(0, dot(normal, view));
+    float g1 = (2.0 * angle * g) / m;
+    float g2 = (2 * angle * brightness) / m;
+    float G = min(1, min(g1, g2));
+
+    float denumerator = PI * brightness * g;
+    if(denumerator == 0)
+        denumerator = 0.001;
+    float ks = (F * D * G) / denumerator;
+
+    result += brightness * light.emission * ks * attenuation;
+    return result;
 }
 
 vec3 calculateFragColor(vec4 base){
@@ -59,57 +136,25 @@ vec3 calculateFragColor(vec4 base){
     // calculate normal accounting for nMap
     vec3 normal = getNormalInWorldSpace();
     // apply diffuse and specular changes for each light affecting the object.
-    for(int i = 0; i < nLights; i++){
-        PointLight light = lights[i];
-
-    // diffuse:
-        vec3 lightDir = normalize(light.pos - fragPos);
-        float brightness = max(0, dot(normal, lightDir));
-        // calculate distance between light src and obj.
-        float dist = max(distance(light.pos, fragPos), 0.01);
-        float attenuation = light.I / pow(dist, 3);
-        result += light.emission * base.xyz * brightness * attenuation;
-
-    // specular:
-        vec3 view = normalize(camPos - fragPos);
-        vec3 vHalf = normalize(lightDir + view);
-
-        // fresnel reflectance approximation
-        float m = max(0, dot(lightDir, vHalf));
-        float F = pow((1 - m), 5) * (1 - specular) + specular;
-
-        // beckmann facet vis - surface scattering approximation
-        float angle = max(0, dot(normal, vHalf));
-        float r1 = 1 / (4 * roughness * roughness * pow(angle, 4));
-        float r2 = 0;
-        if (angle > 0.001)
-            // need alt value if roughness = 0
-            r2 = (angle * angle - 1) / (roughness * roughness * angle * angle);
-        float D = r1 * exp(r2);
-
-        // Geometric shadowing (specular attenuation)
-        float g = max(0, dot(normal, view));
-        float g1 = (2.0 * angle * g) / m;
-        float g2 = (2 * angle * brightness) / m;
-        float G = min(1, min(g1, g2));
-
-        float denumerator = PI * brightness * g;
-        if(denumerator == 0)
-            denumerator = 0.001;
-        float ks = (F * D * G) / denumerator;
-
-        result += brightness * light.emission * ks * attenuation;
+    if(clustered == 1){
+        uvec2 range = getClusterRange();
+        for(uint i = range.x; i < range.x + range.y; i++)
+            result += shadeLight(getClusterLight(i), normal, base);
+    }
+    else{
+        for(int i = 0; i < nLights; i++)
+            result += shadeLight(lights[i], normal, base);
     }
     return result;
 }
 
 void main()
 {
-    if(LOD == 0) {
-        vec4 base_color = ambient * vec4(diffuse.xyz, alpha) * texture(image, TexCoords * tiling);
-        fragColor = vec4(base_color.xyz, alpha) ;
-        return;
-    }
-
+#ifdef UNLIT
+    // out of range of every loader: ambient light only.
+    vec4 base_color = ambient * vec4(diffuse.xyz, alpha) * texture(image, TexCoords * tiling);
+    fragColor = vec4(base_color.xyz, alpha);
+#else
     fragColor = vec4(calculateFragColor(vec4(diffuse, 1.0)).xyz, alpha) * texture(image, TexCoords * tiling);
+#endif
 }
@@ -0,0 +1,6 @@
+#version 460 core
+
+void main()
+{
+    // depth only; color writes are masked during the pre-pass.
+}
@@ -1,6 +1,5 @@
 #version 460 core
 
-#define MAX_LIGHTS 1
 #define PI 3.1415
 
 struct PointLight{
@@ -0,0 +1,104 @@
+#version 460 core
+
+#define PI 3.1415
+
+struct PointLight{
+    vec3 pos;
+    vec3 emission;
+    float I;
+};
+
+// VS inputs
+in vec3 fragPos;
+in vec2 TexCoords;
+in vec3 fragNormal;
+in vec3 fragTan;
+in vec3 fragBitan;
+
+// Vec3s
+uniform vec3 diffuse;
+uniform vec3 eta;
+uniform vec3 camPos;
+
+// floats
+uniform float tiling;
+uniform float alpha;
+uniform float metallic;
+uniform float roughness;
+uniform float ambient;
+uniform float specular;
+
+// the estimated distance light travels through the mesh
+uniform float thickness;
+
+// Samplers (broken)
+uniform sampler2D image;
+uniform sampler2D nMap;
+uniform samplerCube cubeMap;
+
+// output(s): weighted premultiplied color & weight, and the fraction of the background still visible
+layout(location = 0) out vec4 accumulation;
+layout(location = 1) out float revealage;
+
+vec3 getNormalInWorldSpace(){
+    vec3 mapNormal = texture(nMap, TexCoords).xyz;
+    mapNormal = normalize(2 * (mapNormal - vec3(0.5)));
+
+    vec3 normal = normalize(fragNormal);
+    vec3 tan = normalize(fragTan);
+    vec3 bitan = normalize(fragBitan);
+
+    mat3 tanSpaceMat = mat3(tan, bitan, normal);
+
+    return normalize(tanSpaceMat * mapNormal);
+}
+
+vec3 calculateFragColor(vec4 base){
+    // establish reflection dir [reflect(-view, normal)]
+    // calculate normal accounting for nMap
+    vec3 normal = getNormalInWorldSpace();
+    vec3 view = normalize(camPos - fragPos);
+    vec3 reflectionDir = reflect(-view, normal);
+    vec3 reflection = texture(cubeMap, reflectionDir).xyz;
+
+    // refraction - chromatic aberrations by scattering the refraction angles by color channel
+    vec3 rRefractDir = refract(-view, normal, eta.r);
+    // guardrails for total reflection
+    if(length(rRefractDir) < 0.001)
+        rRefractDir = reflectionDir;
+    vec3 gRefractDir = refract(-view, normal, eta.g);
+    if(length(gRefractDir) < 0.001)
+        gRefractDir = reflectionDir;
+    vec3 bRefractDir = refract(-view, normal, eta.b);
+    if(length(bRefractDir) < 0.001)
+        bRefractDir = reflectionDir;
+
+    vec3 refraction = vec3(
+        texture(cubeMap, rRefractDir).r,
+        texture(cubeMap, gRefractDir).g,
+        texture(cubeMap, bRefractDir).b
+    );
+
+    // m should be view.normal?
+    float m = max(0, dot(view, normal));
+    float F = pow((1 - m), 5) * (1 - specular) + specular;
+
+    // reflection color calculation; blended using Fresnel approximation.
+    vec3 cLight = mix(refraction, reflection, F);
+
+    // depth component for transmittance effects
+    float depth = max(thickness, 0.001);
+
+    vec3 result = exp(-ambient * depth) * cLight * base.xyz;
+    return result;
+}
+
+void main()
+{
+    vec3 color = calculateFragColor(vec4(diffuse, 1.0)).xyz;
+    // weight nearer & more opaque surfaces higher (McGuire & Bavoil 2013, eq. 10).
+    float weight = clamp(pow(min(1.0, alpha * 10.0) + 0.01, 3.0) * 1e8 * pow(1.0 - gl_FragCoord.z * 0.9, 3.0),
+                         1e-2, 3e3);
+    accumulation = vec4(color * alpha, alpha) * weight;
+    revealage = alpha;
+}
@@ -0,0 +1,22 @@
+#version 460 core
+
+// Samplers
+uniform sampler2D accumMap;
+uniform sampler2D revealMap;
+
+// output(s)
+out vec4 fragColor;
+
+void main()
+{
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    float revealage = texelFetch(revealMap, texel, 0).r;
+    // no translucent surface covers this pixel.
+    if(revealage >= 1.0)
+        discard;
+
+    vec4 accumulation = texelFetch(accumMap, texel, 0);
+    vec3 average = accumulation.rgb / max(accumulation.a, 1e-5);
+    // blended with (1 - src alpha, src alpha): the background is attenuated by the revealage.
+    fragColor = vec4(average, revealage);
+}
@@ -0,0 +1,13 @@
+#version 460 core
+
+in vec2 TexCoords;
+in vec4 Color;
+
+uniform sampler2D image;
+
+out vec4 fragColor;
+
+void main()
+{
+    fragColor = Color * texture(image, TexCoords);
+}
@@ -0,0 +1,13 @@
+#version 460 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec4 aColor;
+
+uniform mat4 vp;
+
+out vec4 Color;
+
+void main() {
+    gl_Position = vp * vec4(aPos, 1.0);
+    Color = aColor;
+}
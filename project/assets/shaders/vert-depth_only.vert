@@ -0,0 +1,13 @@
+#version 460 core
+
+in vec3 aPos;
+
+uniform mat4 mvp;
+
+// must match the lit shaders' depth exactly for the GL_EQUAL test of the depth pre-pass.
+invariant gl_Position;
+
+void main()
+{
+    gl_Position = mvp * vec4(aPos.xyz, 1.0);
+}
@@ -0,0 +1,17 @@
+#version 460 core
+
+in vec3 aPos;
+
+// per-instance attributes
+in mat4 instanceModel;
+
+uniform mat4 vp;
+
+// must match the lit shaders' depth exactly for the GL_EQUAL test of the depth pre-pass.
+invariant gl_Position;
+
+void main()
+{
+    vec4 worldPos = instanceModel * vec4(aPos.xyz, 1.0);
+    gl_Position = vp * worldPos;
+}
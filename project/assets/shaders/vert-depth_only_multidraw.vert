@@ -0,0 +1,25 @@
+#version 460 core
+
+in vec3 aPos;
+
+// per-draw data: the model matrix (16 floats) followed by the normal matrix (9 floats) of every draw.
+layout(std430, binding = 3) readonly buffer DrawDataBuffer { float drawData[]; };
+// the position of the multi-draw's first draw within drawData.
+uniform int drawDataOffset;
+
+uniform mat4 vp;
+
+// must match the lit shaders' depth exactly for the GL_EQUAL test of the depth pre-pass.
+invariant gl_Position;
+
+void main()
+{
+    int base = drawDataOffset + gl_DrawID * 25;
+    mat4 drawModel;
+    for(int c = 0; c < 4; c++)
+        drawModel[c] = vec4(drawData[base + c * 4], drawData[base + c * 4 + 1],
+                            drawData[base + c * 4 + 2], drawData[base + c * 4 + 3]);
+
+    vec4 worldPos = drawModel * vec4(aPos.xyz, 1.0);
+    gl_Position = vp * worldPos;
+}
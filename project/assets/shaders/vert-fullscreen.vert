@@ -0,0 +1,8 @@
+#version 460 core
+
+void main()
+{
+    // a single triangle covering the screen, generated from the vertex index.
+    vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(pos * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -3,8 +3,10 @@
 in vec3 aPos;
 in vec3 normal;
 in vec2 texCoords;
+#ifdef NORMAL_MAP
 in vec3 tan;
 in vec3 bitan;
+#endif
 
 uniform mat4 mvp;
 uniform mat3 normalMat;
@@ -13,15 +15,22 @@ uniform mat4 model;
 out vec3 fragPos;
 out vec2 TexCoords;
 out vec3 fragNormal;
+#ifdef NORMAL_MAP
 out vec3 fragTan;
 out vec3 fragBitan;
+#endif
+
+// computed exactly like the depth pre-pass' position for its GL_EQUAL test.
+invariant gl_Position;
 
 void main()
 {
     TexCoords = texCoords;
     fragNormal = normalMat * normal;
+#ifdef NORMAL_MAP
     fragTan = normalMat * tan;
     fragBitan = normalMat * bitan;
+#endif
     gl_Position = mvp * vec4(aPos.xyz, 1.0);
     fragPos = (model * vec4(aPos.xyz, 1.0)).xyz;
 }
@@ -0,0 +1,39 @@
+#version 460 core
+
+in vec3 aPos;
+in vec3 normal;
+in vec2 texCoords;
+#ifdef NORMAL_MAP
+in vec3 tan;
+in vec3 bitan;
+#endif
+
+// per-instance attributes
+in mat4 instanceModel;
+in mat3 instanceNormalMat;
+
+uniform mat4 vp;
+
+out vec3 fragPos;
+out vec2 TexCoords;
+out vec3 fragNormal;
+#ifdef NORMAL_MAP
+out vec3 fragTan;
+out vec3 fragBitan;
+#endif
+
+// computed exactly like the depth pre-pass' position for its GL_EQUAL test.
+invariant gl_Position;
+
+void main()
+{
+    TexCoords = texCoords;
+    fragNormal = instanceNormalMat * normal;
+#ifdef NORMAL_MAP
+    fragTan = instanceNormalMat * tan;
+    fragBitan = instanceNormalMat * bitan;
+#endif
+    vec4 worldPos = instanceModel * vec4(aPos.xyz, 1.0);
+    fragPos = worldPos.xyz;
+    gl_Position = vp * worldPos;
+}
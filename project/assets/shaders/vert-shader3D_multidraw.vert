@@ -0,0 +1,50 @@
+#version 460 core
+
+in vec3 aPos;
+in vec3 normal;
+in vec2 texCoords;
+#ifdef NORMAL_MAP
+in vec3 tan;
+in vec3 bitan;
+#endif
+
+// per-draw data: the model matrix (16 floats) followed by the normal matrix (9 floats) of every draw.
+layout(std430, binding = 3) readonly buffer DrawDataBuffer { float drawData[]; };
+// the position of the multi-draw's first draw within drawData.
+uniform int drawDataOffset;
+
+uniform mat4 vp;
+
+out vec3 fragPos;
+out vec2 TexCoords;
+out vec3 fragNormal;
+#ifdef NORMAL_MAP
+out vec3 fragTan;
+out vec3 fragBitan;
+#endif
+
+// computed exactly like the depth pre-pass' position for its GL_EQUAL test.
+invariant gl_Position;
+
+void main()
+{
+    int base = drawDataOffset + gl_DrawID * 25;
+    mat4 drawModel;
+    for(int c = 0; c < 4; c++)
+        drawModel[c] = vec4(drawData[base + c * 4], drawData[base + c * 4 + 1],
+                            drawData[base + c * 4 + 2], drawData[base + c * 4 + 3]);
+    mat3 drawNormalMat;
+    for(int c = 0; c < 3; c++)
+        drawNormalMat[c] = vec3(drawData[base + 16 + c * 3], drawData[base + 16 + c * 3 + 1],
+                                drawData[base + 16 + c * 3 + 2]);
+
+    TexCoords = texCoords;
+    fragNormal = drawNormalMat * normal;
+#ifdef NORMAL_MAP
+    fragTan = drawNormalMat * tan;
+    fragBitan = drawNormalMat * bitan;
+#endif
+    vec4 worldPos = drawModel * vec4(aPos.xyz, 1.0);
+    fragPos = worldPos.xyz;
+    gl_Position = vp * worldPos;
+}
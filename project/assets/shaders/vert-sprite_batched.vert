@@ -0,0 +1,16 @@
+#version 460 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 texCoords;
+layout(location = 2) in vec4 aColor;
+
+uniform mat4 vp;
+
+out vec2 TexCoords;
+out vec4 Color;
+
+void main() {
+    gl_Position = vp * vec4(aPos, 1.0);
+    TexCoords = texCoords;
+    Color = aColor;
+}
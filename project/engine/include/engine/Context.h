@@ -1,12 +1,37 @@
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include <functional>
+#include <memory>
 #include <OpenGL/OpenGlInclude.h>
 #include "engine/utilities/Vector2.h"
 #include "engine/utilities/Color.h"
 
+namespace EisEngine::rendering {
+    struct CapturedFrame;
+    class FrameReadback;
+}
+
 namespace EisEngine::ctx {
+    /// \n Determines whether a context opens a window with a graphics context.
+    enum class ContextMode {
+        /// \n A full-screen window with an OpenGL 4.6 core context.
+        Window,
+        /// \n No window and no graphics context, e.g. for benchmarks on machines without a GPU.\n
+        /// GPU resources are not created and rendering stops after the CPU-side preparation.
+        Headless,
+        /// \n An OpenGL 4.6 core context without a visible window, e.g. for rendering frames in batch on servers.\n
+        /// Frames are drawn into an offscreen framebuffer at the headless size, nothing is presented and the loop
+        /// runs as fast as the frames are rendered. Where GLFW offers it, no display is needed: the context is
+        /// created through EGL (surfaceless, on GPU drivers) or OSMesa (software, e.g. llvmpipe).
+        Offscreen,
+        /// \n No window, no graphics context and no rendering at all: games only run their simulation, i.e. entities,
+        /// scripts, animations & physics, e.g. for servers or batch jobs. Combine with SetFixedTimeStep for
+        /// reproducible runs and with SetFrameRateLimit for real-time ticks; otherwise the loop runs uncapped.
+        Simulation
+    };
+
     /// \n A class handling all the relevant background information of a game.
     class Context {
     public:
@@ -16,7 +41,8 @@ namespace EisEngine::ctx {
         /// @param width - the width of the game window.
         /// @param height - the height of the game window.
         /// @param title - the title of the game window.
-        explicit Context(const std::string &title = "Game");
+        /// @param mode - whether to open a window, render offscreen or run headless.
+        explicit Context(const std::string &title = "Game", ContextMode mode = ContextMode::Window);
         ~Context();
 
         /// \n Begins the run of a window context.
@@ -24,7 +50,12 @@ namespace EisEngine::ctx {
         void run(const Callback& update);
 
         /// \n Gives the signal for the active window to close.
-        void CloseWindow(){ glfwSetWindowShouldClose(window, true);}
+        void CloseWindow(){
+            if(window)
+                glfwSetWindowShouldClose(window, true);
+            else
+                closeRequested = true;
+        }
 
         /// \n Fetches a pointer to the window.
         /// @return @a GLFWwindow* - a pointer to the game's window.
@@ -32,6 +63,8 @@ namespace EisEngine::ctx {
 
         /// \n Gets the dimensions of the game window by **editing** the provided width and height variables.
         Vector2 GetWindowSize() {
+            if(mode != ContextMode::Window)
+                return headlessSize;
             int width = 0;
             int height = 0;
             glfwGetWindowSize(window, &width, &height);
@@ -39,12 +72,48 @@ namespace EisEngine::ctx {
         }
 
         static void SetClearColor(const Color& newColor) { m_clearColor = newColor;}
+        static const Color& GetClearColor() { return m_clearColor;}
+        /// \n The duration of the last frame's update callback in milliseconds, i.e. the CPU time of the frame
+        /// without waiting for the display.
+        [[nodiscard]] double GetUpdateTime() const { return updateTime;}
+
+        /// \n Whether this context runs without a window.
+        [[nodiscard]] bool IsHeadless() const { return window == nullptr;}
+        /// \n Whether games running in this context skip rendering entirely.
+        [[nodiscard]] bool IsSimulation() const { return mode == ContextMode::Simulation;}
+        /// \n Whether this context renders into an offscreen framebuffer instead of a window.
+        [[nodiscard]] bool IsOffscreen() const { return mode == ContextMode::Offscreen;}
+        /// \n Sets the screen size reported by headless contexts and the resolution of offscreen contexts,
+        /// applied from the next frame on.
+        void SetHeadlessSize(const Vector2& size) { headlessSize = size;}
+        /// \n Sets a callback receiving each frame rendered by an offscreen context, read back asynchronously a few
+        /// frames after it was drawn. Frames are only read back while a callback is set.
+        void SetFrameCallback(std::function<void(const rendering::CapturedFrame&)> callback);
+        /// \n Advances the game time by a fixed step each frame instead of by the measured frame time, making runs
+        /// independent of the machine's speed. 0 measures the frame time again.
+        /// @param seconds - double: the delta time of each frame.
+        void SetFixedTimeStep(double seconds) { fixedTimeStep = std::max(seconds, 0.0);}
+        /// \n The fixed delta time of each frame, 0 if the frame time is measured.
+        [[nodiscard]] double GetFixedTimeStep() const { return fixedTimeStep;}
+        /// \n Limits the amount of frames per second of contexts without a window by waiting for the next frame's
+        /// turn. 0 runs uncapped.
+        void SetFrameRateLimit(double framesPerSecond) { frameRateLimit = std::max(framesPerSecond, 0.0);}
+        /// \n Whether a graphics context has been created, i.e. whether GPU resources can be created.
+        static bool HasGraphics() { return graphicsAvailable;}
+        /// \n The framebuffer frames are presented from: the window's, or the offscreen target.
+        static GLuint GetDefaultFramebuffer() { return defaultFramebuffer;}
     private:
         /// \n Initializes OpenGL window parameters.
         static void InitializeGLFW();
         /// \n Creates a new window.
         /// @param title - std::string: window title.
         void createWindow(const std::string &title);
+        /// \n Creates a hidden window for its OpenGL context, preferring context APIs that need no display.
+        void createOffscreenContext(const std::string &title);
+        /// \n (Re)creates the offscreen framebuffer at the headless size.
+        void InitOffscreenTarget();
+        /// \n Deletes the offscreen framebuffer & its render buffers.
+        void ReleaseOffscreenTarget();
 
         /// \n Initializes and loads Glad.
         static void LoadGLAD();
@@ -53,5 +122,31 @@ namespace EisEngine::ctx {
         /// \n Initializes and loads ImGUI
         void LoadImGUI();
         static Color m_clearColor;
+        ContextMode mode;
+        /// \n Set by CloseWindow in headless contexts.
+        bool closeRequested = false;
+        /// \n The screen size reported by headless contexts & the resolution of offscreen contexts.
+        Vector2 headlessSize = Vector2(1920, 1080);
+        /// \n Whether a graphics context has been created.
+        static bool graphicsAvailable;
+        /// \n 0 for windows, the offscreen framebuffer otherwise.
+        static GLuint defaultFramebuffer;
+        /// \n The render buffers of the offscreen framebuffer & their size.
+        GLuint offscreenColor = 0;
+        GLuint offscreenDepth = 0;
+        Vector2 offscreenSize = Vector2(0, 0);
+        /// \n Reads back offscreen frames while a frame callback is set.
+        std::unique_ptr<rendering::FrameReadback> readback;
+        /// \n The duration of the last update callback in milliseconds.
+        double updateTime = 0.0;
+        /// \n The delta time of each frame, 0 if measured.
+        double fixedTimeStep = 0.0;
+        /// \n The maximum frames per second of contexts without a window, 0 if uncapped.
+        double frameRateLimit = 0.0;
+        /// \n The loop of offscreen contexts: renders into the offscreen target & reads frames back, without waiting
+        /// for a display.
+        void runOffscreen(const Callback& update);
+        /// \n Runs the update callback, measuring its duration.
+        void TimedUpdate(const Callback& update);
     };
 }
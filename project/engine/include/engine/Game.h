@@ -30,7 +30,9 @@ namespace EisEngine {
     public:
         /// \n Creates an instance of a game.
         /// @param title - game window title.
-        Game(const std::string &title);
+        /// @param mode - ContextMode: whether to open a window, render offscreen, run headless or only simulate
+        /// (see ContextMode).
+        Game(const std::string &title, ctx::ContextMode mode = ctx::ContextMode::Window);
         /// \n Terminates the instance of the game.
         virtual ~Game();
 
@@ -42,6 +44,8 @@ namespace EisEngine {
         /// \n Fetches the game window.
         /// @return @a GLFWwindow* - a pointer to a GLFW window.
         [[nodiscard]] GLFWwindow *getWindow();
+        /// \n Access the spatial index of all renderables and lights, e.g. for picking or proximity queries.
+        [[nodiscard]] SceneIndex& GetSceneIndex() { return sceneIndex;}
 
         /// \n an event invoked right at the start of the game's lifetime.
         event_t onStartup;
@@ -85,12 +89,14 @@ namespace EisEngine {
         /// \n The game loop, defines the sequence of actions.
         void GameLoop();
 
-        /// \n A system used to draw lines.
+        /// \n The system drawing all meshes (see RenderingSystem::SetRenderBackend).
         RenderingSystem renderingSystem;
         /// \n A system tasked with managing transform relations.
         SceneGraphPruner sceneGraphPruner;
         /// \n A system tasked with updating transforms.
         SceneGraphUpdater sceneGraphUpdater;
+        /// \n A system keeping a spatial index of renderables and lights.
+        SceneIndex sceneIndex;
     private:
         /// \n The EisEngine input manager.
         Input input;
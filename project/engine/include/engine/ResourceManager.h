@@ -1,10 +1,14 @@
 #pragma once
 
 #include "engine/utilities/rendering/Texture2D.h"
+#include "engine/utilities/rendering/TextureAtlas.h"
 #include "engine/utilities/rendering/Shader.h"
+#include "engine/utilities/rendering/ProgramBinaryCache.h"
 #include "engine/utilities/rendering/Material.h"
+#include "engine/utilities/rendering/PrimitiveMesh3D.h"
 #include "engine/ecs/Entity.h"
 
+#include <chrono>
 #include <filesystem>
 #include <map>
 #include <assimp/material.h>
@@ -41,6 +45,24 @@ namespace EisEngine {
 
     using Shader = rendering::Shader;
 
+    /// \n The files & defines a shader was generated from, used to compile its variants.
+    struct ShaderSource {
+        fs::path vertexPath;
+        fs::path fragmentPath;
+        /// \n The defines shared by all variants of the shader.
+        std::vector<std::string> defines;
+    };
+
+    /// \n The time spent creating shader programs.
+    struct ShaderLoadStats {
+        /// \n The amount of programs created.
+        size_t programs = 0;
+        /// \n The amount of programs loaded from the program binary cache instead of compiled.
+        size_t cachedPrograms = 0;
+        /// \n The total time in milliseconds spent creating programs, waiting for the driver included.
+        double milliseconds = 0.0;
+    };
+
     /// \n Manages files associated with the engine.
     class ResourceManager {
         friend class Game;
@@ -57,6 +79,15 @@ namespace EisEngine {
 
         /// \n fetches a texture using its name.
         static Texture2D* GetTexture(const std::string& name);
+        /// \n Packs a small texture into the texture atlas. Sprites using the texture are then drawn from the
+        /// atlas page instead, with their texture coordinates rewritten, so they batch with other packed sprites.
+        /// @param textureName - std::string: the name of a generated texture.
+        /// @returns const AtlasRegion*: the texture's region in the atlas, or nullptr if it is too large or missing.
+        static const rendering::AtlasRegion* PackIntoAtlas(const std::string& textureName);
+        /// \n Removes a texture from the texture atlas; sprites using it are drawn from the texture itself again.
+        static void RemoveFromAtlas(const std::string& textureName);
+        /// \n The texture atlas shared by all packed textures.
+        static rendering::TextureAtlas& GetAtlas() { return Atlas;}
 
         /// \n Generates a cubemap texture from 6 images in order right - left - top - bottom - front - back.
         static Cubemap* GenerateCubemapFromFiles(const std::vector<std::string>& imagePaths, const std::string& cubemapName);
@@ -76,9 +107,29 @@ namespace EisEngine {
         /// @param fragmentShaderPath - std::filesystem::path: the relative path from the assets folder
         /// to the fragment shader definition.
         /// @param shaderName - std::string: the UNIQUE name for the shader.
+        /// @param defines - std::vector&lt;std::string>: defines injected after the #version directive of both
+        /// stages, e.g. "NORMAL_MAP" or "LEVELS 4". Engine constants (MAX_LIGHTS) are always injected.
         static Shader* GenerateShaderFromFiles(const fs::path& vertexShaderPath,
                                                const fs::path& fragmentShaderPath,
-                                               const std::string& shaderName);
+                                               const std::string& shaderName,
+                                               const std::vector<std::string>& defines = {});
+        /// \n Fetches the permutation of a generated shader compiled with additional keyword defines,
+        /// compiling it on first use. Variants are cached by the shader's name & the sorted set of defines.
+        /// @param shaderName - std::string: the name the shader was generated with.
+        /// @param keywords - std::vector&lt;std::string>: the additional defines. Empty returns the shader itself.
+        static Shader* GetShaderVariant(const std::string& shaderName, const std::vector<std::string>& keywords);
+
+        /// \n Defers checking the compilation of the shaders generated until the matching EndShaderBatch, so that
+        /// the driver compiles them concurrently (GL_KHR_parallel_shader_compile) rather than one after another.
+        /// The uniforms of shaders generated within a batch cannot be set until it ends. Batches may be nested.
+        static void BeginShaderBatch();
+        /// \n Waits for the shaders of the batch, reports compilation errors & stores the programs in the
+        /// program binary cache.
+        static void EndShaderBatch();
+        /// \n Sets the directory of the program binary cache. Empty disables the cache.
+        static void SetShaderCacheDirectory(const fs::path& directory) { ProgramCache.SetDirectory(directory);}
+        /// \n The time spent creating shader programs since the start.
+        static const ShaderLoadStats& GetShaderLoadStats() { return ShaderStats;}
     private:
         /// \n Inaccessible constructor. All functions should be used as static members.
         ResourceManager() { }
@@ -89,11 +140,41 @@ namespace EisEngine {
         static std::map<std::string, std::unique_ptr<Texture2D>> Textures;
         /// \n A dictionary of textures associated to their file name.
         static std::map<std::string, std::unique_ptr<Cubemap>> Cubemaps;
-        /// \n A dictionary of shaders associated to their name.
+        /// \n The atlas holding the packed textures.
+        static rendering::TextureAtlas Atlas;
+        /// \n A dictionary of shaders associated to their name. Variants are stored as "name [DEFINE ...]".
         static std::map<std::string, std::unique_ptr<Shader>> Shaders;
+        /// \n The sources of the generated shaders associated to their name.
+        static std::map<std::string, ShaderSource> ShaderSources;
         /// \n A dictionary of materials associated to their name.
         static std::map<std::string, std::unique_ptr<Material>> Materials;
 
+        /// \n A program linking in the background, whose status is checked at the end of the batch.
+        struct PendingProgram {
+            GLuint program;
+            GLuint vertexShader;
+            GLuint fragmentShader;
+            /// \n The program's key in the program binary cache.
+            uint64_t key;
+            std::string name;
+        };
+        /// \n A shader stage compiled within the current batch, shared by all programs using the same source.
+        struct CompiledStage {
+            GLuint id;
+            fs::path path;
+        };
+        /// \n The stored binaries of previously linked programs.
+        static rendering::ProgramBinaryCache ProgramCache;
+        /// \n The programs of the current batch still compiling.
+        static std::vector<PendingProgram> PendingPrograms;
+        /// \n The stages of the current batch associated to their final source.
+        static std::map<std::string, CompiledStage> CompiledStages;
+        /// \n The depth of nested shader batches.
+        static int ShaderBatchDepth;
+        /// \n The start of the outermost shader batch.
+        static std::chrono::steady_clock::time_point ShaderBatchStart;
+        static ShaderLoadStats ShaderStats;
+
         /// \n Compiles a file path to a std::string.
         static std::string ReadText(const fs::path& path);
         /// \n Imports data from a given data node in an assimp scene.
@@ -102,9 +183,12 @@ namespace EisEngine {
         /// @param game - Game&: A reference to the Engine system.
         /// @param node - aiNode*: A pointer to the current node from which the data should be imported.
         /// @param scene - aiScene*: A pointer to the overall scene graph the node is from.
+        /// @param primitives - std::vector&lt;std::unique_ptr&lt;PrimitiveMesh3D>>: The converted meshes of the scene,
+        /// indexed like the scene's meshes. Null for meshes that could not be converted.
         /// @param parent - Entity*: A pointer to the parent object to this node.
-        static void ImportNode(Game& game, const aiNode* node,
-                               const aiScene* scene, const fs::path& modelPath, Entity* parent = nullptr);
+        static void ImportNode(Game& game, const aiNode* node, const aiScene* scene,
+                               const std::vector<std::unique_ptr<rendering::PrimitiveMesh3D>>& primitives,
+                               const fs::path& modelPath, Entity* parent = nullptr);
 
         #pragma region Textures
         /// \n loads a texture from a file.
@@ -132,8 +216,16 @@ namespace EisEngine {
         #pragma endregion
 
         #pragma region Shaders
-        /// \n Creates a shader program of the given shaderType with a definition at the given shader path.
-        static unsigned int loadAndCompileShader(GLuint shaderType, const fs::path& filePath);
+        /// \n Creates a shader program from the given source, loaded from the program binary cache if possible.
+        /// Compiled programs finish linking at the end of the current batch.
+        static std::unique_ptr<Shader> CreateProgram(const std::string& name, const ShaderSource& source);
+        /// \n Submits a shader stage of the given shaderType for compilation, reusing the stage within a batch.
+        /// @param source - std::string: the final source, defines included.
+        static unsigned int loadAndCompileShader(GLuint shaderType, const fs::path& filePath,
+                                                 const std::string& source);
+        /// \n Checks whether a stage compiled. Waits for its compilation to finish.
+        /// @return std::string: the compile error, empty if the stage compiled.
+        static std::string CheckCompileStatus(const CompiledStage& stage);
         #pragma endregion
     };
 }
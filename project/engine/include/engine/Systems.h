@@ -2,6 +2,7 @@
 
 #include "engine/systems/SceneGraphPruner.h"
 #include "engine/systems/SceneGraphUpdater.h"
+#include "engine/systems/SceneIndex.h"
 
 #include "engine/systems/RenderingSystem.h"
 
@@ -15,6 +16,7 @@
 
 using SceneGraphPruner = EisEngine::systems::SceneGraphPruner;
 using SceneGraphUpdater = EisEngine::systems::SceneGraphUpdater;
+using SceneIndex = EisEngine::systems::SceneIndex;
 
 using RenderingSystem = EisEngine::systems::RenderingSystem;
 
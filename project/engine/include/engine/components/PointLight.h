@@ -25,6 +25,8 @@ namespace EisEngine{
             Vector3 GetEmission() const { return mat->GetEmission();}
             float GetIntensity() const {return mat->GetIntensity();}
             Vector3 position() const;
+            /// \n The distance at which the light's inverse-square falloff drops below a visible contribution.
+            [[nodiscard]] float GetRange() const;
 
             void SetEmission(const Vector3& v) { mat->SetEmission(v);}
             void SetIntensity(const float& I) { mat->SetIntensity(I);}
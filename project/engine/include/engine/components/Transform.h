@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <set>
 #include <glm/glm.hpp>
 #include "engine/ecs/Component.h"
@@ -53,6 +54,10 @@ namespace EisEngine{
             /// \n Returns the object's scale relative to its parent object.
             [[nodiscard]] Vector3 GetLocalScale(){ return localScale;}
             [[nodiscard]] bool IsDirty() const { return dirty;}
+            /// \n Returns a stamp that changes whenever the model matrix of this transform or any of its parents
+            /// is recalculated. Stamps are drawn from a global counter & never repeat, so that an unchanged stamp
+            /// reliably means an unmoved object.
+            [[nodiscard]] uint64_t GetVersion() const { return version;}
 
             /// \n Returns the transform's model matrix, condensing full transform data in one object.
             [[nodiscard]] glm::mat4 GetModelMatrix();
@@ -131,6 +136,11 @@ namespace EisEngine{
             std::set<Transform *> children;
             /// \n flags whether the object was changed directly in the world.
             bool dirty = true;
+            /// \n Stamped each time the model matrix is recalculated or the parent changes. Parents mark their
+            /// children dirty, so a moved parent restamps its whole subtree.
+            uint64_t version = 0;
+            /// \n The last stamp handed out to any transform.
+            static uint64_t versionCounter;
 
             /// \n Syncs global position to the physics body's.
             void SyncPosition(const Vector3& newPosition);
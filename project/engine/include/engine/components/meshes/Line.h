@@ -4,6 +4,7 @@
 #include "glm/glm.hpp"
 #include "OpenGL/OpenGlInclude.h"
 #include "engine/ecs/Component.h"
+#include "engine/utilities/rendering/StreamingRingBuffer.h"
 
 namespace EisEngine::components{
     using Component = ecs::Component;
@@ -17,9 +18,6 @@ namespace EisEngine::components{
         /// @param end - Vector3: the end point of the line in world space.
         Line(Game &engine, guid_t owner, const Vector3& start, const Vector3& end);
 
-        /// \n A function called when the component is intentionally deleted.
-        void Invalidate() override;
-
         /// \n returns a Vector3 representing this line's start point in world space.
         [[nodiscard]] const Vector3& GetStartPoint() const { return startPoint; }
         /// \n returns a vector3 representing this line's end point in world space.
@@ -35,17 +33,16 @@ namespace EisEngine::components{
         void SetPoints(const Vector3& start, const Vector3& end);
 
         /// \n draws the line onto the screen once per frame.
-        void draw(const unsigned int& shaderProgram) const;
+        /// @param stream - StreamingRingBuffer&: the buffer the end points are written to for this frame.
+        void draw(rendering::StreamingRingBuffer& stream) const;
     private:
-        /// \n Updates the GL buffer data to current points values
+        /// \n Updates the end point coordinates to current points values.
         void UpdateBufferData();
 
         /// \n the point in world space at which the line starts.
         Vector3 startPoint;
         /// \n the point in world space at which the line ends.
         Vector3 endPoint;
-        /// \n Vertex Buffer Object used for rendering.
-        unsigned int VBO;
         /// \n OpenGL vector of 3D-coordinates used for the line end points.
         std::vector<glm::vec3> lineCoordinates;
     };
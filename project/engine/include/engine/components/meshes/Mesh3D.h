@@ -2,11 +2,24 @@
 
 #include "engine/ecs/Component.h"
 #include "engine/utilities/rendering/PrimitiveMesh3D.h"
+#include "engine/utilities/rendering/StaticGeometry.h"
 
 namespace EisEngine {
     using namespace ecs;
     namespace components {
+        /// \n A level of detail of a mesh, as a slice of the mesh's indices.
+        struct LODRange {
+            /// \n The first index of the level relative to the mesh's first index.
+            int offset = 0;
+            /// \n The amount of indices of the level.
+            int count = 0;
+            /// \n The level's deviation from the full mesh in model units (see MeshLOD::error).
+            float error = 0.0f;
+        };
+
         /// \n This component represents an entity's shape in the 3D world.\n
+        /// The geometry is stored in the static geometry arenas (see StaticGeometry); meshes built from identical
+        /// primitives share it.
         class Mesh3D : public Component {
         public:
             explicit Mesh3D(Game& engine, guid_t owner, const PrimitiveMesh3D& _primitive);
@@ -18,13 +31,38 @@ namespace EisEngine {
 
             /// \n Draws the mesh onto the screen once per frame.
             void draw(const unsigned int& shaderProgram);
+            /// \n Binds the mesh's vertex attributes to the given shader program without drawing.
+            void BindGeometry(const unsigned int& shaderProgram);
+            /// \n Draws several instances of the mesh in a single call.\n
+            /// Vertex and instance attributes must already be bound (see BindGeometry).
+            void drawInstanced(const int& instanceCount) const;
+            /// \n Returns an identifier shared by all meshes using the same geometry.
+            [[nodiscard]] unsigned int GetGeometryID() const { return geometry.vertices;}
+            /// \n The index of the mesh's first vertex within the static vertex arena.
+            [[nodiscard]] int GetBaseVertex() const { return rendering::StaticGeometry::GetBaseVertex(geometry);}
+            /// \n The position of the first index of the current detail level within the static index arena.
+            [[nodiscard]] unsigned int GetFirstIndex() const;
+            /// \n GL_UNSIGNED_SHORT if the mesh is small enough for 16-bit indices, else GL_UNSIGNED_INT.
+            [[nodiscard]] GLenum GetIndexType() const { return geometry.indexType;}
+            /// \n The amount of detail levels, including the full mesh (level 0).
+            [[nodiscard]] int GetLODCount() const { return (int) lodRanges.size();}
+            /// \n Returns the given detail level.
+            [[nodiscard]] const LODRange& GetLOD(const int& level) const { return lodRanges[level];}
+            /// \n The detail level used by draw calls.
+            [[nodiscard]] int GetLODLevel() const { return lodLevel;}
+            /// \n Sets the detail level used by draw calls, clamped to the available levels.
+            void SetLODLevel(const int& level);
             /// \n primitive mesh definition, stores vertex and edge data.
             const PrimitiveMesh3D primitive;
         private:
-            /// \n Vertex Buffer Object -> contains vertex attribute and index data.
-            unsigned int VBO = 0;
-            /// \n Element Buffer Object -> stores index data to avoid reusing coordinates in triangles.
-            unsigned int EBO = 0;
+            /// \n The vertices & indices (of all detail levels) within the static geometry arenas.
+            rendering::StaticGeometryRange geometry;
+            /// \n Content hash of the primitive, used to share buffers between identical meshes.
+            size_t geometryHash = 0;
+            /// \n The detail levels stored back to back in the mesh's indices, from finest to coarsest.
+            std::vector<LODRange> lodRanges = {};
+            /// \n The detail level used by draw calls.
+            int lodLevel = 0;
         };
 
     }
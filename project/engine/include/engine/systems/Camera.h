@@ -3,6 +3,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include "engine/ecs/System.h"
 #include "engine/ecs/Entity.h"
+#include "engine/utilities/rendering/BoundingVolume.h"
 
 namespace EisEngine::systems {
     using Transform = EisEngine::components::Transform;
@@ -26,6 +27,9 @@ namespace EisEngine::systems {
         /// \n View matrix being the camera's position in world space.
         /// @return projection x view, a 4x4 matrix representing the camera's FOV from its position
         glm::mat4 GetVPMatrix();
+        /// \n Creates a world space ray through the given screen position, e.g. for picking objects.
+        /// @param screenPos - Vector2: the position in pixels, measured from the window's top left corner.
+        rendering::Ray ScreenPointToRay(const Vector2& screenPos);
 
         /// \n Zooms into the scene, restraining the FOV.
         /// @param value: the zoom factor applied to the camera.\n
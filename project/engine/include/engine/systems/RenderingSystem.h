@@ -4,29 +4,74 @@
 #include "engine/ecs/System.h"
 #include "Camera.h"
 #include "engine/utilities/rendering/Shader.h"
+#include "engine/utilities/rendering/Frustum.h"
+#include "engine/utilities/rendering/LightClusters.h"
+#include "engine/utilities/rendering/LightGrid.h"
+#include "engine/utilities/rendering/OcclusionCuller.h"
+#include "engine/utilities/rendering/RenderBackend.h"
+#include "engine/utilities/rendering/StreamingRingBuffer.h"
+#include "engine/utilities/rendering/GLStateCache.h"
+#include "engine/utilities/rendering/QualityGovernor.h"
+#include "engine/utilities/rendering/RenderGraph.h"
+#include "engine/utilities/rendering/SpriteBatcher.h"
+#include "engine/systems/SceneIndex.h"
+#include "engine/utilities/RadixSort.h"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
+#include <utility>
 
 namespace EisEngine{
     namespace components{
         class Mesh3D;
-    }
-    namespace events{
-        template<typename Owner, typename ...Args>
-        class Event;
+        class PointLight;
+        class Renderer;
     }
     namespace systems {
-        struct GridCoordHashMap{
-            size_t operator()(const Vector2& c) const {
-                // good 2D hash — no collisions for small/medium worlds
-                return (std::hash<int>()(c.x) * 73856093) ^
-                       (std::hash<int>()(c.y) * 19349663);
-            }
+        /// \n Frustum culling counters of the last drawn frame.
+        struct CullingStats {
+            /// \n The amount of meshes tested against the view frustum.
+            int tested = 0;
+            /// \n The amount of meshes skipped because they were outside the view frustum.
+            int culled = 0;
+            /// \n The amount of 3D meshes inside the view frustum skipped because they were hidden behind occluders.
+            int occluded = 0;
+        };
+
+        /// \n Depth pre-pass counters, read back from the GPU a few frames late to avoid stalls.
+        struct PrePassStats {
+            /// \n The GPU time of the depth-only pass in milliseconds.
+            double prePassTime = 0.0;
+            /// \n The GPU time of the lit opaque pass in milliseconds.
+            double shadingTime = 0.0;
+            /// \n The samples passing the depth test in the pre-pass, estimating the fragments that would be
+            /// shaded without it.
+            uint64_t prePassSamples = 0;
+            /// \n The samples shaded by the lit pass.
+            uint64_t shadedSamples = 0;
+
+            /// \n The fragments spared from shading by the pre-pass.
+            [[nodiscard]] uint64_t SavedSamples() const
+            { return prePassSamples > shadedSamples ? prePassSamples - shadedSamples : 0;}
+        };
+
+        /// \n The technique used to draw translucent meshes.
+        enum class TransparencyMode {
+            /// \n Meshes are sorted back to front & drawn once their thickness was measured in two depth passes
+            /// at a reduced resolution.
+            Sorted,
+            /// \n Weighted blended order-independent transparency: a single unsorted pass into accumulation
+            /// targets composited onto the screen. The thickness of a mesh is estimated from its bounds.
+            WeightedBlended
         };
 
         using namespace rendering;
         /// \n The system drawing objects onto the display.
         class RenderingSystem : public System {
             using Mesh3D = EisEngine::components::Mesh3D;
-            using Event = EisEngine::events::Event<RenderingSystem, const Vector2&>;
+            using PointLight = EisEngine::components::PointLight;
+            using Renderer = EisEngine::components::Renderer;
         public:
             /// \n creates an instance of the EisEngine rendering system.
             explicit RenderingSystem(Game& engine);
@@ -34,6 +79,9 @@ namespace EisEngine{
             void Draw();
             /// \n Adds an entity as an LOD loader object.
             static void MarkAsLoader(Entity* ptr);
+            /// \n Adds an entity whose 3D mesh hides the meshes behind it from occlusion culling. Occluders should be
+            /// large & simple, e.g. walls or terrain; their full detail mesh is rasterized.
+            static void MarkAsOccluder(Entity* ptr);
             /// \n Sets the entity to be displayed as the skybox in the scene.
             static void SetSkyboxEntity(Entity* ptr);
             /// \n changes the specular factor in the scene for the Blinn-Phong Shader.
@@ -46,38 +94,307 @@ namespace EisEngine{
             static void SetEta(const Vector3& val) {
                 eta = val;
             }
+            /// \n Enables or disables automatic instancing of opaque meshes sharing geometry and material.
+            static void SetInstancing(const bool& val) { instancingEnabled = val;}
+            /// \n Enables or disables merging the instanced draws of opaque meshes sharing a shader variant, material and
+            /// lights - but not their geometry - into a single glMultiDrawElementsIndirect call. Requires instancing.
+            static void SetMultiDrawIndirect(const bool& val) { multiDrawEnabled = val;}
+            /// \n Enables or disables skipping meshes outside the camera's view frustum.
+            static void SetFrustumCulling(const bool& val) { frustumCullingEnabled = val;}
+            /// \n Enables or disables skipping 3D meshes hidden behind the occluders (see MarkAsOccluder), tested on the
+            /// CPU against a low resolution depth buffer after frustum culling.
+            static void SetOcclusionCulling(const bool& val) { occlusionCullingEnabled = val;}
+            /// \n Returns the frustum & occlusion culling counters of the last drawn frame.
+            static const CullingStats& GetCullingStats() { return cullingStats;}
+            /// \n Enables or disables clustered lighting. If disabled, each mesh is lit by its closest lights only.
+            static void SetClusteredLighting(const bool& val) { clusteredLightingEnabled = val;}
+            /// \n Sets the largest on-screen deviation (in pixels) accepted when switching meshes to a coarser
+            /// level of detail. 0 always draws the full meshes.
+            static void SetLODErrorThreshold(const float& pixels) { lodErrorThreshold = pixels;}
+            /// \n Replaces the backend executing the recorded 3D draws, e.g. with a RecordingRenderBackend to
+            /// benchmark the CPU side of rendering. Without a graphics context only the opaque 3D meshes
+            /// are prepared and submitted; all other passes are skipped.
+            void SetRenderBackend(std::unique_ptr<RenderBackend> newBackend) { backend = std::move(newBackend);}
+            /// \n Enables or disables filling the depth buffer in a position-only pass over the opaque meshes (sorted
+            /// front to back) before shading them, so that every pixel is shaded once. Worthwhile with expensive
+            /// shaders & heavy overdraw.
+            static void SetDepthPrePass(const bool& val) { depthPrePassEnabled = val;}
+            /// \n Returns the depth pre-pass counters of the latest frame whose results are available.
+            static const PrePassStats& GetPrePassStats() { return prePassStats;}
+            /// \n Selects the technique used to draw translucent meshes.
+            static void SetTransparencyMode(const TransparencyMode& mode) { transparencyMode = mode;}
+            /// \n Sets the resolution of the thickness passes of sorted transparency relative to the scene's,
+            /// clamped to [0.05, 1].
+            static void SetThicknessResolutionScale(const float& scale);
+            /// \n Sets the resolution of the scene relative to the window's, clamped to [0.25, 1]. Below 1, the scene
+            /// is drawn into an offscreen target and upscaled onto the window; UI sprites stay at full resolution.
+            static void SetRenderScale(const float& scale);
+            /// \n Limits the amount of lights assigned to a light cluster, keeping the most intense ones.
+            /// 0 assigns all lights.
+            static void SetMaxLightsPerCluster(const uint32_t& count) { maxLightsPerCluster = count;}
+            /// \n Returns the governor trading quality for speed to keep the frame time within a budget.
+            /// Disabled by default.
+            static QualityGovernor& GetQualityGovernor() { return qualityGovernor;}
+            /// \n Draws the quality governor's controls & decisions into the current ImGui window.
+            static void DrawQualityGovernorUI() { qualityGovernor.DrawImGui(GetBaseQuality());}
+            /// \n Returns the quality settings in effect for the last drawn frame.
+            [[nodiscard]] const QualitySettings& GetQualitySettings() const { return quality;}
+            /// \n Returns the backend executing the recorded 3D draws.
+            [[nodiscard]] RenderBackend& GetRenderBackend() const { return *backend;}
+            /// \n Returns the ring buffer for data rewritten every frame, e.g. to create a GLRenderBackend.
+            /// nullptr without a graphics context.
+            [[nodiscard]] StreamingRingBuffer* GetStreamingBuffer() const { return streamingBuffer.get();}
+            /// \n Returns the streaming ring buffer's counters of the last drawn frame.
+            static const StreamingStats& GetStreamingStats() { return streamingStats;}
+            /// \n Returns the amount of state changes issued & filtered as redundant in the last drawn frame.
+            static const StateCacheStats& GetStateCacheStats() { return GLStateCache::GetFrameStats();}
+            /// \n Returns the render graph's pass & memory counters of the last drawn frame.
+            static const RenderGraphStats& GetRenderGraphStats() { return renderGraphStats;}
         private:
+            /// \n The quality settings chosen by the user, before the governor's adjustments.
+            static QualitySettings GetBaseQuality();
+            /// \n Feeds the governor the last frame's times & applies the resulting quality settings.
+            void UpdateQuality();
+            /// \n Reads the GPU frame timer of an earlier frame.
+            /// @return double: the frame's GPU time in milliseconds, or -1 if not available (yet).
+            double ReadFrameTimer(size_t frame);
+            /// \n The 3D shader of the frame: the active one, unless the quality settings demand simpler shading.
+            [[nodiscard]] const std::string& GetShadingModel() const;
+            /// \n The size of the scene's render target: the window's, scaled by the render scale.
+            [[nodiscard]] Vector2 GetRenderTargetSize() const;
+            /// \n (Re)allocates the offscreen scene target at the given size.
+            void InitSceneTarget(const Vector2& size);
+            /// \n Binds & clears the offscreen scene target if the scene is drawn at a reduced resolution.
+            void BeginSceneTarget();
+            /// \n Upscales the offscreen scene target onto the window & restores the window's viewport.
+            void ResolveSceneTarget();
+            /// \n Queries the scene index for the renderables inside the view frustum.
+            void CollectVisibleObjects();
+            /// \n Rasterizes the occluders & removes the 3D meshes hidden behind them from the visible objects.
+            void CullOccludedObjects();
+            /// \n Queries the scene index for the meshes within range of a loader.
+            void CollectLitObjects();
+            /// \n Assigns the lights inside the view frustum to clusters and uploads them to the GPU.
+            void BuildLightClusters();
+            /// \n Sets the uniforms required to look up the light clusters in the given shader.
+            void ApplyClusterData(Shader* activeShader) const;
+            /// \n Fetches a 3D shader and sets its per-frame uniforms.
+            /// @param keywords - uint32_t: the ShaderKeywords selecting the shader's variant.
+            /// @return Shader*: the shader, or nullptr without a graphics context.
+            Shader* Prepare3DShader(const std::string& shaderName, uint32_t keywords = KEYWORDS_NONE) const;
+            /// \n Selects the minimal shader variant (ShaderKeywords) for a mesh's material.
+            /// @param lit - bool: whether the mesh is within range of a loader.
+            uint32_t GetShaderKeywords(Renderer* renderer, bool lit) const;
+            /// \n Gathers the per-frame state handed to the render backend.
+            [[nodiscard]] FrameParameters GetFrameParameters() const;
+            /// \n Sorts the visible 3D meshes into opaque and transparent ones, selecting their detail levels.
+            void CollectMeshes(std::vector<Mesh3D*>& opaqueMeshes, std::vector<Mesh3D*>& transparentMeshes);
+            /// \n Picks the coarsest detail level of a mesh whose projected error stays below the threshold.
+            void SelectLOD(Mesh3D& mesh, const SceneObject& object) const;
+            /// \n Orders opaque meshes from the nearest to the farthest (see CollectMeshes).
+            void SortFrontToBack(std::vector<Mesh3D*>& opaqueMeshes);
             /// \n Draws a 3D Mesh
             void PrepareDraw(Mesh3D& mesh, Shader* activeShader);
-            /// \n Initializes the framebuffer object for depth mapping.
-            void InitFBO(const int& index, const Vector2& screenDims);
-            /// \n Resizes buffers on window size shift.
-            void ResizeFBOItems(const Vector2& newScreenDims);
-            /// \n Drawing program for all translucent objects.
-            void DrawTransparentObjects(std::vector<Mesh3D*>& transparentMeshes, Shader* activeShader);
+            /// \n A recorded command list & the shader variant drawing it.
+            struct OpaqueSubmission {
+                const RenderCommandList* list;
+                Shader* shader;
+            };
+            /// \n A range of meshes recorded into a single command list, all drawn with the same shader variant.
+            struct RecordChunk {
+                size_t begin;
+                size_t end;
+                uint32_t keywords;
+            };
+            /// \n Submits recorded opaque draws, preceded by a depth-only pass if a depth shader is given.
+            void SubmitOpaque(const std::vector<OpaqueSubmission>& submissions, Shader* depthShader);
+            /// \n Reads the pre-pass queries of an earlier frame into the stats if their results are available.
+            void CollectPrePassQueries(size_t frame);
+            /// \n Records the draws of the given meshes into command lists on worker threads, then submits them.
+            /// @param shaderName - std::string: the shader whose variants draw the meshes.
+            void DrawRecorded(std::vector<Mesh3D*>& meshes, const std::string& shaderName, Shader* depthShader = nullptr);
+            /// \n Records the uniforms and draw call of a single mesh.
+            void RecordMesh(Mesh3D& mesh, const glm::mat4& vp, RenderCommandList& list) const;
+            /// \n Draws opaque meshes, collapsing meshes with identical geometry, material and lights into
+            /// a single instanced draw call - or, with multi-draws, meshes with identical material and lights
+            /// into a single multi-draw.
+            void DrawInstanced(std::vector<Mesh3D*>& opaqueMeshes, const std::string& shaderName,
+                               Shader* depthShader = nullptr);
+            /// \n Selects the lights affecting a mesh.
+            /// @return int: the amount of lights written to the output array, or -1 if the object is out of LOD range.
+            int CollectLights(const Mesh3D& mesh, const Vector3& pos, PointLight** out) const;
+            /// \n The size of the depth mapping targets for the given scene size.
+            [[nodiscard]] Vector2 GetThicknessTargetSize(const Vector2& screenDims) const;
+            /// \n Draws all debug shapes of the frame (see Debug::DrawLine) in a single draw call.
+            void DrawDebugLines();
+            /// \n Streams the sprite batcher's vertices & draws one call per batch.
+            /// @param vp - glm::mat4: the view projection matrix of the sprites' space.
+            void DrawSpriteBatches(Shader& activeShader, const glm::mat4& vp);
+            /// \n Adds the passes drawing all translucent objects to the render graph.
+            void DrawTransparentObjects(std::vector<Mesh3D*>& transparentMeshes);
+            /// \n Orders translucent meshes from the farthest to the nearest by the view depth of their bounds.
+            void SortTransparentMeshes(std::vector<Mesh3D*>& transparentMeshes, const glm::mat4& view);
+            /// \n Adds the passes of sorted transparency: two thickness passes, then the meshes drawn over the scene.
+            void AddSortedPasses(std::vector<Mesh3D*>& transparentMeshes, RenderResource scene);
+            /// \n Renders the view depth of the faces not culled of the translucent meshes into the bound target.
+            /// @param culledFace - GLenum: GL_FRONT to render the back faces, GL_BACK to render the front faces.
+            void DrawThicknessPass(const std::vector<Mesh3D*>& transparentMeshes, const glm::mat4& view,
+                                   GLenum culledFace);
+            /// \n Draws translucent meshes back to front, refracting through the thickness measured by the
+            /// thickness passes.
+            void DrawSorted(const std::vector<Mesh3D*>& transparentMeshes, GLuint backFaceDepth, GLuint frontFaceDepth);
+            /// \n Adds the passes of weighted blended order-independent transparency: the meshes accumulated in a
+            /// single pass, then composited over the scene.
+            void AddWeightedBlendedPasses(const std::vector<Mesh3D*>& transparentMeshes, RenderResource scene);
+            /// \n Accumulates translucent meshes into the bound targets, testing against the opaque scene's depth.
+            void DrawWeightedBlended(const std::vector<Mesh3D*>& transparentMeshes, GLuint opaqueFramebuffer,
+                                     int width, int height);
+            /// \n Composites the accumulated translucent meshes over the bound framebuffer.
+            void CompositeWeightedBlended(GLuint accumulation, GLuint revealage);
+            /// \n Fetches a shader for translucent meshes and sets its per-frame uniforms & the skybox' cubemap.
+            Shader* PrepareTransparencyShader(const std::string& shaderName) const;
 
             /// \n A pointer to the active camera object.
             Camera* camera = nullptr;
-            /// \n VAO array storing a VAO for each type of mesh in order: Mesh2D, Line, Mesh3D, SpriteMesh, uiMesh.
+            /// \n VAO array storing a VAO for each type of mesh in order: Mesh2D, Line, Mesh3D, batched sprites,
+            /// and an empty one for fullscreen passes.
             std::array<GLuint, 5> VAO;
-            /// \n FBO array storing a depth-mapping FBO.
-            std::array<GLuint, 2> FBO;
-            /// \n FBO array storing a depth-mapping RBO.
-            std::array<GLuint, 2> RBO;
-            /// \n Texture index storing depth data.
-            std::array<GLuint, 2> depthTex;
-            /// \n An event called every time the window resizes.
-            static Event onResize;
+            /// \n Runs the passes with intermediate targets (transparency) & allocates the targets from a pool.
+            RenderGraph renderGraph;
+            /// \n The offscreen target of scenes drawn at a reduced resolution, allocated on first use.
+            GLuint sceneFBO = 0;
+            /// \n The color and depth-stencil buffers of the scene target, in that order.
+            std::array<GLuint, 2> sceneRBO = {};
+            /// \n The current size of the scene target.
+            Vector2 sceneTargetSize = Vector2(0.0f, 0.0f);
+            /// \n The framebuffer the scene is drawn into in the current frame: the scene target or the window's.
+            GLuint sceneFramebuffer = 0;
+            /// \n The window's viewport, restored once the scene target is resolved.
+            std::array<GLint, 4> windowViewport = {};
+            /// \n The quality settings of the current frame.
+            QualitySettings quality;
+            /// \n GPU timestamps at the start & the end of a frame's drawing.
+            struct FrameTimerQueries {
+                std::array<GLuint, 2> ids = {};
+                /// \n Whether the queries were issued & not read yet.
+                bool issued = false;
+            };
+            /// \n The frame timers of the last few frames, used round robin.
+            std::vector<FrameTimerQueries> frameTimerQueries = {};
+            /// \n The index of the frame timer of the current frame.
+            size_t frameTimerFrame = 0;
+            /// \n The squared distances of the opaque meshes' bounds to the camera, in collection order.
+            std::vector<float> opaqueDistances = {};
+            /// \n Sort keys of opaque or translucent meshes & scratch memory for sorting them, reused across frames.
+            std::vector<SortEntry> drawOrder = {};
+            std::vector<SortEntry> drawOrderScratch = {};
+            /// \n Meshes in drawing order, reused across frames.
+            std::vector<Mesh3D*> sortedMeshes = {};
+            /// \n The index ranges of the instanced batches in drawing order, reused across frames.
+            std::vector<std::pair<size_t, size_t>> batchRanges = {};
+            /// \n The batched meshes in draw order, read by the multi-draws, reused across frames.
+            std::vector<Mesh3D*> multiDrawMeshes = {};
+            /// \n GPU timer & sample counter queries of the depth pre-pass and the lit pass, in that order.
+            struct PrePassQueries {
+                std::array<GLuint, 4> ids = {};
+                /// \n Whether the queries were issued & not read yet.
+                bool issued = false;
+            };
+            /// \n The pre-pass queries of the last few frames, used round robin.
+            std::vector<PrePassQueries> prePassQueries = {};
+            /// \n The index of the pre-pass queries of the current frame.
+            size_t prePassQueryFrame = 0;
+            /// \n The ring buffer for lines & instance data, declared before the backend writing to it.
+            std::unique_ptr<StreamingRingBuffer> streamingBuffer;
+            /// \n The backend executing the recorded 3D draws.
+            std::unique_ptr<RenderBackend> backend;
+            /// \n CPU-side staging of per-instance data, reused across frames.
+            std::vector<InstanceData> instanceData = {};
+            /// \n Command lists recorded in parallel, one per chunk of meshes, reused across frames.
+            std::vector<RenderCommandList> commandLists = {};
+            /// \n Sorts & transforms the world and UI sprites into batches, reused across frames.
+            SpriteBatcher spriteBatcher;
+            /// \n The command lists of the instanced draws, one per shader variant.
+            std::vector<RenderCommandList> instancedCommands = {};
+            /// \n The opaque command lists of the frame & their shaders, reused across frames.
+            std::vector<OpaqueSubmission> opaqueSubmissions = {};
+            /// \n The ShaderKeywords of the meshes drawn without instancing, reused across frames.
+            std::vector<uint32_t> meshKeywords = {};
+            /// \n The meshes drawn without instancing grouped by shader variant, reused across frames.
+            std::vector<Mesh3D*> variantMeshes = {};
+            /// \n The chunks of meshes recorded into the command lists, reused across frames.
+            std::vector<RecordChunk> recordChunks = {};
+            /// \n The placeholder normal map of renderers without one, which needs no normal mapping.
+            Texture2D* defaultNormalMap = nullptr;
+            /// \n The camera's view frustum, updated once per frame.
+            Frustum frustum;
+            /// \n The renderables to draw in the current frame, ordered by type and owner.
+            std::vector<SceneObject*> visibleObjects = {};
+            /// \n Scratch buffer for scene index queries.
+            std::vector<SceneObject*> queryResults = {};
+            /// \n Tests the visible 3D meshes against the occluders' depth.
+            OcclusionCuller occlusionCuller;
+            /// \n The bounds of the visible 3D meshes & their occlusion test results, reused across frames.
+            std::vector<AABB> occlusionBoxes = {};
+            std::vector<unsigned char> occlusionVisibility = {};
+            /// \n Meshes within range of a loader in the current frame.
+            std::unordered_set<const Component*> litObjects = {};
+            /// \n The view space grid assigning lights to clusters.
+            LightClusters lightClusters;
+            /// \n Shader storage buffers holding the lights, the light indices and the cluster ranges, in that order.
+            std::array<GLuint, 3> clusterSSBO = {};
+            /// \n CPU-side staging of the lights inside the view frustum, reused across frames.
+            std::vector<ClusterLight> clusterLightData = {};
+            /// \n Scratch buffer for scene index light queries.
+            std::vector<PointLight*> lightQueryResults = {};
+            /// \n The on-screen size in pixels of one world unit at distance 1 (perspective) or anywhere (orthographic).
+            float lodPixelsPerUnit = 1.0f;
+            /// \n Whether the camera's projection is orthographic, making the projected error independent of distance.
+            bool lodOrthographic = false;
+            /// \n The camera's position in world space for the current frame.
+            glm::vec3 lodViewPosition = glm::vec3(0.0f);
+            /// \n Determines whether opaque meshes are drawn using instancing.
+            static bool instancingEnabled;
+            /// \n Determines whether instanced draws of different geometry are merged into multi-draws.
+            static bool multiDrawEnabled;
+            /// \n Determines whether meshes outside the view frustum are skipped.
+            static bool frustumCullingEnabled;
+            /// \n Determines whether 3D meshes hidden behind occluders are skipped.
+            static bool occlusionCullingEnabled;
+            /// \n Determines whether lights are looked up per fragment from the light clusters.
+            static bool clusteredLightingEnabled;
+            /// \n The largest on-screen deviation in pixels accepted for coarser detail levels.
+            static float lodErrorThreshold;
+            /// \n Frustum culling counters of the last drawn frame.
+            static CullingStats cullingStats;
+            /// \n Streaming ring buffer counters of the last drawn frame.
+            static StreamingStats streamingStats;
+            /// \n Render graph counters of the last drawn frame.
+            static RenderGraphStats renderGraphStats;
+            /// \n Determines whether opaque meshes are drawn after a depth-only pre-pass.
+            static bool depthPrePassEnabled;
+            /// \n Depth pre-pass counters of the latest frame whose results are available.
+            static PrePassStats prePassStats;
+            /// \n The technique used to draw translucent meshes.
+            static TransparencyMode transparencyMode;
+            /// \n The resolution of the thickness passes relative to the scene's.
+            static float thicknessResolutionScale;
+            /// \n The resolution of the scene relative to the window's.
+            static float renderScale;
+            /// \n The most lights assigned to a light cluster, 0 if unlimited.
+            static uint32_t maxLightsPerCluster;
+            /// \n Adapts the quality settings to the frame time budget.
+            static QualityGovernor qualityGovernor;
             /// \n A list of entities enabling other entities in a certain radius of them to be lit.
             static std::vector<Entity*> Loaders;
+            /// \n A list of entities whose meshes hide the meshes behind them.
+            static std::vector<Entity*> Occluders;
             /// \n A pointer to the entity marked as a skybox.
             static shared_ptr<Entity> skybox;
             /// \n A reference of Point Lights by approximate position in world 2D (x, z) space.
-            std::unordered_map<Vector2, std::vector<int>, GridCoordHashMap> LightGrid = {};
-            /// \n Collects all Point Lights in the scene and compiles them to a usable grid.
-            void BuildLightGrid();
-            /// \n Checks the surroundings of an object for effecting light sources.
-            std::vector<int> QueryNearbyLights(const glm::vec3& objectPos);
+            LightGrid lightGrid;
+            /// \n Re-bins the Point Lights that moved since the last frame.
+            void UpdateLightGrid();
             /// \n [Blinn-Phong] The specular factor determining how sharp the specular lobe is.\n
             /// The higher this value, the slimmer the lobe.
             static float specularFactor;
@@ -89,6 +406,10 @@ namespace EisEngine{
             static std::string active3DShader;
             /// \n A dictionary linking shader names to the name of their corresponding shader object in the ResourceManager.
             static const std::unordered_map<std::string, std::string> shaderNameDict;
+            /// \n A dictionary linking shader names to their instanced variant in the ResourceManager.
+            static const std::unordered_map<std::string, std::string> instancedShaderNameDict;
+            /// \n A dictionary linking shader names to their multi-draw variant in the ResourceManager.
+            static const std::unordered_map<std::string, std::string> multiDrawShaderNameDict;
             /// \n the amount of brightness levels available to the toon shader.
             static int n_toon_levels;
             static Vector3 eta;
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "engine/ecs/System.h"
+#include "engine/ecs/Component.h"
+#include "engine/utilities/rendering/DynamicAABBTree.h"
+
+namespace EisEngine {
+    namespace components {
+        class Transform;
+        class PointLight;
+    }
+
+    namespace systems {
+        using ecs::System;
+        using ecs::Component;
+        using rendering::AABB;
+        using rendering::BoundingSphere;
+        using rendering::BoundingVolume;
+        using rendering::DynamicAABBTree;
+        using rendering::Frustum;
+        using rendering::Ray;
+
+        /// \n The kinds of components tracked by the scene index.
+        enum class SceneObjectType {
+            Mesh2D,
+            Mesh3D,
+            Sprite,
+            Light
+        };
+
+        /// \n An entry of the scene index, linking a component to its world space bounds.
+        struct SceneObject {
+            /// \n The tracked component; cast according to type.
+            Component* component = nullptr;
+            /// \n The kind of the tracked component.
+            SceneObjectType type = SceneObjectType::Mesh3D;
+            /// \n The transform of the component's entity.
+            components::Transform* transform = nullptr;
+            /// \n The world space bounds of the component.
+            BoundingVolume bounds;
+            /// \n The leaf of the object in its tree, or DynamicAABBTree::nullNode for screen-space sprites.
+            int proxy = DynamicAABBTree::nullNode;
+            /// \n The transform version the bounds were computed for.
+            uint64_t version = 0;
+            /// \n The owner of the component at the time of registration.
+            guid_t owner = ecs::invalidID;
+            /// \n The last update in which the component still existed.
+            unsigned int lastSeen = 0;
+        };
+
+        /// \n A spatial index over all renderable components and point lights in the scene.\n
+        /// Keeps one bounding volume hierarchy for meshes and sprites and one for lights,
+        /// refitting only the objects whose transform changed since the last frame.
+        class SceneIndex : public System {
+            using PointLight = components::PointLight;
+        public:
+            /// \n Creates an empty scene index.
+            explicit SceneIndex(Game& engine);
+
+            /// \n Synchronizes the index with the scene's components.\n
+            /// Called by the rendering system right before drawing, so components removed during the frame
+            /// never reach the renderer. Query results are valid until components are removed.
+            void Update();
+
+            /// \n Collects all renderables whose bounds are at least partially inside the frustum.
+            void QueryFrustum(const Frustum& frustum, std::vector<SceneObject*>& out) const;
+            /// \n Collects all renderables whose bounds overlap the given sphere.
+            void QuerySphere(const BoundingSphere& sphere, std::vector<SceneObject*>& out) const;
+            /// \n Collects all renderables whose bounds overlap the given box.
+            void QueryAABB(const AABB& box, std::vector<SceneObject*>& out) const;
+            /// \n Collects all point lights whose range overlaps the given sphere.
+            void QueryLights(const BoundingSphere& sphere, std::vector<PointLight*>& out) const;
+            /// \n Collects all point lights whose range is at least partially inside the frustum.
+            void QueryLights(const Frustum& frustum, std::vector<PointLight*>& out) const;
+            /// \n Finds the closest renderable whose bounding box is hit by the ray.
+            /// @param hitDistance - float*: optionally receives the distance along the ray to the hit.
+            /// @return SceneObject*: the hit object, or nullptr if nothing was hit.
+            SceneObject* Raycast(const Ray& ray, float maxDistance = std::numeric_limits<float>::max(),
+                                 float* hitDistance = nullptr) const;
+
+            /// \n Collects all renderables in the scene, visible or not.
+            void GetRenderables(std::vector<SceneObject*>& out) const;
+            /// \n Sprites on the UI layer, which are drawn in screen space and not part of the tree.
+            [[nodiscard]] const std::vector<SceneObject*>& GetScreenSpaceObjects() const { return screenSpaceObjects;}
+            /// \n The amount of renderables in the tree.
+            [[nodiscard]] int GetRenderableCount() const { return renderables.GetProxyCount();}
+            /// \n The amount of point lights in the tree.
+            [[nodiscard]] int GetLightCount() const { return lights.GetProxyCount();}
+        private:
+            /// \n Registers new components of type C and refits moved ones.
+            template<typename C>
+            void Track(SceneObjectType type);
+            /// \n Recomputes an object's world bounds and moves its proxy.
+            void Refit(SceneObject& object, const BoundingVolume& localBounds, bool screenSpace);
+            /// \n Removes objects whose component no longer exists.
+            void RemoveStale();
+
+            /// \n Tree over meshes and sprites.
+            DynamicAABBTree renderables;
+            /// \n Tree over point light ranges.
+            DynamicAABBTree lights;
+            /// \n All tracked objects by component address. Entries are heap allocated so tree user data stays valid.
+            std::unordered_map<Component*, std::unique_ptr<SceneObject>> objects;
+            /// \n UI sprites of the current frame.
+            std::vector<SceneObject*> screenSpaceObjects;
+            /// \n Counts updates; used to detect removed components.
+            unsigned int frame = 0;
+        };
+    }
+}
@@ -5,6 +5,7 @@
 
 namespace EisEngine {
     using ecs::System;
+    namespace ctx { class Context;}
 
     namespace systems{
         /// \n This System handles everything to do with time.
@@ -23,8 +24,8 @@ namespace EisEngine {
             /// \n the time elapsed in the current frame.
             float _deltaTime = 1.0f/60;
 
-            /// \n Updates the delta time value.
-            void UpdateDeltaTime();
+            /// \n Updates the delta time value, measured or fixed (see Context::SetFixedTimeStep).
+            void UpdateDeltaTime(const ctx::Context& context);
         };
     }
 }
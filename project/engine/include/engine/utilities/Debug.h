@@ -12,6 +12,9 @@
 namespace EisEngine {
     using namespace std;
 
+    class Vector3;
+    class Color;
+
     enum LogPriority{ InfoP = 0, DebugP = 1, WarnP = 2, ErrorP = 3, FatalP = 4};
 
     /**
@@ -151,6 +154,25 @@ namespace EisEngine {
         }
 
         static void SetPriority(LogPriority val) {Priority = val;}
+
+        /// \n Draws a line in world space. All debug shapes of a frame are drawn in a single draw call.
+        /// @param start - Vector3: the line's start point in world space.
+        /// @param end - Vector3: the line's end point in world space.
+        /// @param color - Color: the line's color.
+        /// @param duration - float: the time in seconds the line stays visible. 0 draws it for one frame only.
+        static void DrawLine(const Vector3& start, const Vector3& end, const Color& color, float duration = 0.0f);
+        /// \n Draws the edges of an axis-aligned box in world space.
+        /// @param center - Vector3: the box's center in world space.
+        /// @param halfExtents - Vector3: half of the box's size along each axis.
+        /// @param color - Color: the box's color.
+        /// @param duration - float: the time in seconds the box stays visible. 0 draws it for one frame only.
+        static void DrawBox(const Vector3& center, const Vector3& halfExtents, const Color& color, float duration = 0.0f);
+        /// \n Draws a wireframe sphere in world space.
+        /// @param center - Vector3: the sphere's center in world space.
+        /// @param radius - float: the sphere's radius.
+        /// @param color - Color: the sphere's color.
+        /// @param duration - float: the time in seconds the sphere stays visible. 0 draws it for one frame only.
+        static void DrawSphere(const Vector3& center, float radius, const Color& color, float duration = 0.0f);
     private:
         /// \n Compiles the log info to a message in the console.
         static void CreateLog(LogPriority priority,
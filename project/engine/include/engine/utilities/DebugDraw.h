@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace EisEngine {
+    class Color;
+
+    /// \n A vertex of a debug line: a world space position and an RGBA8 color.
+    struct DebugVertex {
+        glm::vec3 position;
+        uint32_t color;
+    };
+
+    /// \n Collects debug lines from anywhere (any thread) during a frame, to be drawn by the rendering system
+    /// in a single draw call. Use the Debug::DrawLine/DrawBox/DrawSphere functions or DebugLine rather than
+    /// this class directly.
+    class DebugDraw {
+    public:
+        /// \n Packs a color with components within [0, 1] into RGBA8.
+        static uint32_t PackColor(const glm::vec4& color);
+        static uint32_t PackColor(const Color& color);
+
+        /// \n Adds a line in world space.
+        /// @param duration - float: the time in seconds the line stays visible. 0 draws it in the next frame only.
+        static void AddLine(const glm::vec3& start, const glm::vec3& end, uint32_t color, float duration = 0.0f);
+        /// \n Adds the 12 edges of an axis-aligned box.
+        static void AddBox(const glm::vec3& center, const glm::vec3& halfExtents, uint32_t color, float duration = 0.0f);
+        /// \n Adds a sphere approximated by three circles around its axes.
+        static void AddSphere(const glm::vec3& center, float radius, uint32_t color, float duration = 0.0f);
+
+        /// \n Adds a line drawn every frame until it is removed.
+        /// @return uint32_t: an id to update or remove the line with.
+        static uint32_t AddPersistentLine(const glm::vec3& start, const glm::vec3& end, uint32_t color);
+        /// \n Moves the end points of a persistent line.
+        static void SetPersistentLinePoints(uint32_t id, const glm::vec3& start, const glm::vec3& end);
+        /// \n Changes the color of a persistent line.
+        static void SetPersistentLineColor(uint32_t id, uint32_t color);
+        /// \n Stops drawing a persistent line & frees its id.
+        static void RemovePersistentLine(uint32_t id);
+
+        /// \n The amount of vertices to draw in the current frame, two per line.
+        static size_t GetVertexCount();
+        /// \n Copies the vertices of the current frame to the given memory, e.g. a mapped buffer.
+        /// @param maxVertices - size_t: the amount of vertices fitting into the memory.
+        /// @return size_t: the amount of vertices written.
+        static size_t WriteVertices(DebugVertex* out, size_t maxVertices);
+        /// \n Drops the lines of the current frame & ages the lines with a lifetime.
+        /// @param deltaTime - float: the time in seconds the frame took.
+        static void EndFrame(float deltaTime);
+    private:
+        /// \n A line with a lifetime.
+        struct TimedLine {
+            DebugVertex start;
+            DebugVertex end;
+            float remaining;
+        };
+
+        /// \n Appends a line without locking.
+        static void PushLine(const glm::vec3& start, const glm::vec3& end, uint32_t color, float duration);
+
+        static std::mutex mutex;
+        /// \n The lines drawn in the next frame only, as vertex pairs.
+        static std::vector<DebugVertex> frameVertices;
+        /// \n The lines drawn until their lifetime runs out.
+        static std::vector<TimedLine> timedLines;
+        /// \n The persistent lines as vertex pairs, indexed by id.
+        static std::vector<DebugVertex> persistentVertices;
+        /// \n Whether the persistent line with the given id is in use.
+        static std::vector<char> persistentAlive;
+        /// \n The ids of removed persistent lines, reused by new ones.
+        static std::vector<uint32_t> freePersistentIds;
+        /// \n The amount of persistent lines in use.
+        static size_t persistentCount;
+    };
+}
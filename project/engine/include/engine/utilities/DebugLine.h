@@ -4,21 +4,16 @@
 
 namespace EisEngine {
     class Game;
-    namespace ecs { class Entity;}
-    namespace components {
-        class Transform;
-        class Line;
-    }
 
     // yes name is confusing/bad. Was initially created to debug physics and kept the name for lack of a better one...
-    /// \n Draws a line between two given points on screen, in the given color.
+    /// \n Draws a line between two given points on screen, in the given color, until invalidated.\n
+    /// A handle to a persistent line of the batched debug renderer; for lines changing every frame,
+    /// Debug::DrawLine is cheaper.
     class DebugLine {
-        using Entity = ecs::Entity;
-        using Transform = components::Transform;
     public:
         /// \n Creates a new DebugLine object.
-        /// @param startPoint - Vector3: The local position of where the line should start.
-        /// @param endPoint - Vector3: The local position of where the line should end.
+        /// @param startPoint - Vector3: The world position of where the line should start.
+        /// @param endPoint - Vector3: The world position of where the line should end.
         /// @param color - Color: The line's color on screen.
         DebugLine(Game &engine, const Vector3& startPoint, const Vector3& endPoint, const Color &color);
 
@@ -27,14 +22,12 @@ namespace EisEngine {
         /// \n Sets a new color for the line.
         void UpdateColor(const Color& color);
 
-        /// \n The transform for the line.
-        Transform *transform;
         /// \n A function called when an object is intentionally deleted.
         void Invalidate();
     private:
-        /// \n The entity bundling all the lines together.
-        Entity *entity;
-        /// \n A pointer to the engine instance.
-        Game* engine = nullptr;
+        /// \n The id of the line in the batched debug renderer.
+        uint32_t id;
+        /// \n Whether the line was removed from the debug renderer.
+        bool invalidated = false;
     };
 }
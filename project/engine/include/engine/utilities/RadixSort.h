@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace EisEngine {
+    /// \n An item to sort: a key and the index of the sorted object.
+    struct SortEntry {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    /// \n Maps a float to an unsigned integer of the same order, to be used in radix sort keys.
+    uint32_t OrderedFloatBits(float value);
+
+    /// \n Sorts entries by ascending key with a stable least significant digit radix sort (8 bits per pass).
+    /// Passes over bytes shared by all keys are skipped, so short keys only cost as many passes as they use.
+    /// @param scratch - std::vector&lt;SortEntry>: a buffer reused across calls to avoid allocations.
+    void RadixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch);
+}
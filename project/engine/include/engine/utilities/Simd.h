@@ -0,0 +1,55 @@
+#pragma once
+
+// SIMD feature detection shared by the engine's CPU-side hot loops.
+// EIS_SSE is defined whenever SSE2 intrinsics are available; code using it must provide a scalar fallback.
+
+#if !defined(EIS_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define EIS_SSE 1
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+
+namespace EisEngine {
+    /// \n Four floats processed at once, e.g. the edge functions of four neighbouring pixels in the software
+    /// rasterizers. Falls back to scalar code without EIS_SSE.
+#ifdef EIS_SSE
+    struct Float4 {
+        __m128 v;
+
+        static Float4 Set(float x) { return {_mm_set1_ps(x)};}
+        /// \n x, x + 1, x + 2, x + 3.
+        static Float4 Ramp(float x) { return {_mm_setr_ps(x, x + 1.0f, x + 2.0f, x + 3.0f)};}
+        static Float4 Load(const float* p) { return {_mm_loadu_ps(p)};}
+        void Store(float* p) const { _mm_storeu_ps(p, v);}
+        Float4 operator+(const Float4& o) const { return {_mm_add_ps(v, o.v)};}
+        Float4 operator*(const Float4& o) const { return {_mm_mul_ps(v, o.v)};}
+        /// \n A bit per lane where this >= o, respectively this < o.
+        [[nodiscard]] int GreaterEqual(const Float4& o) const { return _mm_movemask_ps(_mm_cmpge_ps(v, o.v));}
+        [[nodiscard]] int Less(const Float4& o) const { return _mm_movemask_ps(_mm_cmplt_ps(v, o.v));}
+    };
+#else
+    struct Float4 {
+        float v[4];
+
+        static Float4 Set(float x) { return {{x, x, x, x}};}
+        static Float4 Ramp(float x) { return {{x, x + 1.0f, x + 2.0f, x + 3.0f}};}
+        static Float4 Load(const float* p) { return {{p[0], p[1], p[2], p[3]}};}
+        void Store(float* p) const { std::copy(v, v + 4, p);}
+        Float4 operator+(const Float4& o) const { return {{v[0] + o.v[0], v[1] + o.v[1], v[2] + o.v[2], v[3] + o.v[3]}};}
+        Float4 operator*(const Float4& o) const { return {{v[0] * o.v[0], v[1] * o.v[1], v[2] * o.v[2], v[3] * o.v[3]}};}
+        [[nodiscard]] int GreaterEqual(const Float4& o) const {
+            int mask = 0;
+            for(int i = 0; i < 4; i++)
+                mask |= (v[i] >= o.v[i]) << i;
+            return mask;
+        }
+        [[nodiscard]] int Less(const Float4& o) const {
+            int mask = 0;
+            for(int i = 0; i < 4; i++)
+                mask |= (v[i] < o.v[i]) << i;
+            return mask;
+        }
+    };
+#endif
+}
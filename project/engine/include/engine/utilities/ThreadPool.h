@@ -0,0 +1,53 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace EisEngine {
+    /// \n A fixed set of worker threads executing queued tasks.\n
+    /// Used to spread CPU-side work (light assignment, mesh processing, ...) across cores.
+    class ThreadPool {
+    public:
+        /// \n Creates a thread pool.
+        /// @param threadCount - unsigned int: the amount of worker threads. Defaults to one less than the
+        /// amount of hardware threads, as the calling thread participates in ParallelFor.
+        explicit ThreadPool(unsigned int threadCount = DefaultThreadCount());
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        /// \n Finishes all queued tasks and joins the worker threads.
+        ~ThreadPool();
+
+        /// \n Queues a task for execution on a worker thread.
+        /// @return std::future&lt;void>: becomes ready once the task has finished.
+        std::future<void> Submit(std::function<void()> task);
+
+        /// \n Splits the range [0, count) into chunks and processes them in parallel, blocking until all are done.
+        /// If chunks throw, the first exception is rethrown on the calling thread once all chunks finished.
+        /// @param f - void(size_t begin, size_t end): called once per chunk.
+        /// @param minChunkSize - size_t: the smallest amount of items worth handing to another thread.
+        void ParallelFor(size_t count, const std::function<void(size_t, size_t)>& f, size_t minChunkSize = 1);
+
+        /// \n The amount of worker threads.
+        [[nodiscard]] unsigned int GetThreadCount() const { return (unsigned int) workers.size();}
+
+        /// \n The engine-wide thread pool, created on first use.
+        static ThreadPool& Global();
+        /// \n One less than the amount of hardware threads, but at least one.
+        static unsigned int DefaultThreadCount();
+    private:
+        /// \n The main loop of each worker thread.
+        void WorkerLoop();
+
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable wakeUp;
+        bool stopping = false;
+    };
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace EisEngine::rendering {
+    /// \n An axis-aligned bounding box.
+    struct AABB {
+        /// \n The corner with the smallest coordinates.
+        glm::vec3 min = glm::vec3(0.0f);
+        /// \n The corner with the largest coordinates.
+        glm::vec3 max = glm::vec3(0.0f);
+
+        /// \n The center point of the box.
+        [[nodiscard]] glm::vec3 Center() const { return (min + max) * 0.5f;}
+        /// \n Half the size of the box along each axis.
+        [[nodiscard]] glm::vec3 Extents() const { return (max - min) * 0.5f;}
+        /// \n The surface area of the box.
+        [[nodiscard]] float SurfaceArea() const;
+
+        /// \n Returns the box enclosing this box after the given transformation.
+        [[nodiscard]] AABB Transformed(const glm::mat4& m) const;
+        /// \n Returns the smallest box containing both this and the other box.
+        [[nodiscard]] AABB Merged(const AABB& other) const;
+        /// \n Determines whether the other box lies fully within this box.
+        [[nodiscard]] bool Contains(const AABB& other) const;
+        /// \n Determines whether both boxes intersect.
+        [[nodiscard]] bool Overlaps(const AABB& other) const;
+
+        /// \n Computes the box enclosing all given points.
+        static AABB FromPoints(const std::vector<glm::vec3>& points);
+    };
+
+    /// \n A half-line starting at an origin point, used for picking and visibility queries.
+    struct Ray {
+        /// \n The point the ray starts from.
+        glm::vec3 origin = glm::vec3(0.0f);
+        /// \n The normalized direction of the ray.
+        glm::vec3 direction = glm::vec3(0.0f, 0.0f, -1.0f);
+
+        /// \n Intersects the ray with a box.
+        /// @param box - AABB: the box to test against.
+        /// @param maxDistance - float: the furthest distance along the ray to consider.
+        /// @param hitDistance - float&: receives the distance to the entry point if the box is hit.
+        /// @return bool: whether the ray enters the box within maxDistance.
+        bool Intersects(const AABB& box, float maxDistance, float& hitDistance) const;
+    };
+
+    /// \n A sphere enclosing an object.
+    struct BoundingSphere {
+        /// \n The sphere's center point.
+        glm::vec3 center = glm::vec3(0.0f);
+        /// \n The sphere's radius.
+        float radius = 0.0f;
+
+        /// \n Returns the sphere enclosing this sphere after the given transformation.
+        [[nodiscard]] BoundingSphere Transformed(const glm::mat4& m) const;
+        /// \n Determines whether the sphere intersects the given box.
+        [[nodiscard]] bool Overlaps(const AABB& box) const;
+        /// \n Returns the box enclosing the sphere.
+        [[nodiscard]] AABB ToAABB() const { return {center - glm::vec3(radius), center + glm::vec3(radius)};}
+    };
+
+    /// \n Bounding box and sphere of a mesh, computed once from its vertices.
+    struct BoundingVolume {
+        AABB box;
+        BoundingSphere sphere;
+
+        /// \n Returns the bounding volume after the given transformation.
+        [[nodiscard]] BoundingVolume Transformed(const glm::mat4& m) const
+        { return {box.Transformed(m), sphere.Transformed(m)};}
+
+        /// \n Computes box and sphere enclosing all given points.
+        static BoundingVolume FromPoints(const std::vector<glm::vec3>& points);
+    };
+}
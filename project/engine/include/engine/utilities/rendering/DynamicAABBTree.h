@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "engine/utilities/rendering/BoundingVolume.h"
+#include "engine/utilities/rendering/Frustum.h"
+
+namespace EisEngine::rendering {
+    /// \n A stack of node indices living on the call stack, only touching the heap for very deep trees.
+    template<int N>
+    class TraversalStack {
+    public:
+        void Push(int value){
+            if(count == capacity){
+                std::vector<int> grown(capacity * 2);
+                std::copy(data, data + count, grown.begin());
+                heap.swap(grown);
+                data = heap.data();
+                capacity *= 2;
+            }
+            data[count++] = value;
+        }
+        int Pop() { return data[--count];}
+        [[nodiscard]] bool Empty() const { return count == 0;}
+    private:
+        int fixed[N];
+        std::vector<int> heap;
+        int* data = fixed;
+        int count = 0;
+        int capacity = N;
+    };
+
+    /// \n A dynamic bounding volume hierarchy over axis-aligned boxes.\n
+    /// Leaves store enlarged ("fat") boxes so that small movements do not require re-insertion,
+    /// and the tree is kept balanced through rotations, so queries run in logarithmic time.\n
+    /// Does not require a GL context.
+    class DynamicAABBTree {
+    public:
+        /// \n Index of an invalid node.
+        static constexpr int nullNode = -1;
+
+        /// \n Creates an empty tree.
+        /// @param margin - float: the distance by which leaf boxes are enlarged on each side.
+        explicit DynamicAABBTree(float margin = 0.1f);
+
+        /// \n Inserts a new leaf into the tree.
+        /// @param box - AABB: the tight box of the object.
+        /// @param userData - void*: data returned by GetUserData for this proxy.
+        /// @return int: the proxy ID of the new leaf.
+        int CreateProxy(const AABB& box, void* userData);
+        /// \n Removes a leaf from the tree.
+        void DestroyProxy(int proxyId);
+        /// \n Updates a leaf's box. The leaf is only re-inserted if the box left its fat box.
+        /// @param displacement - glm::vec3: the movement since the last update, used to predict the fat box.
+        /// @return bool: whether the leaf was re-inserted.
+        bool MoveProxy(int proxyId, const AABB& box, const glm::vec3& displacement = glm::vec3(0.0f));
+        /// \n Removes all leaves from the tree.
+        void Clear();
+
+        /// \n Access the user data of a proxy.
+        [[nodiscard]] void* GetUserData(int proxyId) const { return nodes[proxyId].userData;}
+        /// \n Access the enlarged box of a proxy.
+        [[nodiscard]] const AABB& GetFatAABB(int proxyId) const { return nodes[proxyId].box;}
+        /// \n The amount of leaves in the tree.
+        [[nodiscard]] int GetProxyCount() const { return proxyCount;}
+        /// \n The height of the tree; 0 for a single leaf, -1 if empty.
+        [[nodiscard]] int GetHeight() const { return root == nullNode ? -1 : nodes[root].height;}
+
+        /// \n Calls the callback for each proxy whose fat box overlaps the given box.
+        /// @param callback - bool(int proxyId): return false to stop the query.
+        template<typename F>
+        void QueryAABB(const AABB& box, F callback) const {
+            Query([&box](const AABB& b){ return b.Overlaps(box);}, callback);
+        }
+        /// \n Calls the callback for each proxy whose fat box overlaps the given sphere.
+        /// @param callback - bool(int proxyId): return false to stop the query.
+        template<typename F>
+        void QuerySphere(const BoundingSphere& sphere, F callback) const {
+            Query([&sphere](const AABB& b){ return sphere.Overlaps(b);}, callback);
+        }
+        /// \n Calls the callback for each proxy whose fat box is at least partially inside the frustum.
+        /// @param callback - bool(int proxyId): return false to stop the query.
+        template<typename F>
+        void QueryFrustum(const Frustum& frustum, F callback) const {
+            Query([&frustum](const AABB& b){ return frustum.TestAABB(b);}, callback);
+        }
+        /// \n Calls the callback for each proxy whose fat box is hit by the ray, in no particular order.
+        /// @param callback - float(int proxyId, float hitDistance): returns the new maximum distance,
+        /// allowing closest-hit queries to shrink the search. Return 0 to stop the query.
+        template<typename F>
+        void Raycast(const Ray& ray, float maxDistance, F callback) const {
+            if(root == nullNode)
+                return;
+            TraversalStack<256> stack;
+            stack.Push(root);
+            while(!stack.Empty()){
+                auto id = stack.Pop();
+                const auto& node = nodes[id];
+                float t;
+                if(!ray.Intersects(node.box, maxDistance, t))
+                    continue;
+                if(node.IsLeaf()){
+                    maxDistance = callback(id, t);
+                    if(maxDistance <= 0.0f)
+                        break;
+                }
+                else{
+                    stack.Push(node.child1);
+                    stack.Push(node.child2);
+                }
+            }
+        }
+    private:
+        struct Node {
+            /// \n The (fat) box enclosing this node's subtree.
+            AABB box;
+            void* userData = nullptr;
+            /// \n The parent node, or the next free node while the node is unused.
+            int parent = nullNode;
+            int child1 = nullNode;
+            int child2 = nullNode;
+            /// \n Leaf = 0, free node = -1.
+            int height = -1;
+
+            [[nodiscard]] bool IsLeaf() const { return child1 == nullNode;}
+        };
+
+        /// \n Depth-first traversal descending into all nodes accepted by the predicate.
+        template<typename P, typename F>
+        void Query(P overlaps, F callback) const {
+            if(root == nullNode)
+                return;
+            TraversalStack<256> stack;
+            stack.Push(root);
+            while(!stack.Empty()){
+                auto id = stack.Pop();
+                const auto& node = nodes[id];
+                if(!overlaps(node.box))
+                    continue;
+                if(node.IsLeaf()){
+                    if(!callback(id))
+                        break;
+                }
+                else{
+                    stack.Push(node.child1);
+                    stack.Push(node.child2);
+                }
+            }
+        }
+
+        int AllocateNode();
+        void FreeNode(int nodeId);
+        void InsertLeaf(int leaf);
+        void RemoveLeaf(int leaf);
+        /// \n Performs a left or right rotation if the node is imbalanced.
+        /// @return int: the new root of the subtree.
+        int Balance(int nodeId);
+
+        std::vector<Node> nodes;
+        int root = nullNode;
+        int freeList = nullNode;
+        int proxyCount = 0;
+        float margin;
+    };
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <OpenGL/OpenGlInclude.h>
+
+namespace EisEngine::rendering {
+    /// \n A frame read back from the GPU.
+    struct CapturedFrame {
+        /// \n The number of the frame, counting the captures from 0.
+        uint64_t index = 0;
+        int width = 0;
+        int height = 0;
+        /// \n RGBA8 pixels, rows from the bottom to the top. Only valid during the callback.
+        const unsigned char* pixels = nullptr;
+    };
+
+    /// \n Counters of a FrameReadback.
+    struct ReadbackStats {
+        /// \n The amount of frames whose readback was issued.
+        size_t captured = 0;
+        /// \n The amount of frames handed to the callback.
+        size_t delivered = 0;
+        /// \n The amount of captures that had to wait for an older frame, as all pixel buffers were in flight.
+        size_t stalls = 0;
+    };
+
+    /// \n Copies frames from a framebuffer into host memory without stalling the pipeline: each capture is copied
+    /// into one of a few pixel buffer objects on the GPU & fenced; frames are handed to the callback once their
+    /// copy finished, usually a few frames later. The buffers are persistently mapped, so no further copy is made.\n
+    /// Requires a graphics context; destroy it before the context.
+    class FrameReadback {
+    public:
+        using Callback = std::function<void(const CapturedFrame&)>;
+
+        /// \n Creates the readback; the pixel buffers are created with the first capture.
+        /// @param callback - Callback: receives the frames in capture order.
+        /// @param bufferCount - size_t: the amount of frames in flight before a capture waits for the oldest one.
+        explicit FrameReadback(Callback callback, size_t bufferCount = 3);
+        ~FrameReadback();
+        FrameReadback(const FrameReadback&) = delete;
+        FrameReadback& operator=(const FrameReadback&) = delete;
+
+        /// \n Issues the copy of a framebuffer's color buffer.
+        void Capture(GLuint framebuffer, int width, int height);
+        /// \n Hands the frames whose copy finished to the callback, without waiting for the others.
+        void Collect();
+        /// \n Waits for all frames in flight & hands them to the callback, e.g. before shutting down.
+        void Flush();
+
+        [[nodiscard]] const ReadbackStats& GetStats() const { return stats;}
+    private:
+        /// \n A pixel buffer object & the frame copied into it.
+        struct Slot {
+            GLuint buffer = 0;
+            unsigned char* mapped = nullptr;
+            size_t capacity = 0;
+            GLsync fence = nullptr;
+            CapturedFrame frame;
+        };
+
+        /// \n (Re)creates a slot's pixel buffer with room for the given amount of bytes.
+        void Reserve(Slot& slot, size_t size);
+        /// \n Waits for a slot's copy if requested, then hands its frame to the callback.
+        /// @return bool: whether the frame was delivered, false if it is still in flight.
+        bool Deliver(Slot& slot, bool wait);
+        /// \n Unmaps & deletes a slot's pixel buffer.
+        static void ReleaseSlot(Slot& slot);
+
+        Callback callback;
+        std::vector<Slot> slots;
+        /// \n The slot of the next capture; the oldest frame in flight, if any.
+        size_t next = 0;
+        uint64_t frameIndex = 0;
+        ReadbackStats stats;
+    };
+}
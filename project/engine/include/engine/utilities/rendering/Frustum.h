@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+#include "engine/utilities/rendering/BoundingVolume.h"
+
+namespace EisEngine::rendering {
+    /// \n The six clipping planes of a camera's view volume.\n
+    /// Planes are stored in SIMD-friendly form so that each object is tested against four planes at a time.
+    /// Does not require a GL context.
+    class Frustum {
+    public:
+        /// \n Creates a frustum from the given view-projection matrix.
+        explicit Frustum(const glm::mat4& viewProjection = glm::mat4(1.0f));
+
+        /// \n Extracts the frustum planes from the given view-projection matrix.
+        void Update(const glm::mat4& viewProjection);
+
+        /// \n Determines whether the sphere is at least partially inside the frustum.
+        [[nodiscard]] bool TestSphere(const BoundingSphere& sphere) const;
+        /// \n Determines whether the box is at least partially inside the frustum.
+        [[nodiscard]] bool TestAABB(const AABB& box) const;
+        /// \n Determines whether a bounding volume is visible, testing the sphere before the tighter box.
+        [[nodiscard]] bool TestVolume(const BoundingVolume& volume) const
+        { return TestSphere(volume.sphere) && TestAABB(volume.box);}
+
+        /// \n Tests a batch of boxes against the frustum.
+        /// @param visibility - unsigned char*: output array receiving 1 for visible and 0 for culled boxes.
+        /// @return size_t: the amount of visible boxes.
+        size_t CullAABBs(const AABB* boxes, size_t count, unsigned char* visibility) const;
+
+        /// \n The normalized planes (xyz = normal pointing inwards, w = distance) in order
+        /// left, right, bottom, top, near, far.
+        [[nodiscard]] const std::array<glm::vec4, 6>& GetPlanes() const { return planes;}
+    private:
+        /// \n The planes as extracted from the matrix.
+        std::array<glm::vec4, 6> planes;
+        // structure-of-arrays copy of the planes, padded to 8 by repeating the far plane.
+        alignas(16) float nx[8];
+        alignas(16) float ny[8];
+        alignas(16) float nz[8];
+        alignas(16) float d[8];
+        // absolute normal values, used for box extents.
+        alignas(16) float ax[8];
+        alignas(16) float ay[8];
+        alignas(16) float az[8];
+    };
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <OpenGL/OpenGlInclude.h>
+#include "engine/utilities/rendering/RenderBackend.h"
+#include "engine/utilities/rendering/StreamingRingBuffer.h"
+#include "engine/utilities/rendering/StaticGeometry.h"
+
+namespace EisEngine::rendering {
+    /// \n The backend executing command lists with OpenGL. Requires a graphics context.
+    class GLRenderBackend : public RenderBackend {
+    public:
+        /// \n Creates an OpenGL backend.
+        /// @param stream - StreamingRingBuffer&: the buffer instance data is written to. Must outlive the backend.
+        explicit GLRenderBackend(StreamingRingBuffer& stream);
+
+        void UploadInstances(const std::vector<InstanceData>& instances) override;
+        void Submit(const RenderCommandList& list, Shader* activeShader) override;
+        void SubmitDepth(const RenderCommandList& list, Shader* depthShader) override;
+
+        /// \n Uploads a selection of lights to the given shader.
+        static void ApplyLights(Shader& activeShader, const LightBlock& lights);
+    private:
+        /// \n Issues a multi-draw from the static geometry arenas: the draw commands are streamed to the ring buffer,
+        /// and the shader reads each draw's transform from the instance data (bound as a shader storage buffer)
+        /// at gl_DrawID.
+        void MultiDraw(const RenderCommandList& list, const MultiDrawCommand& draw, Shader& shader);
+
+        /// \n The ring buffer holding per-instance matrices for instanced draws.
+        StreamingRingBuffer& stream;
+        /// \n The offset of the last uploaded instance data in the ring buffer.
+        GLintptr instanceOffset = 0;
+        /// \n Whether the instance data fit into the ring buffer; instanced draws are skipped otherwise.
+        bool instancesUploaded = false;
+        /// \n CPU-side staging of the commands of a multi-draw, reused across draws.
+        std::vector<DrawElementsIndirectCommand> indirectCommands = {};
+    };
+}
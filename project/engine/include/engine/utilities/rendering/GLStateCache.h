@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <OpenGL/OpenGlInclude.h>
+
+// the amount of texture units whose bindings are tracked; units above are always bound.
+#define MAX_TRACKED_TEXTURE_UNITS 16
+
+namespace EisEngine::rendering {
+    /// \n The calls passed through the state cache within a frame.
+    struct StateCacheStats {
+        /// \n The calls forwarded to the driver.
+        size_t issued = 0;
+        /// \n The calls dropped, as they would not have changed the state.
+        size_t filtered = 0;
+    };
+
+    /// \n Shadows the OpenGL state set by the engine - the bound program, vertex array, buffers, textures &
+    /// framebuffers and the blend, depth, cull, color mask & viewport state - and drops calls which would
+    /// not change it.\n
+    /// All engine code binds & toggles this state through the cache. Code changing it directly (e.g. ImGui)
+    /// has to be followed by Invalidate; the rendering system invalidates the cache at the start of every frame.
+    /// Deleted buffers & textures have to be reported (OnBufferDeleted/OnTextureDeleted), as their names are reused.
+    class GLStateCache {
+    public:
+        static void UseProgram(GLuint program);
+        /// \n Binds a vertex array. The element array buffer binding is part of the vertex array's state.
+        static void BindVertexArray(GLuint vertexArray);
+        static void BindBuffer(GLenum target, GLuint buffer);
+        /// \n Binds a buffer to an indexed binding point. Always issued; also binds the buffer to the target.
+        static void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+        /// \n Binds a texture to the given texture unit (0-based, not GL_TEXTURE0-based).
+        static void BindTexture(GLuint unit, GLenum target, GLuint texture);
+        /// \n Binds a texture to the active texture unit, e.g. to upload data.
+        static void BindTexture(GLenum target, GLuint texture);
+        /// \n Binds a framebuffer to GL_FRAMEBUFFER (read & draw), GL_READ_FRAMEBUFFER or GL_DRAW_FRAMEBUFFER.
+        static void BindFramebuffer(GLenum target, GLuint framebuffer);
+
+        /// \n glEnable; tracked for GL_BLEND, GL_DEPTH_TEST & GL_CULL_FACE.
+        static void Enable(GLenum capability);
+        /// \n glDisable; tracked for GL_BLEND, GL_DEPTH_TEST & GL_CULL_FACE.
+        static void Disable(GLenum capability);
+        static void BlendFunc(GLenum source, GLenum destination);
+        /// \n Sets the blend function of a single draw buffer. Always issued.
+        static void BlendFunci(GLuint drawBuffer, GLenum source, GLenum destination);
+        static void DepthMask(bool write);
+        static void DepthFunc(GLenum function);
+        static void CullFace(GLenum face);
+        /// \n Enables or disables writing all color channels.
+        static void ColorMask(bool write);
+        static void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+        /// \n The current viewport (x, y, width, height), queried from the driver only if unknown.
+        static std::array<GLint, 4> GetViewport();
+
+        /// \n Drops cached bindings of a buffer about to be deleted, so that a buffer reusing its name is bound.
+        static void OnBufferDeleted(GLuint buffer);
+        /// \n Drops cached bindings of a texture about to be deleted, so that a texture reusing its name is bound.
+        static void OnTextureDeleted(GLuint texture);
+        /// \n Forgets all state, so that the next call of every kind is issued.
+        static void Invalidate();
+        /// \n Stores the counters of the ending frame, resets them & invalidates the cache.
+        static void BeginFrame();
+        /// \n The counters of the previous frame.
+        static const StateCacheStats& GetFrameStats() { return previousFrame;}
+    private:
+        /// \n Counts a call & returns whether it has to be issued, updating the cached value.
+        template<typename T>
+        static bool Change(T& cached, const T& value);
+        /// \n The index of a tracked buffer target, -1 if the target is not tracked.
+        static int BufferSlot(GLenum target);
+        /// \n The index of a tracked texture target, -1 if the target is not tracked.
+        static int TextureSlot(GLenum target);
+        /// \n The cached state of a capability, nullptr if the capability is not tracked.
+        static int8_t* Capability(GLenum capability);
+
+        static GLuint program;
+        static GLuint vertexArray;
+        static std::array<GLuint, 7> buffers;
+        static GLuint activeTexture;
+        static std::array<std::array<GLuint, 3>, MAX_TRACKED_TEXTURE_UNITS> textures;
+        static GLuint readFramebuffer;
+        static GLuint drawFramebuffer;
+        /// \n GL_BLEND, GL_DEPTH_TEST & GL_CULL_FACE; 0 or 1, -1 if unknown.
+        static std::array<int8_t, 3> capabilities;
+        static std::array<GLenum, 2> blendFunc;
+        static int8_t depthMask;
+        static GLenum depthFunc;
+        static GLenum cullFace;
+        static int8_t colorMask;
+        static std::array<GLint, 4> viewport;
+
+        static StateCacheStats currentFrame;
+        static StateCacheStats previousFrame;
+    };
+}
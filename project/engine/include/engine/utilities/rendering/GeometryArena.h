@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <OpenGL/OpenGlInclude.h>
+
+namespace EisEngine::rendering {
+    /// \n The occupancy of a GeometryArena & the counters of its maintenance.
+    struct GeometryArenaStats {
+        /// \n The size of the buffer object in bytes.
+        size_t capacity = 0;
+        /// \n The bytes held by live allocations.
+        size_t used = 0;
+        /// \n The amount of live allocations.
+        size_t allocations = 0;
+        /// \n The amount of free ranges between & behind the allocations.
+        size_t freeBlocks = 0;
+        /// \n The size of the largest free range in bytes.
+        size_t largestFreeBlock = 0;
+        /// \n The amount of times the allocations were compacted within the same capacity.
+        size_t defragmentations = 0;
+        /// \n The amount of times the buffer object was replaced by a larger one.
+        size_t growths = 0;
+    };
+
+    /// \n A large buffer object holding the data of many draws (e.g. the vertices or indices of all meshes),
+    /// sub-allocated by offset.\n
+    /// Free ranges are kept sorted by offset and merged with their neighbours; allocations take the first range
+    /// large enough. If none is, the allocations are compacted into a new buffer object (with GPU copies) - of the
+    /// same size if the free ranges add up to enough memory, else of twice the size. Offsets may therefore change
+    /// with every allocation: allocations are referred to by handle & their offsets looked up when drawing.\n
+    /// Without a graphics context only the bookkeeping is done. The buffer object is not deleted on destruction,
+    /// as arenas may outlive the context; call Release while it exists.
+    class GeometryArena {
+    public:
+        /// \n Refers to an allocation.
+        using Handle = uint32_t;
+        static constexpr Handle INVALID_HANDLE = UINT32_MAX;
+
+        /// \n Creates an empty arena; the buffer object is created with the first allocation.
+        /// @param capacity - size_t: the initial size of the buffer object in bytes.
+        /// @param alignment - size_t: the granularity of offsets & sizes, e.g. the size of a vertex, so that an
+        /// offset divided by it yields the base vertex of a draw.
+        explicit GeometryArena(size_t capacity, size_t alignment = 4);
+
+        /// \n Reserves memory & uploads data into it.
+        /// @param data - const void*: the data to upload, nullptr to leave the memory uninitialized.
+        /// @param size - size_t: the amount of bytes, rounded up to the alignment.
+        /// @return Handle: the allocation, or INVALID_HANDLE for empty allocations.
+        Handle Allocate(const void* data, size_t size);
+        /// \n Returns an allocation's memory to the arena.
+        void Free(Handle handle);
+        /// \n Moves all allocations to the start of the buffer object, merging the free ranges into one.
+        void Defragment();
+        /// \n Deletes the buffer object & the data within, e.g. before the context is destroyed. The allocations are
+        /// kept; the next allocation creates a new buffer object.
+        void Release();
+
+        /// \n The offset of an allocation in bytes. Only valid until the next allocation or defragmentation.
+        [[nodiscard]] size_t GetOffset(Handle handle) const { return allocations[handle].offset;}
+        [[nodiscard]] size_t GetSize(Handle handle) const { return allocations[handle].size;}
+        /// \n The name of the buffer object. Changes when the allocations are moved.
+        [[nodiscard]] GLuint GetBufferID() const { return buffer;}
+        [[nodiscard]] size_t GetAlignment() const { return alignment;}
+        /// \n The share of the free memory not within the largest free range, in [0, 1].
+        [[nodiscard]] float GetFragmentation() const;
+        [[nodiscard]] GeometryArenaStats GetStats() const;
+    private:
+        /// \n A range of the buffer object in bytes.
+        struct Block {
+            size_t offset = 0;
+            size_t size = 0;
+        };
+
+        /// \n Takes memory from the first free range large enough, returning false if there is none.
+        bool TakeFreeBlock(size_t size, size_t& offset);
+        /// \n Copies the allocations back to back into a new buffer object of the given size, replacing the old one.
+        void Relocate(size_t newCapacity);
+        /// \n Creates a buffer object of the current capacity.
+        void CreateBuffer();
+
+        GLuint buffer = 0;
+        size_t capacity;
+        size_t alignment;
+        size_t used = 0;
+        /// \n The free ranges, sorted by offset & never adjacent.
+        std::vector<Block> freeBlocks = {};
+        /// \n The allocations by handle; freed entries have a size of 0.
+        std::vector<Block> allocations = {};
+        /// \n Handles of freed allocations, reused by the next allocations.
+        std::vector<Handle> freeHandles = {};
+        size_t defragmentations = 0;
+        size_t growths = 0;
+    };
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace EisEngine {
+    class ThreadPool;
+
+    namespace rendering {
+        /// \n A point light as laid out in the light storage buffer (std430).
+        struct ClusterLight {
+            /// \n xyz = world position, w = range of influence.
+            glm::vec4 posRange;
+            /// \n xyz = emission, w = intensity.
+            glm::vec4 emissionIntensity;
+        };
+
+        /// \n The slice of the light index list belonging to one cluster, as laid out in the cluster buffer (std430).
+        struct ClusterRange {
+            uint32_t offset;
+            uint32_t count;
+        };
+
+        /// \n Assigns point lights to the cells of a view space grid (clusters) dividing the view frustum
+        /// into screen tiles and depth slices.\n
+        /// Depth slices grow exponentially for perspective projections and linearly for orthographic ones.
+        /// Does not require a GL context.
+        class LightClusters {
+        public:
+            /// \n Creates a cluster grid.
+            /// @param dimensions - glm::uvec3: the amount of tiles along x and y and the amount of depth slices.
+            explicit LightClusters(const glm::uvec3& dimensions = glm::uvec3(16, 9, 24));
+
+            /// \n Derives field of view, aspect ratio and clip planes from the camera's projection matrix.
+            void SetProjection(const glm::mat4& projection);
+            /// \n Assigns the lights to clusters.
+            /// @param view - glm::mat4: the camera's view matrix.
+            /// @param lights - std::vector&lt;ClusterLight>: the lights in world space.
+            /// @param pool - ThreadPool*: if set, depth slices are processed in parallel.
+            void Assign(const glm::mat4& view, const std::vector<ClusterLight>& lights, ThreadPool* pool = nullptr);
+            /// \n Limits the amount of lights assigned to a single cluster; lights beyond the limit are dropped
+            /// in the order given to Assign. 0 assigns all lights.
+            void SetMaxLightsPerCluster(uint32_t count) { maxLightsPerCluster = count;}
+            [[nodiscard]] uint32_t GetMaxLightsPerCluster() const { return maxLightsPerCluster;}
+
+            /// \n The index ranges of all clusters, ordered x, then y, then z.
+            [[nodiscard]] const std::vector<ClusterRange>& GetRanges() const { return ranges;}
+            /// \n The light indices referenced by the cluster ranges.
+            [[nodiscard]] const std::vector<uint32_t>& GetIndices() const { return indices;}
+            /// \n The grid's dimensions.
+            [[nodiscard]] const glm::uvec3& GetDimensions() const { return dimensions;}
+            /// \n Parameters mapping view depth d to a slice: slice = (z > 0.5 ? log(d) : d) * x + y.
+            [[nodiscard]] glm::vec3 GetSliceParameters() const;
+            /// \n Returns the index of the cluster at the given grid coordinates.
+            [[nodiscard]] uint32_t ClusterIndex(uint32_t x, uint32_t y, uint32_t z) const
+            { return x + dimensions.x * (y + dimensions.y * z);}
+            /// \n Returns the depth slice containing the given view depth (distance along the view direction).
+            [[nodiscard]] uint32_t SliceOf(float depth) const;
+        private:
+            /// \n Collects the clusters of one depth slice affected by each light.
+            void AssignSlice(uint32_t slice, const std::vector<glm::vec4>& viewLights);
+            /// \n Returns the view depth at which a slice starts.
+            [[nodiscard]] float SliceStart(uint32_t slice) const;
+
+            glm::uvec3 dimensions;
+            /// \n Scale from view space x/y at depth 1 to normalized device coordinates.
+            glm::vec2 projectionScale = glm::vec2(1.0f);
+            float nearPlane = 0.1f;
+            float farPlane = 100.0f;
+            bool orthographic = false;
+            /// \n The most lights assigned to a cluster, 0 if unlimited.
+            uint32_t maxLightsPerCluster = 0;
+
+            std::vector<ClusterRange> ranges;
+            std::vector<uint32_t> indices;
+            /// \n Per depth slice list of (cluster within slice, light index) pairs, kept across frames.
+            std::vector<std::vector<std::pair<uint32_t, uint32_t>>> sliceEntries;
+        };
+    }
+}
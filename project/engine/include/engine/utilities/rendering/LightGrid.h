@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "engine/ecs/Component.h"
+
+namespace EisEngine {
+    namespace components {
+        class Transform;
+        class PointLight;
+    }
+
+    namespace rendering {
+        /// \n A light considered for a mesh together with its squared distance to the mesh.
+        struct LightCandidate {
+            components::PointLight* light;
+            float distance2;
+        };
+
+        /// \n A uniform grid binning point lights by their world (x, z) position.\n
+        /// Lights are re-binned only when their transform changes, and queries do not allocate.
+        class LightGrid {
+            using PointLight = components::PointLight;
+            using Transform = components::Transform;
+        public:
+            /// \n Packed (x, z) cell coordinates.
+            using CellKey = uint64_t;
+
+            /// \n Creates an empty light grid.
+            /// @param cellSize - float: the edge length of a cell in world units.
+            explicit LightGrid(float cellSize = 40.0f);
+
+            /// \n Starts a synchronization pass. Every light still in the scene must be tracked before EndUpdate.
+            void BeginUpdate();
+            /// \n Registers a light or re-bins it if its transform changed since it was last tracked.
+            void Track(PointLight& light);
+            /// \n Removes all lights that were not tracked since BeginUpdate.
+            void EndUpdate();
+
+            /// \n Selects the lights closest to a position from the cells surrounding it.
+            /// @param k - int: the maximum amount of lights to select.
+            /// @param scratch - LightCandidate*: working memory provided by the caller; must hold more than k entries.
+            /// @param out - PointLight**: receives up to k lights, ordered by ascending distance.
+            /// @return int: the amount of lights written to out.
+            int QueryNearest(const glm::vec3& pos, int k, LightCandidate* scratch, int scratchCapacity,
+                             PointLight** out) const;
+
+            /// \n Returns the key of the cell containing a position.
+            [[nodiscard]] CellKey KeyOf(const glm::vec3& pos) const;
+            /// \n The amount of tracked lights.
+            [[nodiscard]] size_t GetLightCount() const { return tracked.size();}
+        private:
+            /// \n A light stored inside a cell.
+            struct Entry {
+                PointLight* light;
+                glm::vec3 position;
+            };
+            /// \n Bookkeeping of a tracked light.
+            struct TrackedLight {
+                Transform* transform = nullptr;
+                guid_t owner = ecs::invalidID;
+                CellKey cell = 0;
+                uint64_t version = 0;
+                unsigned int lastSeen = 0;
+            };
+            /// \n Spreads packed cell coordinates over the hash range.
+            struct CellKeyHash {
+                size_t operator()(CellKey key) const { return (size_t) (key * 0x9E3779B97F4A7C15ull >> 17);}
+            };
+
+            /// \n Returns the key of the cell at the given cell coordinates.
+            [[nodiscard]] static CellKey Pack(int32_t x, int32_t z)
+            { return ((CellKey) (uint32_t) x << 32) | (uint32_t) z;}
+            /// \n Inserts a light into a cell.
+            void Insert(PointLight* light, CellKey cell, const glm::vec3& pos);
+            /// \n Removes a light from a cell.
+            void Erase(PointLight* light, CellKey cell);
+
+            float cellSize;
+            unsigned int frame = 0;
+            std::unordered_map<CellKey, std::vector<Entry>, CellKeyHash> cells = {};
+            std::unordered_map<PointLight*, TrackedLight> tracked = {};
+        };
+    }
+}
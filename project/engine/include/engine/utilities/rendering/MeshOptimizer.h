@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace EisEngine::rendering {
+    /// \n The GPU efficiency of a triangle list (see AnalyzeVertexCache & AnalyzeOverdraw).
+    struct MeshEfficiency {
+        /// \n The average cache miss ratio: vertex shader invocations per triangle. 0.5 at best, 3 at worst.
+        float acmr = 0.0f;
+        /// \n The fragments shaded per covered pixel. 1 at best.
+        float overdraw = 0.0f;
+    };
+
+    /// \n Reorders triangles so that their vertices are likely still in the post-transform vertex cache
+    /// (Forsyth's linear-speed vertex cache optimization): triangles are emitted greedily by the score of their
+    /// vertices, which favours recently used vertices and vertices with few remaining triangles.
+    /// @param indices - std::vector&lt;unsigned int>: the triangle list to reorder.
+    /// @param vertexCount - size_t: the amount of vertices referenced by the indices.
+    /// @return std::vector&lt;unsigned int>: the same triangles in cache friendly order.
+    std::vector<unsigned int> OptimizeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount);
+
+    /// \n Reorders a vertex cache optimized triangle list to reduce overdraw (after Sander et al.'s Tipsify):
+    /// the list is split into clusters where the cache starts over, and the clusters are sorted so that those on
+    /// the outside, facing away from the mesh's center, are drawn first and occlude the rest. Assumes counter-clockwise
+    /// front faces.
+    /// @param threshold - float: the largest increase of the ACMR accepted, as a factor; else the input is kept.
+    /// @return std::vector&lt;unsigned int>: the same triangles in overdraw reducing order.
+    std::vector<unsigned int> OptimizeOverdraw(const std::vector<glm::vec3>& positions,
+                                               const std::vector<unsigned int>& indices, float threshold = 1.05f);
+
+    /// \n Renumbers the vertices in the order the triangles first use them, so that vertex fetches read memory
+    /// sequentially. Unused vertices are moved to the end.
+    /// @param indices - std::vector&lt;unsigned int>&: the triangle list, rewritten to the new vertex numbers.
+    /// @return std::vector&lt;unsigned int>: the new index of every vertex, to reorder the vertex attributes with
+    /// (see RemapVertices).
+    std::vector<unsigned int> OptimizeVertexFetch(std::vector<unsigned int>& indices, size_t vertexCount);
+
+    /// \n Reorders a vertex attribute after OptimizeVertexFetch.
+    template<typename T>
+    std::vector<T> RemapVertices(const std::vector<T>& attribute, const std::vector<unsigned int>& remap){
+        if(attribute.size() != remap.size())
+            return attribute;
+        std::vector<T> result(attribute.size());
+        for(size_t v = 0; v < attribute.size(); v++)
+            result[remap[v]] = attribute[v];
+        return result;
+    }
+
+    /// \n Simulates a FIFO post-transform vertex cache of the given size.
+    /// @return float: the average cache miss ratio (see MeshEfficiency::acmr).
+    float AnalyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount, size_t cacheSize = 16);
+    /// \n Rasterizes the mesh with depth testing and without culling, in order, from the six axis directions.
+    /// @return float: the fragments passing the depth test per covered pixel, over all views.
+    float AnalyzeOverdraw(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace EisEngine::rendering {
+    /// \n A reduced index list of a mesh, drawing from the same vertices as the original.
+    struct MeshLOD {
+        /// \n The triangle indices of this level.
+        std::vector<unsigned int> indices;
+        /// \n An estimate of the largest distance between this level's surface and the original, in model units.
+        float error = 0.0f;
+    };
+
+    /// \n Reduces the triangle count of a mesh by collapsing edges in order of their quadric error.\n
+    /// Vertices are never moved or created, so the result indexes the original vertex buffer.
+    /// Vertices on open borders or attribute seams (several vertices sharing a position) are never removed.
+    /// @param positions - std::vector&lt;glm::vec3>: the mesh's vertex positions.
+    /// @param indices - std::vector&lt;unsigned int>: the triangle list to simplify.
+    /// @param targetIndexCount - size_t: the index count at which to stop.
+    /// @param error - float&: receives the error of the simplified mesh (see MeshLOD::error).
+    /// @return std::vector&lt;unsigned int>: the simplified triangle list.
+    std::vector<unsigned int> SimplifyMesh(const std::vector<glm::vec3>& positions,
+                                           const std::vector<unsigned int>& indices,
+                                           size_t targetIndexCount, float& error);
+
+    /// \n Builds a chain of successively simplified levels, each with about half the triangles of the last.
+    /// @param maxLevels - int: the maximum amount of levels to generate (excluding the original).
+    /// @param minTriangles - size_t: levels with fewer triangles are not generated.
+    std::vector<MeshLOD> GenerateLODChain(const std::vector<glm::vec3>& positions,
+                                          const std::vector<unsigned int>& indices,
+                                          int maxLevels = 4, size_t minTriangles = 64);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "engine/utilities/rendering/BoundingVolume.h"
+
+namespace EisEngine {
+    class ThreadPool;
+
+    namespace rendering {
+        /// \n Occlusion culling counters of a frame.
+        struct OcclusionStats {
+            /// \n The occluder triangles rasterized, after clipping.
+            size_t occluderTriangles = 0;
+            /// \n The boxes tested against the depth pyramid.
+            size_t tested = 0;
+            /// \n The boxes found to be hidden behind the occluders.
+            size_t occluded = 0;
+        };
+
+        /// \n Culls objects hidden behind large occluders on the CPU.\n
+        /// A few occluder meshes are rasterized into a low resolution depth buffer (multithreaded, one screen tile
+        /// per task, four pixels at a time), which is reduced into a hierarchical depth pyramid holding the
+        /// farthest depth of every texel. A box is hidden if its nearest point lies behind the farthest occluder
+        /// depth within its screen rectangle, read from the pyramid level where the rectangle covers 2x2 texels.\n
+        /// Meant to run after frustum culling, on its survivors. Follows OpenGL conventions (depth in [0, 1],
+        /// bottom row first). Does not require a GL context.
+        class OcclusionCuller {
+        public:
+            /// \n Creates a culler with a depth buffer of the given size.
+            explicit OcclusionCuller(int width = 256, int height = 128);
+
+            /// \n Changes the size of the depth buffer. Takes effect with the next frame.
+            void Resize(int width, int height);
+            /// \n Clears the depth buffer & starts collecting the occluders of a new frame.
+            /// @param viewProjection - glm::mat4: the camera's view projection matrix.
+            void BeginFrame(const glm::mat4& viewProjection);
+            /// \n Queues the triangles of an occluder. Its triangles must not extend past the object's surface, as they
+            /// hide everything behind them: use the mesh itself or a proxy inside it, not a simplified detail level,
+            /// which may bulge outwards. Fewer triangles rasterize faster.
+            /// @param positions - std::vector&lt;glm::vec3>: the vertex positions in model space.
+            /// @param indices - const unsigned int*: three vertex indices per triangle.
+            /// @param model - glm::mat4: the occluder's model matrix.
+            void AddOccluder(const std::vector<glm::vec3>& positions, const unsigned int* indices, size_t indexCount,
+                             const glm::mat4& model);
+            /// \n Rasterizes the queued occluders & builds the depth pyramid.
+            /// @param pool - ThreadPool*: if set, setup and tiles are processed in parallel.
+            void Resolve(ThreadPool* pool);
+            /// \n Determines whether any part of a box may be visible, i.e. is not hidden behind the occluders.
+            /// Boxes crossing the near plane are always visible. Thread-safe after Resolve.
+            [[nodiscard]] bool IsVisible(const AABB& box) const;
+            /// \n Tests a batch of boxes in parallel, counting the results in the stats.
+            /// @param visibility - unsigned char*: output array receiving 1 for visible and 0 for hidden boxes.
+            /// @return size_t: the amount of visible boxes.
+            size_t CullAABBs(const AABB* boxes, size_t count, unsigned char* visibility, ThreadPool* pool);
+
+            [[nodiscard]] int GetWidth() const { return width;}
+            [[nodiscard]] int GetHeight() const { return height;}
+            /// \n The amount of levels of the depth pyramid; level 0 is the full resolution depth buffer.
+            [[nodiscard]] int GetLevelCount() const { return (int) levels.size();}
+            /// \n The farthest depth of a texel of the depth pyramid, e.g. to visualize it.
+            [[nodiscard]] float GetDepth(int level, int x, int y) const;
+            /// \n The counters of the current frame.
+            [[nodiscard]] const OcclusionStats& GetStats() const { return stats;}
+        private:
+            /// \n An occluder triangle in screen space, ready for rasterization.
+            struct SetupTriangle {
+                /// \n Edge functions: e[i] = a[i] * x + b[i] * y + c[i], all non-negative inside the triangle.
+                glm::vec3 a, b, c;
+                /// \n Window space depth as a plane equation: z = zA * x + zB * y + zC.
+                float zA, zB, zC;
+                /// \n Bounding box in pixels (inclusive).
+                int minX, minY, maxX, maxY;
+            };
+            /// \n A level of the depth pyramid.
+            struct Level {
+                int width, height;
+                /// \n The row length of the level's depth.
+                int stride;
+                std::vector<float> depth;
+            };
+
+            /// \n Clips a triangle against the near plane & appends the resulting screen space triangles.
+            void Setup(const glm::vec4* clip, std::vector<SetupTriangle>& outTriangles) const;
+            /// \n Rasterizes all triangles overlapping a tile into the depth buffer.
+            void RasterizeTile(int tile);
+            /// \n Reduces each level of the pyramid to the farthest depth of 2x2 texels of the level below.
+            void BuildPyramid();
+
+            int width, height;
+            int tilesX = 0, tilesY = 0;
+            glm::mat4 viewProjection = glm::mat4(1.0f);
+            /// \n The occluders' vertices in clip space & three indices per triangle.
+            std::vector<glm::vec4> clipVertices = {};
+            std::vector<uint32_t> queued = {};
+            std::vector<SetupTriangle> triangles = {};
+            /// \n Per tile, the indices of the overlapping triangles.
+            std::vector<std::vector<uint32_t>> bins = {};
+            /// \n The depth buffer followed by the reduced levels of the pyramid.
+            std::vector<Level> levels = {};
+            OcclusionStats stats;
+        };
+    }
+}
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include "../Vector3.h"
+#include "BoundingVolume.h"
 
 namespace EisEngine::rendering {
     /// \n {Abstract class} Contains vertex and edge data for meshes.
@@ -9,14 +10,25 @@ namespace EisEngine::rendering {
     public:
         PrimitiveMesh(const std::vector<Vector3>& shapeVertices, const std::vector<unsigned int>& shapeIndices) :
                 indices(shapeIndices),
-                indexCount(static_cast<int>(shapeIndices.size())) { }
+                indexCount(static_cast<int>(shapeIndices.size())),
+                localBounds(CalculateBounds(shapeVertices)) { }
 
         /// \n The triangle indices for this mesh.
         const std::vector<unsigned int> indices;
         /// \n The amount of indices used.
         const int indexCount;
+        /// \n The bounding box and sphere of the mesh in model space.
+        const BoundingVolume localBounds;
 
         /// \n Access the mesh's vertices.
         [[nodiscard]] virtual std::vector<Vector3> GetVertices() const = 0;
+    private:
+        static BoundingVolume CalculateBounds(const std::vector<Vector3>& shapeVertices){
+            std::vector<glm::vec3> points;
+            points.reserve(shapeVertices.size());
+            for(const auto& v : shapeVertices)
+                points.emplace_back(v.x, v.y, v.z);
+            return BoundingVolume::FromPoints(points);
+        }
     };
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "PrimitiveMesh.h"
+#include "MeshSimplifier.h"
 
 namespace EisEngine {
     namespace components{ class Mesh3D;}
@@ -27,6 +28,16 @@ namespace EisEngine {
         [[nodiscard]] std::vector<Vector2> GetUVs() const;
         [[nodiscard]] std::vector<Vector3> GetTangents() const;
         [[nodiscard]] std::vector<Vector3> GetBitangents() const;
+        /// \n Access the mesh's vertex attributes without conversion.
+        [[nodiscard]] const std::vector<glm::vec3>& GetPositionData() const { return vertices;}
+        [[nodiscard]] const std::vector<glm::vec3>& GetNormalData() const { return normals;}
+        [[nodiscard]] const std::vector<glm::vec2>& GetUVData() const { return uvs;}
+
+        /// \n Generates a chain of simplified index lists (see GenerateLODChain), replacing any previous one.\n
+        /// Does not require a GL context, so it may run on worker threads.
+        void GenerateLODs(const int& maxLevels = 4);
+        /// \n The simplified levels of this mesh, from finest to coarsest. Level 0 (the full mesh) is not included.
+        [[nodiscard]] const std::vector<MeshLOD>& GetLODs() const { return lods;}
     private:
         const std::vector<glm::vec3> vertices;
         const std::vector<glm::vec3> normals;
@@ -38,6 +49,8 @@ namespace EisEngine {
         /// separately from tangents.
         std::vector<glm::vec3> bitangents;
         const unsigned int nVerts;
+        /// \n Simplified index lists sharing this mesh's vertices.
+        std::vector<MeshLOD> lods = {};
         void CalculateTangentVecs();
     };
     } // rendering
@@ -20,6 +20,8 @@ namespace EisEngine{
 
             /// \n Access the mesh's vertices.
             [[nodiscard]] std::vector<Vector3> GetVertices() const override;
+            /// \n Access the mesh's vertices with their texture coordinates.
+            [[nodiscard]] const std::vector<SpriteVertex>& GetSpriteVertices() const { return vertices;}
 
             /// \n A simple 1x1 square mesh to hold a Sprite.
             static const PrimitiveSpriteMesh SquareSpriteMesh;
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <OpenGL/OpenGlInclude.h>
+
+namespace fs = std::filesystem;
+
+namespace EisEngine::rendering {
+    /// \n Stores linked shader programs on disk (glGetProgramBinary), so that later runs load them instead of
+    /// compiling their sources again.\n
+    /// Binaries are keyed by a hash of the program's final sources (defines included) & the driver. Binaries
+    /// rejected by the driver, e.g. after a driver update, are compiled from source & overwritten.
+    class ProgramBinaryCache {
+    public:
+        /// \n Creates a cache storing its binaries in the given directory, created on first write.
+        /// @param directory - fs::path: relative paths start at the working directory. Empty disables the cache.
+        explicit ProgramBinaryCache(fs::path directory = "shader_cache");
+
+        /// \n The key of a program: the hash of its stages' sources & the driver compiling them.
+        [[nodiscard]] uint64_t MakeKey(const std::string& vertexSource, const std::string& fragmentSource) const;
+        /// \n Loads a cached binary into a newly created program.
+        /// @return bool: whether the program is linked & ready to use. If not, compile & link it from source.
+        bool Load(GLuint program, uint64_t key) const;
+        /// \n Writes the binary of a linked program to the cache.
+        void Store(GLuint program, uint64_t key) const;
+
+        void SetDirectory(const fs::path& path) { directory = path;}
+        [[nodiscard]] const fs::path& GetDirectory() const { return directory;}
+        /// \n Whether a directory is set & the driver supports any program binary format.
+        [[nodiscard]] bool IsEnabled() const;
+    private:
+        /// \n The file holding the binary of the given key.
+        [[nodiscard]] fs::path GetPath(uint64_t key) const;
+
+        fs::path directory;
+        /// \n The vendor, renderer & version strings of the driver, queried on first use.
+        mutable std::string driver;
+        /// \n Whether the driver supports program binaries; -1 until queried.
+        mutable int supported = -1;
+    };
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+
+namespace EisEngine::rendering {
+    /// \n The values of the rendering knobs adjusted by the quality governor.
+    struct QualitySettings {
+        /// \n The resolution of the 3D scene relative to the window's, in (0, 1].
+        float renderScale = 1.0f;
+        /// \n Whether Cook-Torrance shading is replaced by the cheaper Blinn-Phong shading.
+        bool simpleShading = false;
+        /// \n The most lights assigned to a light cluster, 0 if unlimited.
+        uint32_t maxLightsPerCluster = 0;
+        /// \n The largest on-screen deviation in pixels accepted for coarser detail levels.
+        float lodErrorThreshold = 1.0f;
+        /// \n The resolution of the thickness passes of sorted transparency relative to the scene's.
+        float thicknessScale = 0.5f;
+    };
+
+    /// \n A change of the quality level, kept for display.
+    struct QualityDecision {
+        /// \n The frame (counted by the governor) the decision was made in.
+        uint64_t frame = 0;
+        int fromLevel = 0;
+        int toLevel = 0;
+        /// \n The smoothed CPU & GPU frame times in milliseconds which caused the decision.
+        double cpuTime = 0.0;
+        double gpuTime = 0.0;
+    };
+
+    /// \n Keeps the frame time within a budget by trading image quality for speed.\n
+    /// The governor smooths the measured CPU & GPU frame times and walks a ladder of quality levels, each
+    /// degrading one knob further (thickness pass resolution, LOD error, lights per cluster, shading model,
+    /// render resolution), starting with those costing the least image quality. It degrades quickly once the
+    /// slower of both times exceeds the budget and recovers slowly once well below it; after every change it
+    /// waits for the times to settle, so that the level does not oscillate.\n
+    /// The levels are relative to the base settings, i.e. the quality chosen by the user.
+    class QualityGovernor {
+    public:
+        /// \n Creates a disabled governor.
+        /// @param budget - double: the targeted frame time in milliseconds.
+        explicit QualityGovernor(double budget = 1000.0 / 60.0);
+
+        /// \n Feeds the times measured for a frame & adjusts the quality level.
+        /// @param cpuTime - double: the CPU time of the frame's work in milliseconds.
+        /// @param gpuTime - double: the GPU time of the frame in milliseconds, negative if not measured.
+        /// @return bool: whether the quality level changed.
+        bool Update(double cpuTime, double gpuTime);
+        /// \n The settings of the current quality level derived from the given base settings. Returns the base
+        /// settings while disabled.
+        [[nodiscard]] QualitySettings GetSettings(const QualitySettings& base) const;
+        /// \n Draws the governor's controls, state & decisions into the current ImGui window.
+        /// @param base - QualitySettings: the base settings, to display the settings in effect.
+        void DrawImGui(const QualitySettings& base);
+
+        /// \n Enables or disables the governor. Disabling it restores the base settings.
+        void SetEnabled(bool enabled);
+        [[nodiscard]] bool IsEnabled() const { return enabled;}
+        /// \n Sets the targeted frame time in milliseconds.
+        void SetBudget(double milliseconds);
+        [[nodiscard]] double GetBudget() const { return budget;}
+        /// \n The current quality level; 0 is the base quality, higher levels are cheaper.
+        [[nodiscard]] int GetLevel() const { return level;}
+        [[nodiscard]] static int GetLevelCount();
+        [[nodiscard]] double GetSmoothedCpuTime() const { return cpuTime;}
+        [[nodiscard]] double GetSmoothedGpuTime() const { return gpuTime;}
+        /// \n The latest level changes, the newest last.
+        [[nodiscard]] const std::deque<QualityDecision>& GetDecisions() const { return decisions;}
+    private:
+        /// \n Moves to the given level, recording the decision & starting the cooldown.
+        void ChangeLevel(int newLevel);
+
+        bool enabled = false;
+        double budget;
+        int level = 0;
+        /// \n The exponentially smoothed frame times in milliseconds; negative until measured.
+        double cpuTime = -1.0;
+        double gpuTime = -1.0;
+        /// \n The amount of consecutive frames above, respectively well below the budget.
+        int framesOver = 0;
+        int framesUnder = 0;
+        /// \n The frames left until the next change may happen.
+        int cooldown = 0;
+        uint64_t frame = 0;
+        std::deque<QualityDecision> decisions = {};
+    };
+}
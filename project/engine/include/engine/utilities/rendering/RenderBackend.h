@@ -0,0 +1,94 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "engine/utilities/rendering/LightClusters.h"
+#include "engine/utilities/rendering/RenderCommandList.h"
+
+namespace EisEngine::rendering {
+    class Shader;
+
+    /// \n The per-frame state shared by all draws of a frame, mirroring the uniforms set once per shader.
+    struct FrameParameters {
+        /// \n The camera's view projection matrix.
+        glm::mat4 vp = glm::mat4(1.0f);
+        /// \n The camera's position in world space.
+        glm::vec3 cameraPosition = glm::vec3(0.0f);
+        /// \n The size of the render target in pixels.
+        glm::vec2 screenSize = glm::vec2(1920, 1080);
+        float ambient = 0.15f;
+        float specular = 1.0f;
+        int toonLevels = 8;
+        /// \n The name of the active 3D shader (see RenderingSystem::SetActiveShader).
+        std::string shader;
+        /// \n The lights inside the view frustum if lights are looked up per fragment (clustered lighting),
+        /// else nullptr and the lights are set per draw.
+        const std::vector<ClusterLight>* frameLights = nullptr;
+    };
+
+    /// \n The executor of recorded rendering work. The rendering system prepares everything on the CPU
+    /// and hands the results to its backend, which decides what to do with them.
+    class RenderBackend {
+    public:
+        virtual ~RenderBackend() = default;
+        /// \n Called before the first submission of a frame.
+        virtual void BeginFrame(const FrameParameters& parameters) { }
+        /// \n Called after the last submission of a frame.
+        virtual void EndFrame() { }
+        /// \n Replaces the contents of the instance buffer read by the following instanced draws.
+        virtual void UploadInstances(const std::vector<InstanceData>& instances) = 0;
+        /// \n Executes a command list.
+        /// @param activeShader - Shader*: the shader to draw with. nullptr when running without a graphics context.
+        virtual void Submit(const RenderCommandList& list, Shader* activeShader) = 0;
+        /// \n Executes the transforms & draws of a command list only, e.g. to fill the depth buffer
+        /// with a position-only shader. Defaults to a full submission.
+        virtual void SubmitDepth(const RenderCommandList& list, Shader* depthShader) { Submit(list, depthShader);}
+    };
+
+    /// \n A backend discarding all work, leaving only the CPU-side cost of preparing it.
+    class NullRenderBackend : public RenderBackend {
+    public:
+        void UploadInstances(const std::vector<InstanceData>& instances) override { }
+        void Submit(const RenderCommandList& list, Shader* activeShader) override { }
+    };
+
+    /// \n The amounts of work received by a RecordingRenderBackend.
+    struct RecordedCounts {
+        /// \n The amount of submitted command lists.
+        size_t submissions = 0;
+        /// \n The amount of commands of all kinds.
+        size_t commands = 0;
+        size_t materialChanges = 0;
+        size_t transformChanges = 0;
+        size_t lightChanges = 0;
+        /// \n The amount of draw calls, counting an instanced draw once.
+        size_t drawCalls = 0;
+        /// \n The amount of drawn objects, counting every instance of an instanced draw.
+        size_t objects = 0;
+        /// \n The amount of instance buffer uploads.
+        size_t instanceUploads = 0;
+        /// \n The amount of uploaded instance data in bytes.
+        size_t instanceBytes = 0;
+    };
+
+    /// \n A backend counting the work it receives instead of executing it,
+    /// optionally keeping a copy of every submitted command list.
+    class RecordingRenderBackend : public RenderBackend {
+    public:
+        void UploadInstances(const std::vector<InstanceData>& instances) override;
+        void Submit(const RenderCommandList& list, Shader* activeShader) override;
+
+        /// \n Returns the work received since the last reset.
+        [[nodiscard]] const RecordedCounts& GetCounts() const { return counts;}
+        /// \n Returns the command lists received since the last reset (see SetCapture).
+        [[nodiscard]] const std::vector<RenderCommandList>& GetCaptured() const { return captured;}
+        /// \n Enables or disables keeping a copy of every submitted command list.
+        void SetCapture(const bool& val) { capture = val;}
+        /// \n Clears the counters and captured command lists, e.g. at the start of a frame.
+        void Reset();
+    private:
+        RecordedCounts counts;
+        std::vector<RenderCommandList> captured = {};
+        bool capture = false;
+    };
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+// the amount of lights per draw; injected into every shader by the ResourceManager.
+#define MAX_LIGHTS 1
+
+namespace EisEngine {
+    namespace components {
+        class Mesh3D;
+        class Renderer;
+        class PointLight;
+    }
+
+    namespace rendering {
+        /// \n The kinds of commands stored in a render command list.
+        enum class RenderCommandType : uint8_t {
+            /// \n Applies a renderer's material and textures.
+            SetMaterial,
+            /// \n Sets the per-object transform uniforms.
+            SetTransform,
+            /// \n Sets the lights affecting the following draws.
+            SetLights,
+            /// \n Draws a mesh, optionally instanced.
+            DrawMesh,
+            /// \n Draws several meshes in a single multi-draw, each with its own entry of the instance buffer.
+            DrawMeshes
+        };
+
+        /// \n Per-instance data streamed to the instance buffer for instanced draws.
+        struct InstanceData {
+            /// \n The instance's model matrix.
+            glm::mat4 model;
+            /// \n The inverse transposed model matrix, used to transform normals.
+            glm::mat3 normalMat;
+        };
+
+        /// \n Per-object transform uniforms.
+        struct TransformBlock {
+            glm::mat4 mvp;
+            glm::mat4 model;
+            glm::mat3 normalMat;
+        };
+
+        /// \n The lights selected for the following draws.
+        struct LightBlock {
+            /// \n The amount of lights, or -1 if the objects are out of lighting range.
+            int count = -1;
+            std::array<components::PointLight*, MAX_LIGHTS> lights = {};
+        };
+
+        /// \n A draw of a mesh using its current detail level.
+        struct DrawMeshCommand {
+            components::Mesh3D* mesh;
+            /// \n The amount of instances to draw, or 0 for a regular draw.
+            int instanceCount = 0;
+            /// \n The first entry of the instance buffer used by this draw.
+            int firstInstance = 0;
+        };
+
+        /// \n A multi-draw of several meshes using their current detail levels.
+        struct MultiDrawCommand {
+            /// \n The first mesh of the draw within the list's multi-draw meshes.
+            uint32_t firstMesh = 0;
+            /// \n The amount of meshes drawn.
+            int drawCount = 0;
+            /// \n The entry of the instance buffer holding the first mesh's transform; the following meshes use
+            /// the following entries.
+            int firstDraw = 0;
+        };
+
+        /// \n An entry of a command list, referring to its payload by index.
+        struct RenderCommand {
+            RenderCommandType type;
+            uint32_t payload;
+        };
+
+        /// \n A recorded sequence of rendering commands that does not touch the graphics API.\n
+        /// Lists can be recorded on any thread and are executed in order on the rendering thread.
+        class RenderCommandList {
+            using Mesh3D = components::Mesh3D;
+            using Renderer = components::Renderer;
+        public:
+            /// \n Removes all commands, keeping the allocated memory for the next recording.
+            void Clear();
+
+            /// \n Records a material change. Skipped if the renderer is already bound by this list.
+            void SetMaterial(Renderer* renderer);
+            /// \n Records a change of the per-object transform uniforms.
+            void SetTransform(const TransformBlock& block);
+            /// \n Records a change of the lights. Skipped if the lights are already set by this list.
+            void SetLights(const LightBlock& block);
+            /// \n Records a draw call.
+            void DrawMesh(Mesh3D* mesh, int instanceCount = 0, int firstInstance = 0);
+            /// \n Records a multi-draw of several meshes sharing the current material & lights.
+            /// @param firstDraw - int: the entry of the instance buffer holding the first mesh's transform.
+            void DrawMeshes(Mesh3D* const* meshes, int drawCount, int firstDraw);
+
+            [[nodiscard]] const std::vector<RenderCommand>& GetCommands() const { return commands;}
+            [[nodiscard]] Renderer* GetMaterial(uint32_t payload) const { return materials[payload];}
+            [[nodiscard]] const TransformBlock& GetTransform(uint32_t payload) const { return transforms[payload];}
+            [[nodiscard]] const LightBlock& GetLights(uint32_t payload) const { return lights[payload];}
+            [[nodiscard]] const DrawMeshCommand& GetDraw(uint32_t payload) const { return draws[payload];}
+            [[nodiscard]] const MultiDrawCommand& GetMultiDraw(uint32_t payload) const { return multiDraws[payload];}
+            /// \n Returns a mesh of a multi-draw (see MultiDrawCommand::firstMesh).
+            [[nodiscard]] Mesh3D* GetMultiDrawMesh(uint32_t index) const { return multiDrawMeshes[index];}
+            /// \n The amount of recorded commands.
+            [[nodiscard]] size_t Size() const { return commands.size();}
+        private:
+            std::vector<RenderCommand> commands = {};
+            std::vector<Renderer*> materials = {};
+            std::vector<TransformBlock> transforms = {};
+            std::vector<LightBlock> lights = {};
+            std::vector<DrawMeshCommand> draws = {};
+            std::vector<MultiDrawCommand> multiDraws = {};
+            /// \n The meshes of all multi-draws, back to back.
+            std::vector<Mesh3D*> multiDrawMeshes = {};
+        };
+    }
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include <OpenGL/OpenGlInclude.h>
+
+namespace EisEngine::rendering {
+    /// \n Refers to a texture or framebuffer declared in a RenderGraph. Only valid until the graph is executed.
+    using RenderResource = uint32_t;
+
+    /// \n The size & format of a transient texture.
+    struct RenderTargetDesc {
+        int width = 0;
+        int height = 0;
+        /// \n The sized internal format, e.g. GL_RGBA16F. Depth formats (GL_DEPTH_COMPONENT24, GL_DEPTH24_STENCIL8)
+        /// become the depth attachment of the passes writing them.
+        GLenum format = GL_RGBA8;
+
+        bool operator==(const RenderTargetDesc& other) const
+        { return width == other.width && height == other.height && format == other.format;}
+    };
+
+    /// \n Counters of the last executed RenderGraph.
+    struct RenderGraphStats {
+        /// \n The amount of passes declared.
+        size_t passes = 0;
+        /// \n The amount of passes skipped, as nothing drawn to the screen depended on their results.
+        size_t culledPasses = 0;
+        /// \n The amount of transient textures used by the executed passes.
+        size_t transientResources = 0;
+        /// \n The amount of pooled textures backing them; lower if resources with disjoint lifetimes were aliased.
+        size_t texturesUsed = 0;
+        /// \n The bytes the transient textures would take without aliasing.
+        size_t unaliasedBytes = 0;
+        /// \n The amount of textures in the pool, including those kept for later frames.
+        size_t pooledTextures = 0;
+        /// \n The bytes of GPU memory held by the pool.
+        size_t pooledBytes = 0;
+    };
+
+    class RenderGraph;
+
+    /// \n Declares the resources a pass accesses while it is added to a RenderGraph (see RenderGraph::AddPass).
+    class RenderPassBuilder {
+    public:
+        /// \n Declares a transient texture, attached to the pass's framebuffer. Its contents are undefined until
+        /// the pass clears or draws into it.
+        RenderResource Create(const std::string& name, const RenderTargetDesc& desc);
+        /// \n Draws into a resource, keeping its contents: a transient texture is attached to the pass's framebuffer,
+        /// an imported framebuffer is bound instead. Passes writing imported framebuffers are never culled.
+        RenderResource Write(RenderResource resource);
+        /// \n Declares that the pass samples or copies from a resource.
+        RenderResource Read(RenderResource resource);
+    private:
+        friend class RenderGraph;
+        RenderPassBuilder(RenderGraph& graph, size_t pass) : graph(graph), pass(pass) {}
+
+        RenderGraph& graph;
+        size_t pass;
+    };
+
+    /// \n A frame's passes declared with the resources they read & write, from which the graph derives what to run
+    /// & which memory to use:\n
+    /// - passes whose results neither reach an imported framebuffer nor another pass doing so are culled.\n
+    /// - the remaining passes run in declaration order, which defines the order of accesses to a resource.\n
+    /// - transient textures live from the first to the last pass using them & are taken from a pool kept across
+    /// frames. Resources of the same size & format whose lifetimes do not overlap share a texture, and pooled
+    /// textures unused for a few frames (e.g. after a resize or a change of technique) are deleted.\n
+    /// Before a pass runs, a framebuffer with its transient textures attached (or the imported framebuffer it
+    /// writes) is bound, with the viewport covering the textures (or the viewport the graph was executed with).
+    class RenderGraph {
+    public:
+        using ExecuteFunction = std::function<void(const RenderGraph&)>;
+
+        /// \n Adds a pass to the current frame.
+        /// @param setup - std::function: declares the resources of the pass, called immediately.
+        /// @param execute - ExecuteFunction: issues the pass's draws, called during Execute unless culled.
+        void AddPass(const std::string& name, const std::function<void(RenderPassBuilder&)>& setup,
+                     ExecuteFunction execute);
+        /// \n Declares a framebuffer owned outside of the graph, e.g. the window's or the scene target.
+        RenderResource ImportFramebuffer(const std::string& name, GLuint framebuffer);
+        /// \n Culls, allocates & runs the passes of the frame, then clears them for the next one. Restores the
+        /// viewport, but not the framebuffer binding.
+        void Execute();
+        /// \n Deletes the pooled textures & framebuffers, e.g. before the context is destroyed.
+        void Release();
+
+        /// \n The texture backing a transient resource while the passes run.
+        [[nodiscard]] GLuint GetTexture(RenderResource resource) const { return resources[resource].texture;}
+        /// \n The framebuffer of an imported resource.
+        [[nodiscard]] GLuint GetFramebuffer(RenderResource resource) const { return resources[resource].framebuffer;}
+        [[nodiscard]] const RenderGraphStats& GetStats() const { return stats;}
+    private:
+        friend class RenderPassBuilder;
+
+        /// \n A texture or framebuffer declared in the current frame.
+        struct Resource {
+            std::string name;
+            RenderTargetDesc desc;
+            bool imported = false;
+            GLuint framebuffer = 0;
+            /// \n The pooled texture assigned while the passes run, & its index in the pool.
+            GLuint texture = 0;
+            size_t pooled = 0;
+            /// \n The first & last executed pass using the resource.
+            size_t firstUse = SIZE_MAX;
+            size_t lastUse = 0;
+        };
+        /// \n A pass declared in the current frame.
+        struct Pass {
+            std::string name;
+            ExecuteFunction execute;
+            std::vector<RenderResource> reads = {};
+            /// \n The resources drawn into, in attachment order.
+            std::vector<RenderResource> writes = {};
+            /// \n The writes whose previous contents are kept (see RenderPassBuilder::Write).
+            std::vector<RenderResource> loads = {};
+            bool culled = false;
+        };
+        /// \n A texture kept across frames.
+        struct PooledTexture {
+            RenderTargetDesc desc;
+            GLuint texture = 0;
+            bool inUse = false;
+            /// \n The last frame the texture was used in.
+            uint64_t lastUse = 0;
+        };
+
+        /// \n Marks the passes nothing drawn to an imported framebuffer depends on.
+        void Cull();
+        /// \n Takes an unused pooled texture matching the resource's description, creating one if there is none.
+        void Acquire(Resource& resource);
+        /// \n Returns the framebuffer with the given textures attached, creating it on first use.
+        GLuint GetPassFramebuffer(const std::vector<RenderResource>& attachments);
+        /// \n Deletes the pooled textures unused for the given amount of frames & their framebuffers.
+        void Purge(uint64_t maxUnusedFrames);
+
+        std::vector<Resource> resources = {};
+        std::vector<Pass> passes = {};
+        std::vector<PooledTexture> pool = {};
+        /// \n Framebuffers by their attached textures, in attachment order.
+        std::map<std::vector<GLuint>, GLuint> framebuffers = {};
+        uint64_t frame = 0;
+        RenderGraphStats stats;
+    };
+}
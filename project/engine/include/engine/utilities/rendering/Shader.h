@@ -21,7 +21,19 @@ namespace EisEngine{
         NORMAL = 1,
         CUBEMAP = 2,
         DEPTH_BACK_FACE = 3,
-        DEPTH_FRONT_FACE = 4
+        DEPTH_FRONT_FACE = 4,
+        OIT_ACCUMULATION = 5,
+        OIT_REVEALAGE = 6
+    };
+
+    /// \n Optional features of the 3D shaders, each combination compiled into its own variant
+    /// (see ResourceManager::GetShaderVariant).
+    enum ShaderKeywords : uint32_t {
+        KEYWORDS_NONE = 0,
+        /// \n Perturbs the normals with a normal map ("NORMAL_MAP").
+        KEYWORD_NORMAL_MAP = 1 << 0,
+        /// \n Ambient light only, for meshes out of range of every loader ("UNLIT").
+        KEYWORD_UNLIT = 1 << 1
     };
 
     namespace rendering {
@@ -34,11 +46,15 @@ namespace EisEngine{
                     const unsigned int& fragmentShaderProgram,
                     const std::string& name
                 );
+            /// \n Takes ownership of an already created shader program, e.g. one loaded from a program binary.
+            explicit Shader(const unsigned int& program, const std::string& name);
             Shader(const Shader& other) = delete;
             Shader(Shader&& other) noexcept;
 
             /// \n Applies the shader to the rendering pipeline.
             void Apply(Camera* camera);
+            /// \n Makes the shader's program current, keeping all previously set uniforms.
+            void Use() const;
             /// \n Applies a texture to the rendering pipeline.
             void ApplyTexture2D(const Texture2D& texture, UniformSamplerIndices type) const;
             /// \n Applies a cubemap texture to the rendering pipeline.
@@ -64,6 +80,11 @@ namespace EisEngine{
             /// @param vec3 - a 3D-vector representing the new desired value.
             void setVector(const std::string &uniformName, glm::vec3 vec3) const;
 
+            /// \n Sets a given uniform vector in the shader program to the specified value.
+            /// @param uniformName - a string representing the name of the vector whose values are to be set.
+            /// @param vec2 - a 2D-vector representing the new desired value.
+            void setVector(const std::string &uniformName, glm::vec2 vec2) const;
+
             /// \n Sets a given uniform integer in the shader program to the specified value.
             /// @param uniformName - a string representing the name of the integer whose values are to be set.
             /// @param val - an int to take on the value of the given parameter.
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace EisEngine {
+    class ThreadPool;
+
+    namespace rendering {
+        /// \n The shading models implemented by the software rasterizer, matching the GLSL shaders of the same name.
+        enum class SoftwareShadingModel {
+            /// \n frag-sprite_unlit: diffuse color times texture.
+            Unlit,
+            /// \n frag-blinn_phong.
+            BlinnPhong,
+            /// \n frag-toon.
+            Toon
+        };
+
+        /// \n The per-frame shading inputs of the software rasterizer.
+        struct SoftwareShadingParameters {
+            SoftwareShadingModel model = SoftwareShadingModel::BlinnPhong;
+            glm::vec3 cameraPosition = glm::vec3(0.0f);
+            float ambient = 0.15f;
+            float specular = 1.0f;
+            int toonLevels = 8;
+        };
+
+        /// \n The material of a software-rasterized draw.
+        struct SoftwareMaterial {
+            glm::vec3 diffuse = glm::vec3(1.0f);
+            float alpha = 1.0f;
+            float tiling = 1.0f;
+            float roughness = 1.0f;
+            /// \n Samples the diffuse texture. If empty, the texture is white.
+            std::function<glm::vec4(const glm::vec2&)> texture;
+        };
+
+        /// \n A point light as seen by the software rasterizer.
+        struct SoftwareLight {
+            glm::vec3 position;
+            glm::vec3 emission;
+            float intensity;
+            /// \n Fragments farther away are not lit by this light.
+            float range;
+        };
+
+        /// \n A vertex after the vertex stage.
+        struct SoftwareVertex {
+            /// \n The position in clip space.
+            glm::vec4 clip;
+            /// \n The position in world space.
+            glm::vec3 position;
+            /// \n The normal in world space.
+            glm::vec3 normal;
+            glm::vec2 uv;
+        };
+
+        /// \n A multithreaded tile-based rasterizer drawing triangles into a CPU-side image.\n
+        /// Triangles are collected during a frame, then clipped, binned into screen tiles and rasterized
+        /// with one tile per task, evaluating edge functions for four pixels at a time.
+        /// Follows OpenGL conventions: the first row of the image is the bottom one, depth is tested with GL_LESS.
+        class SoftwareRasterizer {
+        public:
+            /// \n Creates a rasterizer drawing to an image of the given size.
+            explicit SoftwareRasterizer(int width = 1920, int height = 1080);
+
+            /// \n Changes the size of the image. Takes effect with the next frame.
+            void Resize(int width, int height);
+            /// \n Clears the image and starts collecting the triangles of a new frame.
+            void BeginFrame(const SoftwareShadingParameters& parameters, const glm::vec4& clearColor = glm::vec4(0, 0, 0, 1));
+            /// \n Registers a material for the current frame.
+            /// @return uint32_t: the material's id for DrawTriangles.
+            uint32_t AddMaterial(SoftwareMaterial material);
+            /// \n Registers a set of lights for the current frame.
+            /// @param count - int: the amount of lights, or -1 if lit by ambient light only.
+            /// @return uint32_t: the light set's id for DrawTriangles.
+            uint32_t AddLightSet(const SoftwareLight* lights, int count);
+            /// \n Queues triangles for the current frame.
+            /// @param meshVertices - std::vector&lt;SoftwareVertex>: the transformed vertices of the triangles.
+            /// @param indices - const unsigned int*: three vertex indices per triangle.
+            void DrawTriangles(const std::vector<SoftwareVertex>& meshVertices, const unsigned int* indices,
+                               size_t indexCount, uint32_t material, uint32_t lightSet);
+            /// \n Rasterizes all queued triangles of the frame.
+            /// @param pool - ThreadPool*: if set, setup and tiles are processed in parallel.
+            void Resolve(ThreadPool* pool);
+
+            [[nodiscard]] int GetWidth() const { return width;}
+            [[nodiscard]] int GetHeight() const { return height;}
+            /// \n The image as rows of RGBA8 pixels, bottom row first.
+            [[nodiscard]] const std::vector<uint32_t>& GetColorBuffer() const { return color;}
+            /// \n The amount of triangles rasterized in the last frame, after clipping.
+            [[nodiscard]] size_t GetTriangleCount() const { return triangles.size();}
+            /// \n Writes the image as a binary PPM file, e.g. for golden image comparisons.
+            /// @return bool: whether the file could be written.
+            bool WritePPM(const std::string& path) const;
+        private:
+            /// \n A queued triangle referring to the frame's vertices.
+            struct QueuedTriangle {
+                uint32_t vertices[3];
+                uint32_t material;
+                uint32_t lightSet;
+            };
+            /// \n The interpolated attributes of a triangle corner.
+            struct Varyings {
+                glm::vec3 position;
+                glm::vec3 normal;
+                glm::vec2 uv;
+            };
+            /// \n A clipped triangle in screen space, ready for rasterization.
+            struct SetupTriangle {
+                /// \n Plane equations of the barycentric coordinates: l[i] = a[i] * x + b[i] * y + c[i].
+                glm::vec3 a, b, c;
+                /// \n Window space depth and 1 / w of the three corners.
+                glm::vec3 z, invW;
+                /// \n Bounding box in pixels (inclusive).
+                int minX, minY, maxX, maxY;
+                /// \n The index of the first of the corners' three entries in the varyings.
+                uint32_t varyings;
+                uint32_t material;
+                uint32_t lightSet;
+            };
+            /// \n A range of the frame's lights. count is -1 for ambient light only.
+            struct LightSet {
+                uint32_t offset;
+                int count;
+            };
+
+            /// \n Clips a queued triangle against the near plane & appends the resulting screen space triangles.
+            void Setup(const QueuedTriangle& triangle, std::vector<SetupTriangle>& outTriangles,
+                       std::vector<Varyings>& outVaryings) const;
+            /// \n Rasterizes all triangles overlapping a tile.
+            void RasterizeTile(int tile);
+            /// \n Computes the color of a fragment.
+            [[nodiscard]] glm::vec4 Shade(const SetupTriangle& triangle, const glm::vec3& barycentric) const;
+
+            int width, height;
+            /// \n The row length of the color and depth buffers, padded to a multiple of four pixels.
+            int stride = 0;
+            int tilesX = 0, tilesY = 0;
+            SoftwareShadingParameters shading;
+            std::vector<uint32_t> color = {};
+            std::vector<float> depth = {};
+            std::vector<SoftwareMaterial> materials = {};
+            std::vector<SoftwareLight> lights = {};
+            std::vector<LightSet> lightSets = {};
+            std::vector<SoftwareVertex> vertices = {};
+            std::vector<QueuedTriangle> queued = {};
+            std::vector<SetupTriangle> triangles = {};
+            std::vector<Varyings> varyings = {};
+            /// \n Per tile, the indices of the overlapping triangles in submission order.
+            std::vector<std::vector<uint32_t>> bins = {};
+        };
+    }
+}
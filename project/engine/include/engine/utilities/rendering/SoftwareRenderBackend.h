@@ -0,0 +1,48 @@
+#pragma once
+
+#include <optional>
+#include "engine/utilities/rendering/RenderBackend.h"
+#include "engine/utilities/rendering/SoftwareRasterizer.h"
+
+namespace EisEngine {
+    class ThreadPool;
+
+    namespace rendering {
+        /// \n A backend drawing command lists into a CPU-side image with the SoftwareRasterizer,
+        /// e.g. for golden image tests or to measure shading cost without a GPU.\n
+        /// The shading model follows the active 3D shader; Cook-Torrance is approximated with Blinn-Phong.
+        /// Normal maps are not applied.
+        class SoftwareRenderBackend : public RenderBackend {
+        public:
+            /// \n Creates a software backend.
+            /// @param pool - ThreadPool*: the threads to rasterize with. If nullptr, the calling thread does all work.
+            explicit SoftwareRenderBackend(ThreadPool* pool);
+            SoftwareRenderBackend();
+
+            void BeginFrame(const FrameParameters& parameters) override;
+            /// \n Rasterizes everything submitted since BeginFrame.
+            void EndFrame() override;
+            void UploadInstances(const std::vector<InstanceData>& instances) override;
+            void Submit(const RenderCommandList& list, Shader* activeShader) override;
+
+            /// \n Overrides the shading model derived from the active 3D shader, e.g. to render unlit images.
+            void SetShadingModel(const std::optional<SoftwareShadingModel>& model) { shadingOverride = model;}
+            /// \n Sets the color of pixels not covered by any mesh.
+            void SetClearColor(const glm::vec4& color) { clearColor = color;}
+            /// \n The rasterizer holding the last frame's image.
+            [[nodiscard]] const SoftwareRasterizer& GetRasterizer() const { return rasterizer;}
+        private:
+            SoftwareRasterizer rasterizer;
+            ThreadPool* pool;
+            FrameParameters frame;
+            std::optional<SoftwareShadingModel> shadingOverride = std::nullopt;
+            glm::vec4 clearColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+            /// \n A copy of the last uploaded instance data.
+            std::vector<InstanceData> instances = {};
+            /// \n Scratch buffer for transformed vertices.
+            std::vector<SoftwareVertex> transformed = {};
+            /// \n The light set holding all of the frame's lights, used by objects lit per fragment.
+            uint32_t frameLightSet = 0;
+        };
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "engine/utilities/RadixSort.h"
+
+namespace EisEngine {
+    class ThreadPool;
+    class Texture2D;
+
+    namespace rendering {
+        class PrimitiveSpriteMesh;
+
+        /// \n A sprite vertex transformed to world (or screen) space, carrying its sprite's color.
+        struct BatchedSpriteVertex {
+            glm::vec3 position;
+            glm::vec2 uv;
+            /// \n RGBA8.
+            uint32_t color;
+        };
+
+        /// \n A range of the batched indices drawn with a single texture.
+        struct SpriteBatch {
+            Texture2D* texture;
+            uint32_t firstIndex;
+            uint32_t indexCount;
+        };
+
+        /// \n Collects sprites, sorts them and transforms their vertices on the CPU into a single vertex
+        /// and index array, so that consecutive sprites sharing a texture are drawn in a single draw call.
+        class SpriteBatcher {
+        public:
+            /// \n Packs a color with components within [0, 1] into the RGBA8 of the sprite vertices.
+            static uint32_t PackColor(const glm::vec4& color);
+            /// \n Clears the sprites of the previous frame.
+            void Begin();
+            /// \n Adds a sprite.
+            /// @param model - glm::mat4: the transformation applied to the sprite's vertices.
+            /// @param color - uint32_t: the RGBA8 color multiplied with the texture.
+            /// @param uvRect - glm::vec4: offset (xy) and scale (zw) applied to the mesh's texture coordinates,
+            /// e.g. to address a region of an atlas page.
+            void Add(const PrimitiveSpriteMesh& mesh, const glm::mat4& model, uint32_t color, Texture2D* texture,
+                     const glm::vec4& uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+            /// \n Sorts the sprites and fills the vertices, indices and batches.
+            /// @param sortByDepth - bool: if true, sprites are drawn back to front by their z position
+            /// (for drawing without a depth test), else they are only grouped by texture.
+            /// @param pool - ThreadPool*: if set, vertices are transformed in parallel.
+            void Build(bool sortByDepth, ThreadPool* pool);
+
+            [[nodiscard]] const std::vector<BatchedSpriteVertex>& GetVertices() const { return vertices;}
+            [[nodiscard]] const std::vector<uint32_t>& GetIndices() const { return indices;}
+            [[nodiscard]] const std::vector<SpriteBatch>& GetBatches() const { return batches;}
+            [[nodiscard]] size_t GetSpriteCount() const { return sprites.size();}
+        private:
+            /// \n A sprite added in the current frame.
+            struct Sprite {
+                const PrimitiveSpriteMesh* mesh;
+                glm::mat4 model;
+                glm::vec4 uvRect;
+                Texture2D* texture;
+                uint32_t color;
+                /// \n The index of the sprite's texture in the frame's textures.
+                uint32_t page;
+                /// \n The offsets of the sprite's vertices & indices in the output arrays.
+                uint32_t firstVertex;
+                uint32_t firstIndex;
+            };
+
+            /// \n Transforms the vertices & offsets the indices of a sprite into the output arrays.
+            void WriteSprite(const Sprite& sprite);
+
+            std::vector<Sprite> sprites = {};
+            /// \n The page of every texture used in the current frame.
+            std::unordered_map<Texture2D*, uint32_t> pages = {};
+            std::vector<SortEntry> order = {};
+            std::vector<SortEntry> sortScratch = {};
+            std::vector<BatchedSpriteVertex> vertices = {};
+            std::vector<uint32_t> indices = {};
+            std::vector<SpriteBatch> batches = {};
+        };
+    }
+}
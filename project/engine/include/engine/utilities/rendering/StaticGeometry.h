@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "engine/utilities/rendering/GeometryArena.h"
+
+namespace EisEngine::rendering {
+    /// \n A vertex of static mesh geometry, with all attributes interleaved.
+    struct StaticVertex {
+        glm::vec3 position;
+        glm::vec3 normal;
+        glm::vec2 uv;
+        glm::vec3 tangent;
+        glm::vec3 bitangent;
+    };
+
+    /// \n The vertices & indices of a mesh within the static geometry arenas.
+    struct StaticGeometryRange {
+        GeometryArena::Handle vertices = GeometryArena::INVALID_HANDLE;
+        GeometryArena::Handle indices = GeometryArena::INVALID_HANDLE;
+        /// \n GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, selecting the index arena.
+        GLenum indexType = GL_UNSIGNED_INT;
+    };
+
+    /// \n One of the commands read by glMultiDrawElementsIndirect, laid out as OpenGL expects it.
+    struct DrawElementsIndirectCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
+    /// \n Holds the geometry of all meshes in a few arenas - one for vertices, one for 16-bit & one for 32-bit
+    /// indices - so that every mesh is drawn from the same buffer objects: switching meshes only changes the offsets
+    /// of a draw, and draws of different meshes can be merged into a single multi-draw.\n
+    /// Indices are relative to the mesh's first vertex (see GetBaseVertex), so every mesh with fewer than 65536
+    /// vertices is stored with 16-bit indices, halving their memory & bandwidth.
+    class StaticGeometry {
+    public:
+        /// \n Uploads the geometry of a mesh, with 16-bit indices if possible.
+        static StaticGeometryRange Upload(const std::vector<StaticVertex>& vertices,
+                                          const std::vector<unsigned int>& indices);
+        /// \n Returns a mesh's memory to the arenas.
+        static void Release(const StaticGeometryRange& range);
+        /// \n The index of the mesh's first vertex within the vertex arena.
+        static GLint GetBaseVertex(const StaticGeometryRange& range);
+        /// \n The position of the mesh's first index within its index arena, counted in indices.
+        static GLuint GetFirstIndex(const StaticGeometryRange& range);
+        /// \n The size in bytes of an index of the given type.
+        static size_t GetIndexSize(GLenum indexType) { return indexType == GL_UNSIGNED_SHORT ? 2 : 4;}
+        /// \n Binds the vertex arena & the index arena of the given type, and points the vertex attributes of a shader
+        /// program (aPos, normal, texCoords, tan & bitan) to the vertex arena.
+        static void Bind(GLuint shaderProgram, GLenum indexType = GL_UNSIGNED_INT);
+        /// \n Compacts all arenas, e.g. after many meshes were released.
+        static void Defragment();
+
+        static const GeometryArena& GetVertexArena() { return vertexArena;}
+        static const GeometryArena& GetIndexArena(GLenum indexType) {
+            return indexType == GL_UNSIGNED_SHORT ? shortIndexArena : indexArena;
+        }
+    private:
+        static GeometryArena vertexArena;
+        static GeometryArena shortIndexArena;
+        static GeometryArena indexArena;
+    };
+}
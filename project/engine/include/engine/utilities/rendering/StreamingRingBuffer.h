@@ -0,0 +1,93 @@
+#pragma once
+
+#include <deque>
+#include <OpenGL/OpenGlInclude.h>
+
+namespace EisEngine::rendering {
+    /// \n Counters of a StreamingRingBuffer, accumulated until reset.
+    struct StreamingStats {
+        /// \n The amount of allocations made.
+        size_t allocations = 0;
+        /// \n The amount of bytes allocated, including alignment padding.
+        size_t bytes = 0;
+        /// \n The amount of times writing continued at the start of the buffer.
+        size_t wrapArounds = 0;
+        /// \n The amount of times an allocation had to wait for the GPU to finish reading older data.
+        size_t stalls = 0;
+        /// \n The amount of fences that were already signaled when their memory was needed again.
+        size_t fencesRetired = 0;
+        /// \n The amount of allocations that failed because the current frame alone filled the buffer.
+        size_t failedAllocations = 0;
+        /// \n The amount of bytes in use by frames still in flight after the last EndFrame.
+        size_t bytesInFlight = 0;
+    };
+
+    /// \n A region of a StreamingRingBuffer written by the CPU.
+    struct StreamingAllocation {
+        /// \n The persistently mapped memory to write to. nullptr if the allocation failed.
+        void* data = nullptr;
+        /// \n The allocation's offset in bytes from the start of the buffer object, e.g. for vertex attribute
+        /// pointers or glBindBufferRange.
+        GLintptr offset = 0;
+    };
+
+    /// \n A persistently mapped buffer object for data rewritten every frame (lines, sprites, instance data,
+    /// per-draw constants).\n
+    /// Allocations are handed out one after another, wrapping around at the end of the buffer. A fence is placed
+    /// at the end of every frame, so memory is only reused once the GPU finished reading it; by default the
+    /// buffer holds three frames of data, so the CPU only waits if it gets more than two frames ahead.
+    class StreamingRingBuffer {
+    public:
+        /// \n Creates and maps the buffer object. Requires a graphics context.
+        /// @param capacity - size_t: the size of the buffer in bytes.
+        explicit StreamingRingBuffer(size_t capacity);
+        ~StreamingRingBuffer();
+        StreamingRingBuffer(const StreamingRingBuffer&) = delete;
+        StreamingRingBuffer& operator=(const StreamingRingBuffer&) = delete;
+
+        /// \n Reserves memory for the current frame, waiting for the GPU if it still reads the memory of earlier
+        /// frames. Memory of the current frame is never reused, so the allocation fails if the frame filled the
+        /// buffer; callers skip the data then.
+        /// @param size - size_t: the amount of bytes to reserve.
+        /// @param alignment - size_t: the alignment of the returned offset, e.g. GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
+        /// @return StreamingAllocation: the reserved memory; its data is nullptr if the allocation failed.
+        StreamingAllocation Allocate(size_t size, size_t alignment = 16);
+        /// \n Copies data into the buffer.
+        /// @return StreamingAllocation: the memory the data was written to.
+        StreamingAllocation Write(const void* data, size_t size, size_t alignment = 16);
+        /// \n Marks the end of the commands reading the current frame's allocations.
+        void EndFrame();
+
+        /// \n The name of the buffer object to bind.
+        [[nodiscard]] GLuint GetBufferID() const { return buffer;}
+        [[nodiscard]] size_t GetCapacity() const { return capacity;}
+        [[nodiscard]] const StreamingStats& GetStats() const { return stats;}
+        /// \n Clears the counters, keeping the amount of bytes in flight.
+        void ResetStats();
+    private:
+        /// \n The end of a frame's commands and the amount of bytes they read.
+        struct Fence {
+            GLsync sync;
+            size_t bytes;
+        };
+
+        /// \n Places a fence behind the commands reading the allocations of the current frame.
+        void PushFence();
+        /// \n Waits for the oldest fence & releases its memory.
+        void RetireOldestFence();
+
+        GLuint buffer = 0;
+        /// \n The start of the persistently mapped memory.
+        unsigned char* mapped = nullptr;
+        size_t capacity;
+        /// \n The offset of the next allocation.
+        size_t head = 0;
+        /// \n The amount of bytes behind the head that may still be read by the GPU.
+        size_t used = 0;
+        /// \n The amount of bytes allocated since the last fence.
+        size_t pending = 0;
+        /// \n The fences of the frames in flight, oldest first.
+        std::deque<Fence> fences = {};
+        StreamingStats stats;
+    };
+}
@@ -1,12 +1,16 @@
 #pragma once
 
+#include <vector>
 #include <OpenGL/OpenGlInclude.h>
+#include <glm/glm.hpp>
 
 namespace EisEngine {
     class ResourceManager;
+    namespace rendering { class TextureAtlas;}
     /// \n A 2-dimensional texture. Is attached to a Renderer component to apply.
     class Texture2D {
         friend ResourceManager;
+        friend rendering::TextureAtlas;
     public:
         /// \n Binds the texture as the current active GL_TEXTURE_2D.
         void Bind() const;
@@ -15,6 +19,12 @@ namespace EisEngine {
         unsigned int Width;
         /// \n Texture height in pixels.
         unsigned int Height;
+
+        /// \n Samples the texture at the given coordinates (nearest neighbour, repeating).\n
+        /// Only available without a graphics context, where the image data is kept on the CPU. Returns white otherwise.
+        [[nodiscard]] glm::vec4 Sample(const glm::vec2& uv) const;
+        /// \n Reads the texture's image as rows of RGBA8 pixels, e.g. to copy it into a texture atlas.
+        [[nodiscard]] std::vector<unsigned char> ReadPixels() const;
     private:
         /// \n Creates a new texture object.
         Texture2D();
@@ -24,6 +34,11 @@ namespace EisEngine {
         /// @param height - unsigned int: the height of the texture in pixels
         /// @param data - unsigned char*: a pointer to the image data.
         void Generate(unsigned int width, unsigned int height, unsigned char* data);
+        /// \n Replaces a rectangle of the image & regenerates the mipmaps.
+        /// @param data - const unsigned char*: the pixels in the texture's image format, starting at the
+        /// rectangle's first pixel, in rows of rowLength pixels.
+        void UpdateRegion(unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+                          unsigned int rowLength, const unsigned char* data);
 
         /// \n the unique ID in the resource management system.
         unsigned int textureID;
@@ -41,5 +56,7 @@ namespace EisEngine {
         unsigned int minFilterMode;
         /// \n Filtering mode if texture cannot be fully displayed on screen (n(texture.pixels) > n(screen.pixels)
         unsigned int maxFilterMode;
+        /// \n A copy of the image data, only kept without a graphics context (see Sample).
+        std::vector<unsigned char> pixels = {};
     };
 }
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include <OpenGL/OpenGlInclude.h>
+
+namespace EisEngine {
+    class Texture2D;
+
+    namespace rendering {
+        /// \n The storage of a texture atlas' pages.
+        enum class AtlasMode {
+            /// \n Every page is a separate Texture2D; regions differ in texture & texture coordinates.
+            Pages,
+            /// \n All pages are layers of a single GL_TEXTURE_2D_ARRAY; regions differ in layer & texture coordinates.
+            ArrayLayers
+        };
+
+        /// \n The location of a packed texture within an atlas. Updated in place when the atlas is repacked.
+        struct AtlasRegion {
+            /// \n The page holding the texture (AtlasMode::Pages), else nullptr.
+            Texture2D* page = nullptr;
+            /// \n The index of the page (the array layer with AtlasMode::ArrayLayers).
+            int layer = 0;
+            /// \n Offset (xy) and scale (zw) mapping the texture's coordinates to the page's.
+            glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+            /// \n The texture's rectangle on the page in pixels, without padding.
+            int x = 0, y = 0, width = 0, height = 0;
+        };
+
+        /// \n Packs small textures into large pages, so that draws using different textures can share a texture
+        /// binding (and be batched).\n
+        /// Textures are packed incrementally as they are added; space freed by removed textures is reclaimed by
+        /// repacking, which happens automatically once a texture no longer fits. Every region is surrounded by
+        /// a border of repeated edge pixels to keep filtering (and coarser mip levels) from bleeding
+        /// into neighbours. Packed textures cannot repeat (tiling).
+        class TextureAtlas {
+        public:
+            /// \n Creates an empty atlas.
+            /// @param pageSize - int: the width & height of a page in pixels.
+            /// @param padding - int: the width of the border around every region in pixels.
+            explicit TextureAtlas(int pageSize = 2048, int padding = 4, AtlasMode mode = AtlasMode::Pages);
+            ~TextureAtlas();
+            TextureAtlas(const TextureAtlas&) = delete;
+            TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+            /// \n Packs a texture into the atlas.
+            /// @param source - const Texture2D*: the texture represented by the region (see Find).
+            /// @param rgba - const unsigned char*: the image as rows of RGBA8 pixels.
+            /// @return const AtlasRegion*: the texture's region, valid until removed. nullptr if it is larger than a page.
+            const AtlasRegion* Add(const Texture2D* source, int width, int height, const unsigned char* rgba);
+            /// \n Returns the region of a packed texture, or nullptr if it is not part of the atlas.
+            [[nodiscard]] const AtlasRegion* Find(const Texture2D* source) const;
+            /// \n Removes a texture from the atlas. Its space is reclaimed with the next repack.
+            void Remove(const Texture2D* source);
+            /// \n Packs all textures anew, from largest to smallest, & redraws the pages.
+            void Repack();
+            /// \n Uploads the modified parts of the pages & regenerates their mipmaps.
+            void Flush();
+            /// \n Removes all textures and pages.
+            void Clear();
+
+            /// \n Binds the array texture holding all pages (AtlasMode::ArrayLayers) to GL_TEXTURE_2D_ARRAY.
+            void BindArray() const;
+            [[nodiscard]] AtlasMode GetMode() const { return mode;}
+            [[nodiscard]] int GetPageSize() const { return pageSize;}
+            [[nodiscard]] size_t GetPageCount() const { return pages.size();}
+            [[nodiscard]] size_t GetRegionCount() const { return entries.size();}
+        private:
+            /// \n A packed texture & the copy of its image used for repacking.
+            struct Entry {
+                AtlasRegion region;
+                std::vector<unsigned char> pixels;
+            };
+            /// \n A page, its packing state & its CPU-side image.
+            struct Page;
+
+            /// \n Tries to pack a texture into one of the existing pages.
+            bool Place(Entry& entry);
+            /// \n Copies an entry's image into its page, extruding the edges into the padding.
+            void Blit(const Entry& entry);
+            /// \n Appends an empty page.
+            Page& AddPage();
+
+            int pageSize;
+            int padding;
+            AtlasMode mode;
+            /// \n The packed textures. A map, so that regions keep their addresses.
+            std::map<const Texture2D*, Entry> entries = {};
+            std::vector<std::unique_ptr<Page>> pages;
+            /// \n Whether textures were removed since the last repack.
+            bool fragmented = false;
+            /// \n The array texture holding all pages (AtlasMode::ArrayLayers).
+            GLuint arrayTexture = 0;
+            /// \n The amount of layers allocated for the array texture.
+            size_t arrayLayers = 0;
+        };
+    }
+}
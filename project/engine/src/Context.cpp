@@ -1,15 +1,23 @@
+#include <chrono>
 #include <stdexcept>
+#include <thread>
 #include <gui/imgui.h>
 #include <gui/imgui_impl_glfw.h>
 #include <gui/imgui_impl_opengl3.h>
 
 #include "engine/Context.h"
 #include "engine/utilities/Debug.h"
+#include "engine/utilities/rendering/GLStateCache.h"
+#include "engine/utilities/rendering/FrameReadback.h"
 
 namespace EisEngine::ctx {
     Color Context::m_clearColor = Color::black;
+    bool Context::graphicsAvailable = false;
+    GLuint Context::defaultFramebuffer = 0;
 
-    void framebuffer_size_callback(GLFWwindow *window, int width, int height) { glViewport(0, 0, width, height);}
+    void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
+        rendering::GLStateCache::Viewport(0, 0, width, height);
+    }
 
     void Context::InitializeGLFW() {
         if(!glfwInit())
@@ -33,12 +41,76 @@ namespace EisEngine::ctx {
         glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     }
 
+    void Context::createOffscreenContext(const std::string &title) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        // EGL & OSMesa create contexts without a display; the native API is the fallback on desktops.
+        for(auto api : {GLFW_EGL_CONTEXT_API, GLFW_OSMESA_CONTEXT_API, GLFW_NATIVE_CONTEXT_API}){
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, api);
+            window = glfwCreateWindow((int) headlessSize.x, (int) headlessSize.y, title.c_str(), nullptr, nullptr);
+            if(window)
+                break;
+        }
+
+        if(window == nullptr)
+            DEBUG_RUNTIME_ERROR("GL Error - Failed to create an offscreen context.");
+
+        glfwMakeContextCurrent(window);
+        // frames are not presented, so they are never synchronized to a display.
+        glfwSwapInterval(0);
+    }
+
+    void Context::InitOffscreenTarget() {
+        ReleaseOffscreenTarget();
+        offscreenSize = headlessSize;
+        auto width = (GLsizei) offscreenSize.x;
+        auto height = (GLsizei) offscreenSize.y;
+
+        glGenRenderbuffers(1, &offscreenColor);
+        glBindRenderbuffer(GL_RENDERBUFFER, offscreenColor);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glGenRenderbuffers(1, &offscreenDepth);
+        glBindRenderbuffer(GL_RENDERBUFFER, offscreenDepth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glGenFramebuffers(1, &defaultFramebuffer);
+        rendering::GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, defaultFramebuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, offscreenColor);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, offscreenDepth);
+        if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            DEBUG_RUNTIME_ERROR("GL Error - Offscreen framebuffer is incomplete.")
+        rendering::GLStateCache::Viewport(0, 0, width, height);
+        // keeps ImGui's display size in line with the offscreen resolution.
+        glfwSetWindowSize(window, width, height);
+        DEBUG_OPENGL("Offscreen Target")
+    }
+
+    void Context::ReleaseOffscreenTarget() {
+        if(defaultFramebuffer == 0)
+            return;
+        rendering::GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &defaultFramebuffer);
+        glDeleteRenderbuffers(1, &offscreenColor);
+        glDeleteRenderbuffers(1, &offscreenDepth);
+        defaultFramebuffer = 0;
+        offscreenColor = 0;
+        offscreenDepth = 0;
+    }
+
+    void Context::SetFrameCallback(std::function<void(const rendering::CapturedFrame &)> callback) {
+        if(!graphicsAvailable || mode != ContextMode::Offscreen)
+            return;
+        if(readback)
+            readback->Flush();
+        readback = callback ? std::make_unique<rendering::FrameReadback>(std::move(callback)) : nullptr;
+    }
+
     void Context::LoadGLAD() {
         gladLoadGLLoader((GLADloadproc) glfwGetProcAddress);
         if(glGetError() != GL_NO_ERROR)
             DEBUG_RUNTIME_ERROR("GL Error - Failed to load GLAD")
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        rendering::GLStateCache::Enable(GL_BLEND);
+        rendering::GLStateCache::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     }
 
     void Context::LoadImGUI() {
@@ -116,21 +188,59 @@ namespace EisEngine::ctx {
     }
 #pragma endregion
 
-    Context::Context(const std::string &title) {
-        InitializeGLFW();
-        createWindow(title);
+    Context::Context(const std::string &title, ContextMode mode) : mode(mode) {
+        if(mode == ContextMode::Headless || mode == ContextMode::Simulation)
+            return;
+
+        if(mode == ContextMode::Offscreen){
+#ifdef GLFW_PLATFORM_NULL
+            // the null platform needs no display server.
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
+            InitializeGLFW();
+            createOffscreenContext(title);
+        }
+        else{
+            InitializeGLFW();
+            createWindow(title);
+        }
         LoadGLAD();
         LoadImGUI();
         glEnable(GL_DEBUG_OUTPUT);
         glDebugMessageCallback(GLDebugCallback, nullptr);
+        graphicsAvailable = true;
+        if(mode == ContextMode::Offscreen)
+            InitOffscreenTarget();
     }
 
     void Context::run(const Context::Callback& update) {
+        if(!window){
+            // without a display to wait for, frames are only paced by the frame rate limit.
+            auto nextFrame = std::chrono::steady_clock::now();
+            while(!closeRequested){
+                TimedUpdate(update);
+                if(frameRateLimit <= 0.0)
+                    continue;
+                nextFrame += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(1.0 / frameRateLimit));
+                // a frame running late does not make the following ones catch up.
+                auto now = std::chrono::steady_clock::now();
+                if(nextFrame < now)
+                    nextFrame = now;
+                std::this_thread::sleep_until(nextFrame);
+            }
+            return;
+        }
+        if(mode == ContextMode::Offscreen){
+            runOffscreen(update);
+            return;
+        }
+
         glfwSetTime(1.0 / 60);
         while(!glfwWindowShouldClose(window)) {
             glClearColor(m_clearColor.r, m_clearColor.g, m_clearColor.b, m_clearColor.a);
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-            update(*this);
+            TimedUpdate(update);
             glfwPollEvents();
             glfwSwapBuffers(window);
         }
@@ -140,7 +250,42 @@ namespace EisEngine::ctx {
         ImGui::DestroyContext();
     }
 
+    void Context::runOffscreen(const Context::Callback &update) {
+        glfwSetTime(1.0 / 60);
+        while(!closeRequested && !glfwWindowShouldClose(window)) {
+            if(offscreenSize != headlessSize)
+                InitOffscreenTarget();
+            rendering::GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, defaultFramebuffer);
+            rendering::GLStateCache::Viewport(0, 0, (GLsizei) offscreenSize.x, (GLsizei) offscreenSize.y);
+            glClearColor(m_clearColor.r, m_clearColor.g, m_clearColor.b, m_clearColor.a);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            TimedUpdate(update);
+            glfwPollEvents();
+            // instead of presenting, the frame is read back while the next ones are rendered.
+            if(readback){
+                readback->Capture(defaultFramebuffer, (int) offscreenSize.x, (int) offscreenSize.y);
+                readback->Collect();
+            }
+        }
+        if(readback)
+            readback->Flush();
+        // Cleanup ImGui
+        ImGui_ImplOpenGL3_Shutdown();
+        ImGui_ImplGlfw_Shutdown();
+        ImGui::DestroyContext();
+    }
+
+    void Context::TimedUpdate(const Context::Callback &update) {
+        auto start = std::chrono::steady_clock::now();
+        update(*this);
+        updateTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
     Context::~Context() {
-        glfwTerminate();
+        readback.reset();
+        if(window){
+            ReleaseOffscreenTarget();
+            glfwTerminate();
+        }
     }
 }
\ No newline at end of file
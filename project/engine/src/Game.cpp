@@ -1,14 +1,15 @@
 #include "engine/Game.h"
 #include "engine/Systems.h"
+#include "engine/utilities/rendering/GLStateCache.h"
 
 namespace EisEngine {
     using ctx::Context;
     using ecs::ComponentManager;
     using ecs::EntityManager;
 
-    Game::Game(const std::string &title): context(title), componentManager(*this),
+    Game::Game(const std::string &title, ctx::ContextMode mode): context(title, mode), componentManager(*this),
     entityManager(componentManager, *this), camera(*this, context.GetWindowSize()),
-    renderingSystem(*this), sceneGraphPruner(*this), sceneGraphUpdater(*this), physics(*this),
+    renderingSystem(*this), sceneGraphPruner(*this), sceneGraphUpdater(*this), sceneIndex(*this), physics(*this),
     physicsUpdater(*this), input(*this), time(*this)
     { origin = entityManager.createEntity("origin").transform;}
 
@@ -25,7 +26,8 @@ namespace EisEngine {
     void Game::run() {
         onStartup.invoke(*this);
         start();
-        glEnable(GL_DEPTH_TEST);
+        if(Context::HasGraphics())
+            rendering::GLStateCache::Enable(GL_DEPTH_TEST);
         onAfterStartup.invoke(*this);
         context.run([&](Context &ctx){GameLoop();});
 
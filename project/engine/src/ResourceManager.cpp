@@ -2,17 +2,35 @@
 #include "engine/ResourceManager.h"
 #include "engine/Components.h"
 #include "engine/utilities/Debug.h"
-
+#include "engine/utilities/ThreadPool.h"
+#include "engine/utilities/rendering/RenderCommandList.h"
+#include "engine/utilities/rendering/GLStateCache.h"
+#include "engine/utilities/rendering/MeshOptimizer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <unordered_set>
 #include <stb_image.h>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+// the largest width & height of a texture packed into the atlas in pixels.
+#define MAX_ATLAS_TEXTURE_SIZE 512
+
 namespace EisEngine {
     std::map<std::string, std::unique_ptr<Texture2D>> ResourceManager::Textures = {};
     std::map<std::string, std::unique_ptr<Cubemap>> ResourceManager::Cubemaps = {};
     std::map<std::string, std::unique_ptr<Material>> ResourceManager::Materials = {};
     std::map<std::string, std::unique_ptr<Shader>> ResourceManager::Shaders = {};
+    std::map<std::string, ShaderSource> ResourceManager::ShaderSources = {};
+    rendering::ProgramBinaryCache ResourceManager::ProgramCache;
+    std::vector<ResourceManager::PendingProgram> ResourceManager::PendingPrograms = {};
+    std::map<std::string, ResourceManager::CompiledStage> ResourceManager::CompiledStages = {};
+    int ResourceManager::ShaderBatchDepth = 0;
+    std::chrono::steady_clock::time_point ResourceManager::ShaderBatchStart = {};
+    ShaderLoadStats ResourceManager::ShaderStats = {};
+    rendering::TextureAtlas ResourceManager::Atlas;
     Assimp::Importer importer;
 
     Vector3 GetAveragePos(const std::vector<Vector3>& v){
@@ -24,9 +42,33 @@ namespace EisEngine {
         return res;
     }
 
+    // inserts the engine constants & the given defines after the #version directive, which has to stay first.
+    std::string InjectDefines(const std::string& source, const std::vector<std::string>& defines){
+        auto version = source.find("#version");
+        auto lineEnd = version == std::string::npos ? std::string::npos : source.find('\n', version);
+        if(lineEnd == std::string::npos)
+            return source;
+        lineEnd++;
+
+        std::string header = "#define MAX_LIGHTS " + std::to_string(MAX_LIGHTS) + "\n";
+        for(const auto& define : defines)
+            header += "#define " + define + "\n";
+        // keep the line numbers of compiler messages pointing into the file.
+        auto nextLine = std::count(source.begin(), source.begin() + (long) lineEnd, '\n') + 1;
+        header += "#line " + std::to_string(nextLine) + "\n";
+        return source.substr(0, lineEnd) + header + source.substr(lineEnd);
+    }
+
 #pragma region 3D asset import
-    /// \n Imports mesh data (vertices, normals, indices and UVs) from an assimp mesh.
-    PrimitiveMesh3D ImportMesh(const aiMesh* mesh){
+    /// \n The GPU efficiency of an imported mesh before & after its optimization, for the import log.
+    struct MeshImportReport {
+        rendering::MeshEfficiency before;
+        rendering::MeshEfficiency after;
+    };
+
+    /// \n Imports mesh data (vertices, normals, indices and UVs) from an assimp mesh, reorders it for the GPU
+    /// (vertex cache, overdraw, then vertex fetch; see MeshOptimizer.h) and generates its simplified levels of detail.
+    PrimitiveMesh3D ImportMesh(const aiMesh* mesh, MeshImportReport& report){
         auto nVerts = mesh->mNumVertices;
         // vertex collection -> take aiMesh's array of vertices and convert to own format of Vec3's
         std::vector<Vector3> vertices(mesh->mVertices, mesh->mVertices + nVerts);
@@ -73,7 +115,24 @@ namespace EisEngine {
             bitans.emplace_back(bitan);
         }
 
-        return PrimitiveMesh3D(
+        // the faces come in authoring order; reorder the triangles for the post-transform cache & for early depth
+        // rejection, then the vertices in the order the triangles use them.
+        auto positions = Vec3VectorToGlm(vertices);
+        report.before.acmr = rendering::AnalyzeVertexCache(indices, nVerts);
+        report.before.overdraw = rendering::AnalyzeOverdraw(positions, indices);
+        indices = rendering::OptimizeVertexCache(indices, nVerts);
+        indices = rendering::OptimizeOverdraw(positions, indices);
+        auto remap = rendering::OptimizeVertexFetch(indices, nVerts);
+        vertices = rendering::RemapVertices(vertices, remap);
+        normals = rendering::RemapVertices(normals, remap);
+        uvs = rendering::RemapVertices(uvs, remap);
+        tans = rendering::RemapVertices(tans, remap);
+        bitans = rendering::RemapVertices(bitans, remap);
+        positions = rendering::RemapVertices(positions, remap);
+        report.after.acmr = rendering::AnalyzeVertexCache(indices, nVerts);
+        report.after.overdraw = rendering::AnalyzeOverdraw(positions, indices);
+
+        auto primitive = PrimitiveMesh3D(
                 vertices,
                 indices,
                 &normals,
@@ -81,10 +140,13 @@ namespace EisEngine {
                 &tans,
                 &bitans
             );
+        primitive.GenerateLODs();
+        return primitive;
     }
 
-    void ResourceManager::ImportNode(Game& game, const aiNode* node,
-                                     const aiScene* scene, const fs::path& modelPath, Entity* parent){
+    void ResourceManager::ImportNode(Game& game, const aiNode* node, const aiScene* scene,
+                                     const std::vector<std::unique_ptr<PrimitiveMesh3D>>& primitives,
+                                     const fs::path& modelPath, Entity* parent){
         // if no meshes or children, return
         if(node->mNumMeshes == 0 && node->mNumChildren == 0)
             return;
@@ -113,11 +175,11 @@ namespace EisEngine {
             auto mesh = scene->mMeshes[index];
 
             // Safety check — skip non-triangular or non-vertex meshes
-            if (!mesh->HasPositions() || mesh->mNumVertices == 0)
+            if (!primitives[index])
                 continue;
 
             // get mesh data as primitiveMesh
-            auto primitive = ImportMesh(mesh);
+            const auto& primitive = *primitives[index];
 
             // get texture & material data
             auto assimpMaterial = scene->mMaterials[mesh->mMaterialIndex];
@@ -133,7 +195,7 @@ namespace EisEngine {
 
         // import all child nodes recursively
         for(unsigned int i = 0; i < node->mNumChildren; i++)
-            ImportNode(game, node->mChildren[i], scene, modelPath, &nodeEntity);
+            ImportNode(game, node->mChildren[i], scene, primitives, modelPath, &nodeEntity);
     }
 
     ecs::Entity* ResourceManager::Load3DObject(Game& game, const fs::path &path) {
@@ -161,9 +223,33 @@ namespace EisEngine {
             return nullptr;
         }
 
+        // convert all meshes up front; as this does not touch the GL context, it runs on worker threads.
+        std::vector<std::unique_ptr<PrimitiveMesh3D>> primitives(scene->mNumMeshes);
+        std::vector<MeshImportReport> reports(scene->mNumMeshes);
+        ThreadPool::Global().ParallelFor(scene->mNumMeshes, [&](size_t begin, size_t end){
+            for(auto i = begin; i < end; i++){
+                auto mesh = scene->mMeshes[i];
+                // Safety check — skip non-triangular or non-vertex meshes
+                if (!mesh->HasPositions() || mesh->mNumVertices == 0)
+                    continue;
+                primitives[i] = std::make_unique<PrimitiveMesh3D>(ImportMesh(mesh, reports[i]));
+            }
+        });
+        for(auto i = 0; i < scene->mNumMeshes; i++){
+            if(!primitives[i])
+                continue;
+            const auto& report = reports[i];
+            char efficiency[128];
+            std::snprintf(efficiency, sizeof(efficiency), "ACMR %.2f -> %.2f, overdraw %.2f -> %.2f",
+                          report.before.acmr, report.after.acmr, report.before.overdraw, report.after.overdraw);
+            auto indexBits = scene->mMeshes[i]->mNumVertices < 65536 ? "16" : "32";
+            DEBUG_LOG("Optimized mesh '" + std::string(scene->mMeshes[i]->mName.C_Str()) + "': " + efficiency +
+                      ", " + indexBits + "-bit indices.")
+        }
+
         // recursively import data following the aiScene graph.
         auto& rootEntity = game.entityManager.createEntity(path.filename().string());
-        ImportNode(game, scene->mRootNode, scene, path.parent_path(), &rootEntity);
+        ImportNode(game, scene->mRootNode, scene, primitives, path.parent_path(), &rootEntity);
 
         // return the resulting entity.
         return &rootEntity;
@@ -391,6 +477,21 @@ namespace EisEngine {
 
         return Textures[name].get();
     }
+    const rendering::AtlasRegion *ResourceManager::PackIntoAtlas(const std::string &textureName) {
+        auto texture = GetTexture(textureName);
+        if(!texture){
+            DEBUG_ERROR("Cannot pack missing texture " + textureName + " into the atlas.")
+            return nullptr;
+        }
+        if(texture->Width > MAX_ATLAS_TEXTURE_SIZE || texture->Height > MAX_ATLAS_TEXTURE_SIZE){
+            DEBUG_WARN("Texture " + textureName + " is too large to be packed into the atlas.")
+            return nullptr;
+        }
+        auto pixels = texture->ReadPixels();
+        return Atlas.Add(texture, (int) texture->Width, (int) texture->Height, pixels.data());
+    }
+
+    void ResourceManager::RemoveFromAtlas(const std::string &textureName) { Atlas.Remove(GetTexture(textureName));}
 #pragma endregion
 
 #pragma region Cubemap handling
@@ -460,18 +561,64 @@ namespace EisEngine {
 #pragma endregion
 
 #pragma region Shader handling
+    // lets the driver compile shaders on background threads, if supported.
+    void EnableParallelShaderCompilation(){
+        using MaxShaderCompilerThreads = void (APIENTRY*)(GLuint);
+        MaxShaderCompilerThreads maxThreads = nullptr;
+        if(glfwExtensionSupported("GL_KHR_parallel_shader_compile"))
+            maxThreads = (MaxShaderCompilerThreads) glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+        else if(glfwExtensionSupported("GL_ARB_parallel_shader_compile"))
+            maxThreads = (MaxShaderCompilerThreads) glfwGetProcAddress("glMaxShaderCompilerThreadsARB");
+        // the largest value lets the driver pick the amount of threads.
+        if(maxThreads)
+            maxThreads(0xFFFFFFFF);
+    }
+
     Shader *ResourceManager::GenerateShaderFromFiles(const fs::path &vertexShaderPath,
                                                      const fs::path &fragmentShaderPath,
-                                                     const std::string &shaderName) {
-        if(Shaders[shaderName] == nullptr)
-            Shaders[shaderName] = std::make_unique<Shader>(
-                    loadAndCompileShader(GL_VERTEX_SHADER, vertexShaderPath),
-                    loadAndCompileShader(GL_FRAGMENT_SHADER, fragmentShaderPath),
-                    shaderName
-            );
+                                                     const std::string &shaderName,
+                                                     const std::vector<std::string> &defines) {
+        // shaders cannot be compiled without a graphics context.
+        if(!ctx::Context::HasGraphics())
+            return nullptr;
+        auto& source = ShaderSources[shaderName] = {vertexShaderPath, fragmentShaderPath, defines};
+        if(Shaders[shaderName] == nullptr){
+            BeginShaderBatch();
+            Shaders[shaderName] = CreateProgram(shaderName, source);
+            EndShaderBatch();
+        }
         return GetShader(shaderName);
     }
 
+    Shader *ResourceManager::GetShaderVariant(const std::string &shaderName, const std::vector<std::string> &keywords) {
+        if(keywords.empty())
+            return GetShader(shaderName);
+        auto source = ShaderSources.find(shaderName);
+        if(source == ShaderSources.end()){
+            DEBUG_WARN("Cannot create a variant of unknown shader [" + shaderName + "].")
+            return nullptr;
+        }
+
+        // the same set of defines maps to the same variant, regardless of order & duplicates.
+        auto variantSource = source->second;
+        auto& defines = variantSource.defines;
+        defines.insert(defines.end(), keywords.begin(), keywords.end());
+        std::sort(defines.begin(), defines.end());
+        defines.erase(std::unique(defines.begin(), defines.end()), defines.end());
+        auto key = shaderName + " [";
+        for(size_t i = 0; i < defines.size(); i++)
+            key += (i > 0 ? " " : "") + defines[i];
+        key += "]";
+
+        auto& variant = Shaders[key];
+        if(variant == nullptr){
+            BeginShaderBatch();
+            variant = CreateProgram(key, variantSource);
+            EndShaderBatch();
+        }
+        return variant.get();
+    }
+
     Shader *ResourceManager::GetShader(const std::string &name) {
         if(Shaders.empty()){
             DEBUG_WARN("No shaders created in resource manager system.")
@@ -480,35 +627,137 @@ namespace EisEngine {
         return Shaders[name].get();
     }
 
-    unsigned int ResourceManager::loadAndCompileShader(GLuint shaderType, const fs::path &filePath) {
-        auto shaderID = glCreateShader(shaderType);
-        auto shaderSource = ReadText(filePath);
-        auto source = shaderSource.c_str();
-        glShaderSource(shaderID, 1, &source, nullptr);
-        glCompileShader(shaderID);
+    void ResourceManager::BeginShaderBatch() {
+        if(ShaderBatchDepth++ > 0)
+            return;
+        static auto parallelCompilation = false;
+        if(!parallelCompilation && ctx::Context::HasGraphics()){
+            EnableParallelShaderCompilation();
+            parallelCompilation = true;
+        }
+        ShaderBatchStart = std::chrono::steady_clock::now();
+    }
 
-        glStatusData compilationStatus{};
-        compilationStatus.shaderName = shaderType == GL_VERTEX_SHADER ? "Vertex" : "Fragment";
-        glGetShaderiv(shaderID, GL_COMPILE_STATUS, &compilationStatus.success);
-        if(compilationStatus.success == GL_FALSE) {
-            glGetShaderInfoLog(shaderID, GL_INFO_LOG_LENGTH, nullptr, compilationStatus.infoLog);
-            DEBUG_RUNTIME_ERROR( std::string(compilationStatus.shaderName) + " shader compilation failed.\n" +
-                                 std::string(compilationStatus.infoLog) + "\nPath: " + filePath.string())
+    void ResourceManager::EndShaderBatch() {
+        if(--ShaderBatchDepth > 0)
+            return;
+
+        // querying a status waits for that object only, the others keep compiling in the meantime.
+        // errors are collected & raised once the batch is cleaned up, so that a caught error leaks nothing.
+        std::string errors;
+        std::unordered_set<GLuint> failedStages = {};
+        for(const auto& [source, stage] : CompiledStages){
+            auto error = CheckCompileStatus(stage);
+            if(error.empty())
+                continue;
+            errors += error + "\n";
+            failedStages.insert(stage.id);
         }
+        for(const auto& pending : PendingPrograms){
+            glDetachShader(pending.program, pending.vertexShader);
+            glDetachShader(pending.program, pending.fragmentShader);
+            auto failed = failedStages.count(pending.vertexShader) > 0 ||
+                          failedStages.count(pending.fragmentShader) > 0;
+            if(!failed){
+                glStatusData linkStatus{};
+                linkStatus.shaderName = pending.name.c_str();
+                glGetProgramiv(pending.program, GL_LINK_STATUS, &linkStatus.success);
+                if(linkStatus.success == GL_FALSE){
+                    glGetProgramInfoLog(pending.program, GL_INFO_LOG_LENGTH, nullptr, linkStatus.infoLog);
+                    errors += "Shader [" + pending.name + "] linking failed.\n" +
+                              std::string(linkStatus.infoLog) + "\n";
+                    failed = true;
+                }
+            }
+            if(failed){
+                // drop the shader wrapping the unusable program, so that it is never bound.
+                Shaders.erase(pending.name);
+                glDeleteProgram(pending.program);
+                continue;
+            }
+            ProgramCache.Store(pending.program, pending.key);
+        }
+        for(const auto& [source, stage] : CompiledStages)
+            glDeleteShader(stage.id);
+        PendingPrograms.clear();
+        CompiledStages.clear();
+
+        ShaderStats.milliseconds += std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - ShaderBatchStart).count();
+        if(!errors.empty())
+            DEBUG_RUNTIME_ERROR(errors)
+    }
+
+    std::unique_ptr<Shader> ResourceManager::CreateProgram(const std::string &name, const ShaderSource &source) {
+        auto vertexSource = InjectDefines(ReadText(source.vertexPath), source.defines);
+        auto fragmentSource = InjectDefines(ReadText(source.fragmentPath), source.defines);
+        auto key = ProgramCache.MakeKey(vertexSource, fragmentSource);
+        auto program = glCreateProgram();
+        ShaderStats.programs++;
+        if(ProgramCache.Load(program, key)){
+            ShaderStats.cachedPrograms++;
+            return std::make_unique<Shader>(program, name);
+        }
+
+        // compile & link without querying any status, which would wait for the driver.
+        PendingProgram pending{program,
+                               loadAndCompileShader(GL_VERTEX_SHADER, source.vertexPath, vertexSource),
+                               loadAndCompileShader(GL_FRAGMENT_SHADER, source.fragmentPath, fragmentSource),
+                               key, name};
+        glAttachShader(program, pending.vertexShader);
+        glAttachShader(program, pending.fragmentShader);
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glLinkProgram(program);
+        PendingPrograms.push_back(std::move(pending));
+        return std::make_unique<Shader>(program, name);
+    }
 
-        return shaderID;
+    unsigned int ResourceManager::loadAndCompileShader(GLuint shaderType, const fs::path &filePath,
+                                                       const std::string &source) {
+        // stages are shared by the programs of a batch, e.g. the vertex shader of all 3D shaders.
+        auto& stage = CompiledStages[std::to_string(shaderType) + source];
+        if(stage.id != 0)
+            return stage.id;
+
+        stage = {glCreateShader(shaderType), filePath};
+        auto text = source.c_str();
+        glShaderSource(stage.id, 1, &text, nullptr);
+        glCompileShader(stage.id);
+        return stage.id;
+    }
+
+    std::string ResourceManager::CheckCompileStatus(const CompiledStage &stage) {
+        GLint type = 0;
+        glGetShaderiv(stage.id, GL_SHADER_TYPE, &type);
+        glStatusData compilationStatus{};
+        compilationStatus.shaderName = type == (GLint) GL_VERTEX_SHADER ? "Vertex" : "Fragment";
+        glGetShaderiv(stage.id, GL_COMPILE_STATUS, &compilationStatus.success);
+        if(compilationStatus.success != GL_FALSE)
+            return {};
+        glGetShaderInfoLog(stage.id, GL_INFO_LOG_LENGTH, nullptr, compilationStatus.infoLog);
+        return std::string(compilationStatus.shaderName) + " shader compilation failed.\n" +
+               std::string(compilationStatus.infoLog) + "\nPath: " + stage.path.string();
     }
 #pragma endregion
 
     std::string ResourceManager::ReadText(const fs::path &path) {
-        std::ifstream sourceFile(resolveAssetPath(path));
-        std::stringstream buffer;
-        buffer << sourceFile.rdbuf();
-        return buffer.str();
+        // read at once, sized by the file, instead of streaming through a stringstream.
+        std::ifstream sourceFile(resolveAssetPath(path), std::ios::binary | std::ios::ate);
+        if(!sourceFile)
+            return {};
+        std::string text((size_t) sourceFile.tellg(), '\0');
+        sourceFile.seekg(0);
+        sourceFile.read(text.data(), (std::streamsize) text.size());
+        return text;
     }
 
     void ResourceManager::Clear(){
-        for (auto it = Textures.begin(); it != Textures.end(); ++it)
+        Atlas.Clear();
+        if(!ctx::Context::HasGraphics())
+            return;
+        for (auto it = Textures.begin(); it != Textures.end(); ++it){
+            rendering::GLStateCache::OnTextureDeleted(it->second->textureID);
             glDeleteTextures(1, &it->second->textureID);
+        }
     }
 }
\ No newline at end of file
@@ -3,6 +3,9 @@
 #include "engine/ecs/Entity.h"
 #include "engine/utilities/rendering/Shader.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace EisEngine::components {
     PointLight::PointLight(
             Game& game, guid_t owner,
@@ -26,6 +29,13 @@ namespace EisEngine::components {
         shader.setFloat(loc.str().c_str(), GetIntensity());
     }
 
+    // contributions below 1/256 vanish after 8-bit quantization; solve I * e / d^2 = 1/256 for d.
+    float PointLight::GetRange() const {
+        auto e = GetEmission();
+        auto brightest = std::max(e.x, std::max(e.y, e.z));
+        return std::sqrt(std::max(GetIntensity() * brightest, 0.0f) * 256.0f);
+    }
+
     Vector3 PointLight::position() const {
         return entity()->transform->GetGlobalPosition();
     }
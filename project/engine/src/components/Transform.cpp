@@ -37,6 +37,8 @@ namespace EisEngine::components{
 
 // Transform functions:
 
+    uint64_t Transform::versionCounter = 0;
+
     // constructors and destructors
     Transform::Transform(Game &engine,
                          guid_t owner,
@@ -224,8 +226,11 @@ namespace EisEngine::components{
     void Transform::SetParent(Transform *transform) {
         // remove transform from old parent transform?!
         m_parent = transform;
+        version = ++versionCounter;
         if (m_parent != nullptr)
             m_parent->AddChild(this);
+        // the children's world matrices change along with this one's.
+        MarkDirty();
     }
     void Transform::AddChild(Transform *transform) {children.insert(transform);}
     void Transform::RemoveChild(Transform *transform) { children.erase(transform);}
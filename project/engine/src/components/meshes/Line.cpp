@@ -1,22 +1,10 @@
 #include "engine/components/meshes/Line.h"
 #include "engine/ecs/Entity.h"
+#include "engine/utilities/rendering/GLStateCache.h"
 
 namespace EisEngine::components {
     // helper functions:
 
-    // create and fill an openGL buffer object of the specified type.
-    template<typename T>
-    GLuint CreateBuffer(GLuint bufferType, const std::vector<T> &bufferData) {
-        unsigned int buffer = 0;
-        glGenBuffers(1, &buffer);
-        glBindBuffer(bufferType, buffer);
-        glBufferData(bufferType,
-                     bufferData.size() * sizeof(glm::vec3),
-                     bufferData.data(),
-                     GL_STATIC_DRAW);
-        return buffer;
-    }
-
     // creates a standard vector of openGL vectors.
     std::vector<glm::vec3> VectorsToGlmVec3s(const Vector3 &start, const Vector3 &end){ return {start, end};}
 
@@ -25,18 +13,15 @@ namespace EisEngine::components {
             Component(engine, owner),
             startPoint(start),
             endPoint(end),
-            lineCoordinates(VectorsToGlmVec3s(start, end)),
-            VBO(CreateBuffer(GL_ARRAY_BUFFER, lineCoordinates)) { UpdateBufferData();}
-
-    void Line::Invalidate() {
-        glDeleteBuffers(1, &VBO);
-        Component::Invalidate();
-    }
-
-    void Line::draw(const unsigned int& shaderProgram) const {
-        auto vpos = glGetAttribLocation(shaderProgram, "aPos");
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+            lineCoordinates(VectorsToGlmVec3s(start, end)) { }
+
+    void Line::draw(rendering::StreamingRingBuffer& stream) const {
+        // the end points are streamed every frame, so moving them never reallocates a buffer.
+        auto allocation = stream.Write(lineCoordinates.data(), lineCoordinates.size() * sizeof(glm::vec3));
+        if(!allocation.data)
+            return;
+        rendering::GLStateCache::BindBuffer(GL_ARRAY_BUFFER, stream.GetBufferID());
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid*) allocation.offset);
         glEnableVertexAttribArray(0);
 
         glDrawArrays(GL_LINES, 0, 2);
@@ -58,7 +43,5 @@ namespace EisEngine::components {
 
     void Line::UpdateBufferData() {
         lineCoordinates = VectorsToGlmVec3s(startPoint, endPoint);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, 2*sizeof(glm::vec3), lineCoordinates.data(), GL_STATIC_DRAW);
     }
 }
\ No newline at end of file
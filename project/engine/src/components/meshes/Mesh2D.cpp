@@ -1,5 +1,7 @@
 #include "engine/components/meshes/Mesh2D.h"
 #include "engine/ecs/Entity.h"
+#include "engine/Context.h"
+#include "engine/utilities/rendering/GLStateCache.h"
 
 namespace EisEngine::components {
     // helper functions:
@@ -8,8 +10,10 @@ namespace EisEngine::components {
     template<typename T>
     GLuint CreateBuffer(GLuint bufferType, const std::vector<T> &bufferData) {
         unsigned int buffer = 0;
+        if(!ctx::Context::HasGraphics())
+            return buffer;
         glGenBuffers(1, &buffer);
-        glBindBuffer(bufferType, buffer);
+        rendering::GLStateCache::BindBuffer(bufferType, buffer);
         glBufferData(bufferType, bufferData.size() * sizeof(T), bufferData.data(), GL_STATIC_DRAW);
         return buffer;
     }
@@ -32,17 +36,21 @@ namespace EisEngine::components {
     }
 
     void Mesh2D::Invalidate() {
-        glDeleteBuffers(1, &VBO);
-        glDeleteBuffers(1, &EBO);
+        if(ctx::Context::HasGraphics()){
+            rendering::GLStateCache::OnBufferDeleted(VBO);
+            rendering::GLStateCache::OnBufferDeleted(EBO);
+            glDeleteBuffers(1, &VBO);
+            glDeleteBuffers(1, &EBO);
+        }
         Component::Invalidate();
     }
 
     void Mesh2D::draw() {
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        rendering::GLStateCache::BindBuffer(GL_ARRAY_BUFFER, VBO);
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr);
         glEnableVertexAttribArray(0);
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        rendering::GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
 
         glDrawElements(GL_TRIANGLES, primitive.indexCount, GL_UNSIGNED_INT, nullptr);
     }
@@ -1,63 +1,119 @@
 #include "engine/components/meshes/Mesh3D.h"
 #include "engine/ecs/Entity.h"
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+
 namespace EisEngine::components {
-    // create and fill an openGL buffer object of the specified type.
+    // geometry shared between all meshes built from the same primitive data.
+    struct SharedGeometry {
+        // the primitive the geometry was uploaded from, compared against on cache hits.
+        PrimitiveMesh3D source;
+        rendering::StaticGeometryRange range;
+        int users = 0;
+    };
+
+    // registry of uploaded geometry, keyed by the primitive's content hash; colliding primitives share a bucket.
+    std::unordered_map<size_t, std::list<SharedGeometry>> geometryCache = {};
+
+    // FNV-1a hash over the raw bytes of a vector.
+    template<typename T>
+    size_t HashData(size_t hash, const std::vector<T>& data){
+        auto bytes = reinterpret_cast<const unsigned char*>(data.data());
+        for(size_t i = 0; i < data.size() * sizeof(T); i++){
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // hashes all vertex attributes and indices of a primitive (tangents are derived from those).
+    size_t HashPrimitive(const PrimitiveMesh3D& primitive){
+        size_t hash = 14695981039346656037ull;
+        hash = HashData(hash, primitive.GetVertices());
+        hash = HashData(hash, primitive.GetNormals());
+        hash = HashData(hash, primitive.GetUVs());
+        hash = HashData(hash, primitive.indices);
+        for(const auto& lod : primitive.GetLODs())
+            hash = HashData(hash, lod.indices);
+        return hash;
+    }
+
+    // whether two vectors hold the same bytes.
     template<typename T>
-    GLuint CreateBuffer(GLuint bufferType, const std::vector<T> &bufferData) {
-        unsigned int buffer = 0;
-        glGenBuffers(1, &buffer);
-        glBindBuffer(bufferType, buffer);
-        glBufferData(bufferType, bufferData.size() * sizeof(T), bufferData.data(), GL_STATIC_DRAW);
-        return buffer;
+    bool SameData(const std::vector<T>& a, const std::vector<T>& b){
+        return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
     }
 
-    GLuint CreateVBO(const PrimitiveMesh3D& primitive){
-        // buffer initialization
-        unsigned int buffer = 0;
-        glGenBuffers(1, &buffer);
-        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    // whether two primitives hold the data hashed by HashPrimitive, i.e. whether they can share their geometry.
+    bool SameGeometry(const PrimitiveMesh3D& a, const PrimitiveMesh3D& b){
+        if(!SameData(a.GetPositionData(), b.GetPositionData()) || !SameData(a.GetNormalData(), b.GetNormalData()) ||
+           !SameData(a.GetUVData(), b.GetUVData()) || !SameData(a.indices, b.indices) ||
+           a.GetLODs().size() != b.GetLODs().size())
+            return false;
+        for(size_t i = 0; i < a.GetLODs().size(); i++)
+            if(!SameData(a.GetLODs()[i].indices, b.GetLODs()[i].indices))
+                return false;
+        return true;
+    }
 
-        // data preparation
-        const auto& vertices = Vec3VectorToGlm(primitive.GetVertices());
-        auto vsize = vertices.size() * sizeof(glm::vec3);
+    // interleaves the vertex attributes of a primitive.
+    std::vector<rendering::StaticVertex> BuildVertices(const PrimitiveMesh3D& primitive){
+        const auto& positions = Vec3VectorToGlm(primitive.GetVertices());
         const auto& normals = Vec3VectorToGlm(primitive.GetNormals());
-        auto nsize = normals.size() * sizeof(glm::vec3);
         const auto& uvs = Vec2VectorToGlm(primitive.GetUVs());
-        auto uvsize = uvs.size() * sizeof(glm::vec2);
         const auto& tans = Vec3VectorToGlm(primitive.GetTangents());
-        auto tansize = tans.size() * sizeof(glm::vec3);
         const auto& bitans = Vec3VectorToGlm(primitive.GetBitangents());
-        auto bitansize = bitans.size() * sizeof(glm::vec3);
-        auto total_buffer_size = GLsizeiptr(vsize + nsize + uvsize + tansize + bitansize);
-
-        // buffer population
-        glBufferData(GL_ARRAY_BUFFER, total_buffer_size, nullptr, GL_STATIC_DRAW);
-        long long offset = 0;
-        glBufferSubData(GL_ARRAY_BUFFER, offset, vsize, vertices.data());
-        DEBUG_OPENGL("Vertices")
-        offset += vsize;
-        glBufferSubData(GL_ARRAY_BUFFER, offset, nsize, normals.data());
-        DEBUG_OPENGL("Normals")
-        offset += nsize;
-        glBufferSubData(GL_ARRAY_BUFFER, offset, uvsize, uvs.data());
-        DEBUG_OPENGL("UVs")
-        offset += uvsize;
-        glBufferSubData(GL_ARRAY_BUFFER, offset, tansize, tans.data());
-        DEBUG_OPENGL("Tangents")
-        offset += tansize;
-        glBufferSubData(GL_ARRAY_BUFFER, offset, bitansize, bitans.data());
-        DEBUG_OPENGL("Bitangents")
-
-        return buffer;
+
+        std::vector<rendering::StaticVertex> vertices(positions.size());
+        for(size_t i = 0; i < positions.size(); i++)
+            vertices[i] = {positions[i],
+                           i < normals.size() ? normals[i] : glm::vec3(0.0f),
+                           i < uvs.size() ? uvs[i] : glm::vec2(0.0f),
+                           i < tans.size() ? tans[i] : glm::vec3(0.0f),
+                           i < bitans.size() ? bitans[i] : glm::vec3(0.0f)};
+        return vertices;
+    }
+
+    // lists the detail levels of a primitive as consecutive slices of a single index buffer.
+    std::vector<LODRange> BuildLODRanges(const PrimitiveMesh3D& primitive){
+        std::vector<LODRange> ranges = {{0, primitive.indexCount, 0.0f}};
+        auto offset = primitive.indexCount;
+        for(const auto& lod : primitive.GetLODs()){
+            ranges.push_back({offset, (int) lod.indices.size(), lod.error});
+            offset += (int) lod.indices.size();
+        }
+        return ranges;
+    }
+
+    // concatenates the indices of all detail levels of a primitive.
+    std::vector<unsigned int> CollectLODIndices(const PrimitiveMesh3D& primitive){
+        auto indices = primitive.indices;
+        for(const auto& lod : primitive.GetLODs())
+            indices.insert(indices.end(), lod.indices.begin(), lod.indices.end());
+        return indices;
     }
 
     Mesh3D::Mesh3D(EisEngine::Game &engine, EisEngine::ecs::guid_t owner, const PrimitiveMesh3D &_primitive) :
     Component(engine, owner),
     primitive(_primitive),
-    VBO(CreateVBO(_primitive)),
-    EBO(CreateBuffer(GL_ELEMENT_ARRAY_BUFFER, _primitive.indices)) {
-
+    geometryHash(HashPrimitive(_primitive)),
+    lodRanges(BuildLODRanges(_primitive)) {
+        // only upload geometry that isn't already on the GPU; equal hashes alone may be a collision.
+        auto& bucket = geometryCache[geometryHash];
+        auto shared = std::find_if(bucket.begin(), bucket.end(), [&](const SharedGeometry& candidate){
+            return SameGeometry(candidate.source, primitive);
+        });
+        if(shared == bucket.end()){
+            auto range = rendering::StaticGeometry::Upload(BuildVertices(primitive), CollectLODIndices(primitive));
+            bucket.push_back({primitive, range, 0});
+            shared = std::prev(bucket.end());
+        }
+        shared->users++;
+        geometry = shared->range;
     }
 
     Mesh3D::Mesh3D(EisEngine::components::Mesh3D &&other)  noexcept  :
@@ -65,76 +121,59 @@ namespace EisEngine::components {
             primitive(other.primitive)
     {
         owner = other.owner;
-        std::swap(this->VBO, other.VBO);
-        std::swap(this->EBO, other.EBO);
+        std::swap(this->geometry, other.geometry);
+        std::swap(this->geometryHash, other.geometryHash);
+        std::swap(this->lodRanges, other.lodRanges);
+        std::swap(this->lodLevel, other.lodLevel);
+    }
+
+    void Mesh3D::SetLODLevel(const int &level) {
+        lodLevel = std::clamp(level, 0, (int) lodRanges.size() - 1);
+    }
+
+    unsigned int Mesh3D::GetFirstIndex() const {
+        return rendering::StaticGeometry::GetFirstIndex(geometry) + lodRanges[lodLevel].offset;
     }
 
     void Mesh3D::Invalidate() {
-        glDeleteBuffers(1, &VBO);
-        glDeleteBuffers(1, &EBO);
+        // release the shared geometry once the last mesh using it is gone.
+        auto it = geometryCache.find(geometryHash);
+        if(it != geometryCache.end()){
+            auto& bucket = it->second;
+            auto shared = std::find_if(bucket.begin(), bucket.end(), [&](const SharedGeometry& candidate){
+                return candidate.range.vertices == geometry.vertices;
+            });
+            if(shared != bucket.end() && --shared->users <= 0){
+                rendering::StaticGeometry::Release(shared->range);
+                bucket.erase(shared);
+                if(bucket.empty())
+                    geometryCache.erase(it);
+            }
+        }
+        geometry = {};
         Component::Invalidate();
     }
 
     void Mesh3D::draw(const unsigned int& shaderProgram) {
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        BindGeometry(shaderProgram);
+
+        auto indexSize = rendering::StaticGeometry::GetIndexSize(geometry.indexType);
+        glDrawElementsBaseVertex(GL_TRIANGLES, lodRanges[lodLevel].count, geometry.indexType,
+                                 (GLvoid*) (GetFirstIndex() * indexSize), GetBaseVertex());
         DEBUG_OPENGL(entity()->name())
-        unsigned long long offset = 0;
-        auto nVerts = primitive.GetVertexCount();
-
-        // draw vertices
-        auto vpos = glGetAttribLocation(shaderProgram, "aPos");
-        if(vpos != -1){
-            glEnableVertexAttribArray(vpos);
-            glVertexAttribPointer(vpos, 3, GL_FLOAT, GL_FALSE,
-                                  0, nullptr);
-            DEBUG_OPENGL(entity()->name())
-        }
-        offset = nVerts * sizeof(glm::vec3);
-
-        // add normals
-        auto norm = glGetAttribLocation(shaderProgram, "normal");
-        if(norm != -1){
-            glEnableVertexAttribArray(norm);
-            glVertexAttribPointer(norm, 3, GL_FLOAT, GL_FALSE,
-                                  0, (GLvoid*)offset);
-            DEBUG_OPENGL(entity()->name())
-        }
-        offset += nVerts * sizeof(glm::vec3);
-
-        // add uvs
-        auto uv = glGetAttribLocation(shaderProgram, "texCoords");
-        if(uv != -1){
-            glEnableVertexAttribArray(uv);
-            glVertexAttribPointer(uv, 2, GL_FLOAT, GL_FALSE,
-                                  0, (GLvoid*)offset);
-            DEBUG_OPENGL(entity()->name())
-        }
-        offset += nVerts * sizeof(glm::vec2);
-
-        // add tangents
-        auto tan = glGetAttribLocation(shaderProgram, "tan");
-        if(tan != -1){
-            glEnableVertexAttribArray(tan);
-            glVertexAttribPointer(tan, 3, GL_FLOAT, GL_FALSE,
-                                  0, (GLvoid*)offset);
-            DEBUG_OPENGL(entity()->name())
-        }
-        offset += nVerts * sizeof(glm::vec3);
-
-        // add bitangents
-        auto bitan = glGetAttribLocation(shaderProgram, "bitan");
-        if(bitan != -1){
-            glEnableVertexAttribArray(bitan);
-            glVertexAttribPointer(bitan, 2, GL_FLOAT, GL_FALSE,
-                                  0, (GLvoid*)offset);
-            DEBUG_OPENGL(entity()->name())
-        }
-        //offset += nVerts * sizeof(glm::vec3);
+    }
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    void Mesh3D::drawInstanced(const int& instanceCount) const {
+        auto indexSize = rendering::StaticGeometry::GetIndexSize(geometry.indexType);
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, lodRanges[lodLevel].count, geometry.indexType,
+                                          (GLvoid*) (GetFirstIndex() * indexSize), instanceCount,
+                                          GetBaseVertex());
         DEBUG_OPENGL(entity()->name())
+    }
 
-        glDrawElements(GL_TRIANGLES, primitive.indexCount, GL_UNSIGNED_INT, nullptr);
+    void Mesh3D::BindGeometry(const unsigned int& shaderProgram) {
+        // all meshes share the arenas' buffers; the state cache drops the rebinding between meshes.
+        rendering::StaticGeometry::Bind(shaderProgram, geometry.indexType);
         DEBUG_OPENGL(entity()->name())
     }
 }
\ No newline at end of file
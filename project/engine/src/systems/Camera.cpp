@@ -68,6 +68,20 @@ namespace EisEngine::systems {
         return projection * view;
     }
 
+    rendering::Ray Camera::ScreenPointToRay(const Vector2 &screenPos) {
+        // pixel coordinates to normalized device coordinates (y pointing up).
+        auto x = 2.0f * screenPos.x / (float) m_screenWidth - 1.0f;
+        auto y = 1.0f - 2.0f * screenPos.y / (float) m_screenHeight;
+
+        auto inverseVP = glm::inverse(GetVPMatrix());
+        auto nearPoint = inverseVP * glm::vec4(x, y, -1.0f, 1.0f);
+        auto farPoint = inverseVP * glm::vec4(x, y, 1.0f, 1.0f);
+        auto origin = glm::vec3(nearPoint) / nearPoint.w;
+        auto end = glm::vec3(farPoint) / farPoint.w;
+
+        return {origin, glm::normalize(end - origin)};
+    }
+
     glm::mat4 Camera::CalculateViewMatrix() const {
         // zoom pos offsets here!
         glm::vec3 cameraPos = (glm::vec3) transform->GetGlobalPosition();
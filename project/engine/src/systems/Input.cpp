@@ -10,6 +10,7 @@ namespace EisEngine {
     static bool firstCall = true;
 
     void Input::MouseCallback() {
+        if (window == nullptr) return;
         double x, y;
         glfwGetCursorPos(window, &x, &y);
         auto currentPos = Vector2((float) x, (float) y);
@@ -28,7 +29,8 @@ namespace EisEngine {
 
     Input::Input(EisEngine::Game &engine) : System(engine) {
         window = engine.getWindow();
-        glfwSetScrollCallback(window, Input::ScrollCallback);
+        if(window)
+            glfwSetScrollCallback(window, Input::ScrollCallback);
         engine.onBeforeUpdate.addListener([&] (Game& game){
             MouseCallback();
         });
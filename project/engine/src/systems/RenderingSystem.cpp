@@ -1,12 +1,32 @@
 #include "engine/systems/RenderingSystem.h"
 #include "engine/Game.h"
 #include "engine/Components.h"
+#include "engine/utilities/ThreadPool.h"
+#include "engine/utilities/DebugDraw.h"
+#include "engine/utilities/rendering/GLRenderBackend.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <tuple>
 
-// DO NOT UPDATE WITHOUT ALSO UPDATING SAME NAMED MACRO IN FRAGMENT SHADERS!
-#define MAX_LIGHTS 1
 #define DIST_THRESHOLD 5.0f
+// the amount of light candidates gathered per mesh before they are narrowed down to MAX_LIGHTS.
+#define MAX_LIGHT_CANDIDATES 32
+// fraction below the error threshold a coarser detail level must reach before switching to it.
+#define LOD_HYSTERESIS 0.25f
+// the amount of meshes recorded into a single command list.
+#define RECORD_CHUNK_SIZE 64
+// the size in bytes of the ring buffer for data rewritten every frame, holding about three frames of data.
+#define STREAMING_BUFFER_SIZE (16 * 1024 * 1024)
+// the ratio of a sphere's mean chord length to its radius, estimating the thickness of meshes for OIT.
+#define MEAN_CHORD_FACTOR (4.0f / 3.0f)
+// the amount of frames the depth pre-pass queries are read back late, so that reading them never stalls.
+#define PREPASS_QUERY_LATENCY 3
+// the amount of combinations of ShaderKeywords.
+#define SHADER_VARIANT_COUNT 4
+// the amount of frames the GPU frame timers are read back late, so that reading them never stalls.
+#define FRAME_TIMER_LATENCY 3
 
 namespace EisEngine::systems {
 // helper functions:
@@ -21,36 +41,115 @@ const std::unordered_map<std::string, std::string> RenderingSystem::shaderNameDi
         {"Depth", "Depth Mapping"},
         {"Glassy", "Glassy Shader"}*/
 };
-Event<RenderingSystem, const Vector2&> RenderingSystem::onResize = Event();
+const std::unordered_map<std::string, std::string> RenderingSystem::instancedShaderNameDict = {
+        {"Blinn-Phong", "Blinn-Phong Instanced Shader"},
+        {"Cook-Torrance", "Cook-Torrance Instanced Shader"},
+        {"Toon", "Toon Instanced Shader"}
+};
+const std::unordered_map<std::string, std::string> RenderingSystem::multiDrawShaderNameDict = {
+        {"Blinn-Phong", "Blinn-Phong Multi-Draw Shader"},
+        {"Cook-Torrance", "Cook-Torrance Multi-Draw Shader"},
+        {"Toon", "Toon Multi-Draw Shader"}
+};
+bool RenderingSystem::instancingEnabled = true;
+bool RenderingSystem::multiDrawEnabled = true;
+bool RenderingSystem::frustumCullingEnabled = true;
+bool RenderingSystem::occlusionCullingEnabled = false;
+bool RenderingSystem::clusteredLightingEnabled = true;
+float RenderingSystem::lodErrorThreshold = 1.0f;
+CullingStats RenderingSystem::cullingStats = {};
+StreamingStats RenderingSystem::streamingStats = {};
+RenderGraphStats RenderingSystem::renderGraphStats = {};
+bool RenderingSystem::depthPrePassEnabled = false;
+PrePassStats RenderingSystem::prePassStats = {};
+TransparencyMode RenderingSystem::transparencyMode = TransparencyMode::Sorted;
+float RenderingSystem::thicknessResolutionScale = 0.5f;
+float RenderingSystem::renderScale = 1.0f;
+uint32_t RenderingSystem::maxLightsPerCluster = 0;
+QualityGovernor RenderingSystem::qualityGovernor = QualityGovernor();
 shared_ptr<Entity> RenderingSystem::skybox = nullptr;
 Vector3 RenderingSystem::eta = Vector3::zero;
 float RenderingSystem::ambient = 0.15f;
 
-struct Entry{
-    PointLight* L;
-    float dist2;
+// key grouping meshes that can be drawn in a single instanced call; all but the geometry in a single multi-draw.
+struct BatchKey{
+    // the shader variant (ShaderKeywords), first so that batches of a variant are contiguous.
+    uint32_t keywords = 0;
+    Texture2D* diffuseTex = nullptr;
+    Texture2D* normalMap = nullptr;
+    // diffuse (rgb), opacity, tiling, metallic, roughness.
+    std::array<float, 7> material = {};
+    // -1 if out of LOD range (unlit).
+    int nLights = -1;
+    std::array<PointLight*, MAX_LIGHTS> lights = {};
+    // 16 or 32 bit; a multi-draw reads a single index buffer.
+    GLenum indexType = 0;
+    // last, so that batches sharing all state but the geometry are contiguous.
+    unsigned int geometry = 0;
+    int lod = 0;
+
+    [[nodiscard]] auto state() const {
+        return std::tie(keywords, diffuseTex, normalMap, material, nLights, lights, indexType);
+    }
+    [[nodiscard]] auto tie() const { return std::tuple_cat(state(), std::tie(geometry, lod));}
+    bool operator<(const BatchKey& other) const { return tie() < other.tie();}
+    bool operator==(const BatchKey& other) const { return tie() == other.tie();}
 };
 
-    // used to sort entities by ascending z position.
-    bool CompareZValues(SpriteMesh* a, SpriteMesh* b)
-    { return a->entity()->transform->GetGlobalPosition().z < b->entity()->transform->GetGlobalPosition().z;}
+struct BatchEntry{
+    BatchKey key;
+    Mesh3D* mesh = nullptr;
+    Renderer* renderer = nullptr;
+    // the position of the mesh in the draw order.
+    uint32_t order = 0;
+};
 
-// rendering system methods:
-    std::vector<Entity*> RenderingSystem::Loaders = {};
+    // calculates the matrix transforming normals to world space.
+    glm::mat3 CalculateNormalMatrix(const glm::mat4& model){
+        // if mat is inversible, apply inverse transposed matrix
+        auto normalMat = glm::transpose(glm::inverse(glm::mat3(model)));
+        if(abs(glm::determinant(model)) < 1e-6f) {
+            // normalize matrix to kill scale variance
+            normalMat[0] = glm::normalize(normalMat[0]);
+            normalMat[1] = glm::normalize(normalMat[1]);
+            normalMat[2] = glm::normalize(normalMat[2]);
+        }
+        return normalMat;
+    }
 
-    constexpr float CELL_SIZE = 40.0f;
+    // the defines enabling the given shader keywords.
+    std::vector<std::string> KeywordDefines(uint32_t keywords){
+        std::vector<std::string> defines;
+        if(keywords & KEYWORD_NORMAL_MAP)
+            defines.emplace_back("NORMAL_MAP");
+        if(keywords & KEYWORD_UNLIT)
+            defines.emplace_back("UNLIT");
+        return defines;
+    }
 
-    inline Vector2 WorldToCell(const glm::vec3& pos) {
-        return Vector2{
-                floor(pos.x / CELL_SIZE),
-                floor(pos.z / CELL_SIZE)
-        };
+    // uploads data to a shader storage buffer & binds it to the given binding point.
+    void UploadStorageBuffer(GLuint buffer, GLuint binding, const void* data, size_t size){
+        GLStateCache::BindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+        // orphan the previous allocation; empty buffers cannot be bound, so keep a minimal one.
+        glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr) std::max<size_t>(size, 16), nullptr, GL_STREAM_DRAW);
+        if(size > 0)
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, (GLsizeiptr) size, data);
+        GLStateCache::BindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, buffer);
     }
 
+// rendering system methods:
+    std::vector<Entity*> RenderingSystem::Loaders = {};
+
+    std::vector<Entity*> RenderingSystem::Occluders = {};
+
     void RenderingSystem::MarkAsLoader(EisEngine::ecs::Entity *ptr) {
         Loaders.push_back(ptr);
     }
 
+    void RenderingSystem::MarkAsOccluder(EisEngine::ecs::Entity *ptr) {
+        Occluders.push_back(ptr);
+    }
+
     void RenderingSystem::SetSpecularFactor(const float &val) { specularFactor = val;}
 
     void RenderingSystem::SetActiveShader(const std::string &shaderName) {
@@ -62,149 +161,184 @@ struct Entry{
         DEBUG_WARN("Attempted to set shader to invalid value [" + shaderName + "].")
     }
 
-    void RenderingSystem::SetSkyboxEntity(EisEngine::ecs::Entity *ptr) {
-        skybox = static_cast<shared_ptr<Entity>>(ptr);
+    void RenderingSystem::SetThicknessResolutionScale(const float &scale) {
+        thicknessResolutionScale = std::clamp(scale, 0.05f, 1.0f);
+    }
+
+    void RenderingSystem::SetRenderScale(const float &scale) {
+        renderScale = std::clamp(scale, 0.25f, 1.0f);
     }
 
-    void RenderingSystem::InitFBO(const int& index, const Vector2& screenDims) {
-        // gen framebuffer
-        glGenFramebuffers(1, &FBO[index]);
-        glBindFramebuffer(GL_FRAMEBUFFER, FBO[index]);
-
-        // gen depth texture
-        glGenTextures(1, &depthTex[index]);
-        glBindTexture(GL_TEXTURE_2D, depthTex[index]);
-
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_R32F,
-            (int) screenDims.x,
-            (int) screenDims.y,
-            0,
-            GL_RED,
-            GL_FLOAT,
-            nullptr
-        );
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-        glFramebufferTexture2D(
-            GL_FRAMEBUFFER,
-            GL_COLOR_ATTACHMENT0,
-            GL_TEXTURE_2D,
-            depthTex[index],
-            0
-        );
-
-        // gen RBO for depth cache (?)
-        glGenRenderbuffers(1, &RBO[index]);
-        glBindRenderbuffer(GL_RENDERBUFFER, RBO[index]);
-        glRenderbufferStorage(
-            GL_RENDERBUFFER,
-            GL_DEPTH_COMPONENT24,
-            (int) screenDims.x,
-            (int) screenDims.y
-        );
-
-        glFramebufferRenderbuffer(
-                GL_FRAMEBUFFER,
-                GL_DEPTH_ATTACHMENT,
-                GL_RENDERBUFFER,
-                RBO[index]
-        );
-
-        // add draw buffer
-        GLenum drawBufs[] = { GL_COLOR_ATTACHMENT0 };
-        glDrawBuffers(1, drawBufs);
+    QualitySettings RenderingSystem::GetBaseQuality() {
+        QualitySettings settings;
+        settings.renderScale = renderScale;
+        settings.maxLightsPerCluster = maxLightsPerCluster;
+        settings.lodErrorThreshold = lodErrorThreshold;
+        settings.thicknessScale = thicknessResolutionScale;
+        return settings;
+    }
+
+    void RenderingSystem::UpdateQuality() {
+        auto gpuTime = -1.0;
+        if(ctx::Context::HasGraphics()){
+            gpuTime = ReadFrameTimer(frameTimerFrame);
+            glQueryCounter(frameTimerQueries[frameTimerFrame].ids[0], GL_TIMESTAMP);
+        }
+        // the update time covers the previous frame's work, this frame's has not finished yet.
+        if(qualityGovernor.Update(engine.context.GetUpdateTime(), gpuTime))
+            DEBUG_LOG("Quality level changed to " + std::to_string(qualityGovernor.GetLevel()) + ".")
+        quality = qualityGovernor.GetSettings(GetBaseQuality());
+        lightClusters.SetMaxLightsPerCluster(quality.maxLightsPerCluster);
+    }
+
+    double RenderingSystem::ReadFrameTimer(size_t frame) {
+        auto& queries = frameTimerQueries[frame];
+        if(!queries.issued)
+            return -1.0;
+        queries.issued = false;
+        // if the frame has not finished on the GPU, drop it instead of waiting.
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(queries.ids[1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if(!available)
+            return -1.0;
+
+        GLuint64 start = 0, end = 0;
+        glGetQueryObjectui64v(queries.ids[0], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(queries.ids[1], GL_QUERY_RESULT, &end);
+        return end > start ? (double) (end - start) * 1e-6 : 0.0;
+    }
+
+    const std::string &RenderingSystem::GetShadingModel() const {
+        if(quality.simpleShading && active3DShader == "Cook-Torrance")
+            return defaultShader;
+        return active3DShader;
+    }
+
+    Vector2 RenderingSystem::GetRenderTargetSize() const {
+        auto size = engine.context.GetWindowSize();
+        return Vector2(std::max(1.0f, std::floor(size.x * quality.renderScale)),
+                       std::max(1.0f, std::floor(size.y * quality.renderScale)));
+    }
+
+    void RenderingSystem::InitSceneTarget(const Vector2 &size) {
+        if(sceneFBO == 0){
+            glGenFramebuffers(1, &sceneFBO);
+            glGenRenderbuffers((GLsizei) sceneRBO.size(), sceneRBO.data());
+        }
+        GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+
+        glBindRenderbuffer(GL_RENDERBUFFER, sceneRBO[0]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, (int) size.x, (int) size.y);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, sceneRBO[0]);
+        // the default framebuffer's format, so that weighted blended transparency blits depth the same way.
+        glBindRenderbuffer(GL_RENDERBUFFER, sceneRBO[1]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, (int) size.x, (int) size.y);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, sceneRBO[1]);
 
         assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
 
         glBindRenderbuffer(GL_RENDERBUFFER, 0);
-        glBindTexture(GL_TEXTURE_2D, 0);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, ctx::Context::GetDefaultFramebuffer());
+        sceneTargetSize = size;
+        DEBUG_OPENGL("Scene Target")
     }
 
-    void RenderingSystem::ResizeFBOItems(const EisEngine::Vector2 &newScreenDims) {
-        for(int i = 0; i < FBO.size(); i++){
-            glBindRenderbuffer(GL_RENDERBUFFER, FBO[i]);
+    void RenderingSystem::BeginSceneTarget() {
+        sceneFramebuffer = ctx::Context::GetDefaultFramebuffer();
+        if(quality.renderScale >= 1.0f)
+            return;
 
-            glBindTexture(GL_TEXTURE_2D, depthTex[i]);
-            glTexImage2D(
-                    GL_TEXTURE_2D,
-                    0,
-                    GL_R32F,
-                    (int) newScreenDims.x,
-                    (int) newScreenDims.y,
-                    0,
-                    GL_RED,
-                    GL_FLOAT,
-                    nullptr
-            );
+        auto size = GetRenderTargetSize();
+        if(size != sceneTargetSize)
+            InitSceneTarget(size);
+        sceneFramebuffer = sceneFBO;
+        windowViewport = GLStateCache::GetViewport();
+        GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+        GLStateCache::Viewport(0, 0, (int) size.x, (int) size.y);
+
+        // cleared like the window (see Context::run); clears respect the write masks.
+        auto clearColor = ctx::Context::GetClearColor();
+        glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
+        GLStateCache::DepthMask(true);
+        GLStateCache::ColorMask(true);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
 
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    void RenderingSystem::ResolveSceneTarget() {
+        auto windowFramebuffer = ctx::Context::GetDefaultFramebuffer();
+        if(sceneFramebuffer == windowFramebuffer)
+            return;
 
-            // gen RBO for depth cache (?)
-            glBindRenderbuffer(GL_RENDERBUFFER, RBO[i]);
-            glRenderbufferStorage(
-                    GL_RENDERBUFFER,
-                    GL_DEPTH_COMPONENT24,
-                    (int) newScreenDims.x,
-                    (int) newScreenDims.y
-            );
+        GLStateCache::BindFramebuffer(GL_READ_FRAMEBUFFER, sceneFBO);
+        GLStateCache::BindFramebuffer(GL_DRAW_FRAMEBUFFER, windowFramebuffer);
+        glBlitFramebuffer(0, 0, (int) sceneTargetSize.x, (int) sceneTargetSize.y,
+                          windowViewport[0], windowViewport[1],
+                          windowViewport[0] + windowViewport[2], windowViewport[1] + windowViewport[3],
+                          GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, windowFramebuffer);
+        GLStateCache::Viewport(windowViewport[0], windowViewport[1], windowViewport[2], windowViewport[3]);
+        sceneFramebuffer = windowFramebuffer;
+        DEBUG_OPENGL("Scene Target Resolve")
+    }
 
-            assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+    void RenderingSystem::SetSkyboxEntity(EisEngine::ecs::Entity *ptr) {
+        skybox = static_cast<shared_ptr<Entity>>(ptr);
+    }
 
-            glBindRenderbuffer(GL_RENDERBUFFER, 0);
-            glBindTexture(GL_TEXTURE_2D, 0);
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        }
+    Vector2 RenderingSystem::GetThicknessTargetSize(const Vector2 &screenDims) const {
+        return Vector2(std::max(1.0f, std::floor(screenDims.x * quality.thicknessScale)),
+                       std::max(1.0f, std::floor(screenDims.y * quality.thicknessScale)));
     }
 
     RenderingSystem::RenderingSystem(EisEngine::Game &engine) : System(engine) {
         SetActiveShader("Blinn-Phong");
+        quality = GetBaseQuality();
 
         camera = &engine.camera;
         if(!camera)
             DEBUG_RUNTIME_ERROR("Cannot initialize rendering; Camera not found.")
 
-        engine.onUpdate.addListener([&] (Game& engine){ Draw();});
+        // simulation-only games never draw; debug lines drawn by scripts still expire.
+        if(engine.context.IsSimulation())
+            engine.onUpdate.addListener([&] (Game& engine){ DebugDraw::EndFrame(Time::deltaTime);});
+        else
+            engine.onUpdate.addListener([&] (Game& engine){ Draw();});
+        defaultNormalMap = ResourceManager::GetTexture("default_normal");
+        instancedCommands.resize(SHADER_VARIANT_COUNT);
+
+        // without a graphics context, the CPU side of rendering runs against a backend discarding its results.
+        if(!ctx::Context::HasGraphics()){
+            backend = std::make_unique<NullRenderBackend>();
+            return;
+        }
+        streamingBuffer = std::make_unique<StreamingRingBuffer>(STREAMING_BUFFER_SIZE);
+        backend = std::make_unique<GLRenderBackend>(*streamingBuffer);
 
         VAO = {};
         for(unsigned int & i : VAO)
             glGenVertexArrays(1, &i);
-
-        int width, height;
-        glfwGetWindowSize(engine.getWindow(), &width, &height);
-        // init FBOs
-        InitFBO(0, Vector2((float) width, (float) height));
-        InitFBO(1, Vector2((float) width, (float) height));
-        onResize.addListener([this](const Vector2& v){
-           ResizeFBOItems(v);
-        });
-        // add callback to window resize to reallocate depth texture size & rbo sizes on window resize.
-        glfwSetWindowSizeCallback(engine.getWindow(), [](GLFWwindow* window, int width, int height){
-           RenderingSystem::onResize.invoke(Vector2((float) width, (float) height));
-        });
-
+        glGenBuffers((GLsizei) clusterSSBO.size(), clusterSSBO.data());
+        prePassQueries.resize(PREPASS_QUERY_LATENCY);
+        for(auto& queries : prePassQueries)
+            glGenQueries((GLsizei) queries.ids.size(), queries.ids.data());
+        frameTimerQueries.resize(FRAME_TIMER_LATENCY);
+        for(auto& queries : frameTimerQueries)
+            glGenQueries((GLsizei) queries.ids.size(), queries.ids.data());
+
+        // submit all shaders at once, so that the driver compiles them concurrently.
+        ResourceManager::BeginShaderBatch();
         // generate default shader (mesh2D & lines)
         ResourceManager::GenerateShaderFromFiles("shaders/vert-no_normals.vert",
                                                  "shaders/frag-material_debug_unlit.frag",
                                                  "Default Shader");
-        // generate default sprite shader
-        ResourceManager::GenerateShaderFromFiles( "shaders/vert-shader3D.vert",
-                                                  "shaders/frag-sprite_unlit.frag",
-                                                  "Sprite Shader");
-        // generate ui sprite shader
-        ResourceManager::GenerateShaderFromFiles("shaders/vert-no_normals.vert",
-                                                 "shaders/frag-sprite_unlit.frag",
-                                                 "UI Shader");
+        // generate debug line shader
+        ResourceManager::GenerateShaderFromFiles("shaders/vert-debug_lines.vert",
+                                                 "shaders/frag-debug_lines.frag",
+                                                 "Debug Line Shader");
+        // generate batched sprite shader (world & ui sprites)
+        ResourceManager::GenerateShaderFromFiles("shaders/vert-sprite_batched.vert",
+                                                 "shaders/frag-sprite_batched.frag",
+                                                 "Sprite Batch Shader");
         // generate Blinn-Phong shader
         ResourceManager::GenerateShaderFromFiles("shaders/vert-shader3D.vert",
                                                  "shaders/frag-blinn_phong.frag",
@@ -218,54 +352,314 @@ struct Entry{
                                                  "shaders/frag-toon.frag",
                                                  "Toon Shader");
 
+        // generate instanced variants of the 3D shaders
+        ResourceManager::GenerateShaderFromFiles("shaders/vert-shader3D_instanced.vert",
+                                                 "shaders/frag-blinn_phong.frag",
+                                                 "Blinn-Phong Instanced Shader");
+        ResourceManager::GenerateShaderFromFiles("shaders/vert-shader3D_instanced.vert",
+                                                 "shaders/frag-cook_torrance.frag",
+                                                 "Cook-Torrance Instanced Shader");
+        ResourceManager::GenerateShaderFromFiles("shaders/vert-shader3D_instanced.vert",
+                                                 "shaders/frag-toon.frag",
+                                                 "Toon Instanced Shader");
+
+        // generate multi-draw variants of the 3D shaders (per-draw transforms read at gl_DrawID)
+        ResourceManager::GenerateShaderFromFiles("shaders/vert-shader3D_multidraw.vert",
+                                                 "shaders/frag-blinn_phong.frag",
+                                                 "Blinn-Phong Multi-Draw Shader");
+        ResourceManager::GenerateShaderFromFiles("shaders/vert-shader3D_multidraw.vert",
+                                                 "shaders/frag-cook_torrance.frag",
+                                                 "Cook-Torrance Multi-Draw Shader");
+        ResourceManager::GenerateShaderFromFiles("shaders/vert-shader3D_multidraw.vert",
+                                                 "shaders/frag-toon.frag",
+                                                 "Toon Multi-Draw Shader");
+
+        // generate depth pre-pass shaders (position only)
+        ResourceManager::GenerateShaderFromFiles("shaders/vert-depth_only.vert",
+                                                 "shaders/frag-depth_only.frag",
+                                                 "Depth Only Shader");
+        ResourceManager::GenerateShaderFromFiles("shaders/vert-depth_only_instanced.vert",
+                                                 "shaders/frag-depth_only.frag",
+                                                 "Depth Only Instanced Shader");
+        ResourceManager::GenerateShaderFromFiles("shaders/vert-depth_only_multidraw.vert",
+                                                 "shaders/frag-depth_only.frag",
+                                                 "Depth Only Multi-Draw Shader");
+
         // generate Depth Mapping shader
-        /*ResourceManager::GenerateShaderFromFiles("shaders/vert-geometry_debug.vert",
+        ResourceManager::GenerateShaderFromFiles("shaders/vert-geometry_debug.vert",
                                                  "shaders/frag-depth_mapping.frag",
                                                  "Depth Mapping");
 
         // generate Glassy shader
         ResourceManager::GenerateShaderFromFiles("shaders/vert-shader3D.vert",
                                                  "shaders/frag-glassy.frag",
-                                                 "Glassy Shader");*/
+                                                 "Glassy Shader", {"NORMAL_MAP"});
+        // generate weighted blended transparency shaders (accumulation & composite)
+        ResourceManager::GenerateShaderFromFiles("shaders/vert-shader3D.vert",
+                                                 "shaders/frag-glassy_oit.frag",
+                                                 "Glassy OIT Shader", {"NORMAL_MAP"});
+        ResourceManager::GenerateShaderFromFiles("shaders/vert-fullscreen.vert",
+                                                 "shaders/frag-oit_composite.frag",
+                                                 "OIT Composite Shader");
 
         ResourceManager::GenerateShaderFromFiles("shaders/vert-skybox.vert",
                                                  "shaders/frag-skybox.frag",
                                                  "Skybox Shader");
+        ResourceManager::EndShaderBatch();
+        auto& shaderStats = ResourceManager::GetShaderLoadStats();
+        DEBUG_LOG("Created " + std::to_string(shaderStats.programs) + " shader programs (" +
+                  std::to_string(shaderStats.cachedPrograms) + " from the program binary cache) in " +
+                  std::to_string(shaderStats.milliseconds) + " ms.")
 
-        glDisable(GL_CULL_FACE);
+        GLStateCache::Disable(GL_CULL_FACE);
     }
 
-    void RenderingSystem::BuildLightGrid() {
-        LightGrid.clear();
+    void RenderingSystem::UpdateLightGrid() {
+        // the grid only serves the per-object fallback; it catches up on all changes once needed again.
+        if(clusteredLightingEnabled || !engine.componentManager.hasComponentOfType<PointLight>())
+            return;
 
-        if(engine.componentManager.hasComponentOfType<PointLight>()){
-            engine.componentManager.forEachComponent<PointLight>([&](PointLight& light){
-                auto pos = light.position();
-                Vector2 cell = WorldToCell(pos);
-                LightGrid[cell].push_back(light.GetOwner());
-            });
+        lightGrid.BeginUpdate();
+        engine.componentManager.forEachComponent<PointLight>([&](PointLight& light){
+            if(!light.isDeleted())
+                lightGrid.Track(light);
+        });
+        lightGrid.EndUpdate();
+    }
+
+    void RenderingSystem::CollectVisibleObjects() {
+        auto& sceneIndex = engine.GetSceneIndex();
+        sceneIndex.Update();
+        visibleObjects.clear();
+
+        if(frustumCullingEnabled){
+            sceneIndex.QueryFrustum(frustum, visibleObjects);
+            cullingStats.tested = sceneIndex.GetRenderableCount();
+            cullingStats.culled = cullingStats.tested - (int) visibleObjects.size();
         }
+        else
+            sceneIndex.GetRenderables(visibleObjects);
+
+        // restore the component manager's draw order.
+        std::sort(visibleObjects.begin(), visibleObjects.end(), [](const SceneObject* a, const SceneObject* b){
+            return std::tie(a->type, a->owner) < std::tie(b->type, b->owner);
+        });
     }
 
-    std::vector<int> RenderingSystem::QueryNearbyLights(const glm::vec3& objectPos) {
-        Vector2 c = WorldToCell(objectPos);
+    void RenderingSystem::CullOccludedObjects() {
+        if(!occlusionCullingEnabled || Occluders.empty())
+            return;
 
-        std::vector<int> result;
-        result.reserve(16); // fast
+        occlusionCuller.BeginFrame(camera->GetVPMatrix());
+        for(auto occluder : Occluders){
+            auto mesh = occluder->GetComponent<Mesh3D>();
+            if(!mesh)
+                continue;
+            // the full detail mesh: simplified levels may bulge past the surface & hide visible objects.
+            const auto& indices = mesh->primitive.indices;
+            occlusionCuller.AddOccluder(mesh->primitive.GetPositionData(), indices.data(), indices.size(),
+                                        occluder->transform->GetModelMatrix());
+        }
+        occlusionCuller.Resolve(&ThreadPool::Global());
+
+        // only 3D meshes are tested; flat meshes & sprites are cheap and often drawn on top of the scene.
+        occlusionBoxes.clear();
+        for(auto object : visibleObjects)
+            if(object->type == SceneObjectType::Mesh3D)
+                occlusionBoxes.push_back(object->bounds.box);
+        occlusionVisibility.resize(occlusionBoxes.size());
+        occlusionCuller.CullAABBs(occlusionBoxes.data(), occlusionBoxes.size(), occlusionVisibility.data(),
+                                  &ThreadPool::Global());
+
+        // compact in place, keeping the draw order.
+        size_t kept = 0, box = 0;
+        for(auto object : visibleObjects)
+            if(object->type != SceneObjectType::Mesh3D || occlusionVisibility[box++])
+                visibleObjects[kept++] = object;
+        visibleObjects.resize(kept);
+        cullingStats.occluded = (int) occlusionCuller.GetStats().occluded;
+    }
 
-        for (int dx = -1; dx <= 1; dx++) {
-            for (int dz = -1; dz <= 1; dz++) {
-                Vector2 nc{ c.x + dx, c.y + dz };
+    void RenderingSystem::CollectLitObjects() {
+        litObjects.clear();
+
+        for(auto loader : Loaders){
+            auto loaderPos = loader->transform->GetGlobalPosition();
+            queryResults.clear();
+            engine.GetSceneIndex().QuerySphere({loaderPos, DIST_THRESHOLD}, queryResults);
+            for(auto object : queryResults){
+                if(object->type != SceneObjectType::Mesh3D)
+                    continue;
+                if(Vector3::Distance(loaderPos, object->transform->GetGlobalPosition()) < DIST_THRESHOLD)
+                    litObjects.insert(object->component);
+            }
+        }
+    }
 
-                auto it = LightGrid.find(nc);
-                if (it != LightGrid.end()) {
-                    const auto& list = it->second;
-                    result.insert(result.end(), list.begin(), list.end());
-                }
+    void RenderingSystem::BuildLightClusters() {
+        if(!clusteredLightingEnabled)
+            return;
+
+        // only lights whose range reaches into the view frustum can affect visible fragments.
+        lightQueryResults.clear();
+        engine.GetSceneIndex().QueryLights(frustum, lightQueryResults);
+        clusterLightData.clear();
+        clusterLightData.reserve(lightQueryResults.size());
+        for(auto light : lightQueryResults){
+            auto pos = light->position();
+            auto emission = light->GetEmission();
+            clusterLightData.push_back({glm::vec4(pos.x, pos.y, pos.z, light->GetRange()),
+                                        glm::vec4(emission.x, emission.y, emission.z, light->GetIntensity())});
+        }
+
+        // a full cluster keeps the lights given first; with a limit, those are the most intense ones.
+        if(lightClusters.GetMaxLightsPerCluster() > 0)
+            std::sort(clusterLightData.begin(), clusterLightData.end(), [](const ClusterLight& a, const ClusterLight& b){
+                return a.emissionIntensity.w > b.emissionIntensity.w;
+            });
+        lightClusters.SetProjection(camera->GetProjectionMatrix());
+        lightClusters.Assign(camera->CalculateViewMatrix(), clusterLightData, &ThreadPool::Global());
+        if(!ctx::Context::HasGraphics())
+            return;
+
+        const auto& indices = lightClusters.GetIndices();
+        const auto& ranges = lightClusters.GetRanges();
+        UploadStorageBuffer(clusterSSBO[0], 0, clusterLightData.data(), clusterLightData.size() * sizeof(ClusterLight));
+        UploadStorageBuffer(clusterSSBO[1], 1, indices.data(), indices.size() * sizeof(uint32_t));
+        UploadStorageBuffer(clusterSSBO[2], 2, ranges.data(), ranges.size() * sizeof(ClusterRange));
+        GLStateCache::BindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        DEBUG_OPENGL("Light Clusters")
+    }
+
+    void RenderingSystem::ApplyClusterData(Shader* activeShader) const {
+        activeShader->setInt("clustered", clusteredLightingEnabled ? 1 : 0);
+        if(!clusteredLightingEnabled)
+            return;
+
+        activeShader->setVector("clusterDims", glm::vec3(lightClusters.GetDimensions()));
+        activeShader->setVector("clusterSlices", lightClusters.GetSliceParameters());
+        activeShader->setVector("screenSize", (glm::vec2) GetRenderTargetSize());
+        activeShader->setMatrix("view", camera->CalculateViewMatrix());
+    }
+
+    int RenderingSystem::CollectLights(const Mesh3D& mesh, const Vector3& pos, PointLight** out) const {
+        // if not within range of any LOD object, default to ambient.
+        if(litObjects.count(&mesh) == 0)
+            return -1;
+        // lights are looked up per fragment from the light clusters.
+        if(clusteredLightingEnabled)
+            return 0;
+
+        std::array<LightCandidate, MAX_LIGHT_CANDIDATES> candidates;
+        return lightGrid.QueryNearest(pos, MAX_LIGHTS, candidates.data(), (int) candidates.size(), out);
+    }
+
+    Shader* RenderingSystem::Prepare3DShader(const std::string& shaderName, uint32_t keywords) const {
+        if(!ctx::Context::HasGraphics())
+            return nullptr;
+
+        auto activeShader = ResourceManager::GetShaderVariant(shaderName, KeywordDefines(keywords));
+        activeShader->Apply(camera);
+        activeShader->setFloat("ambient", ambient);
+        activeShader->setFloat("specular", specularFactor);
+        activeShader->setInt("n_levels", n_toon_levels);
+        ApplyClusterData(activeShader);
+        return activeShader;
+    }
+
+    uint32_t RenderingSystem::GetShaderKeywords(Renderer* renderer, bool lit) const {
+        // unlit meshes skip all lighting, normal mapping included.
+        if(!lit)
+            return KEYWORD_UNLIT;
+        auto normalMap = renderer ? renderer->GetNormalMap() : nullptr;
+        return normalMap && normalMap != defaultNormalMap ? KEYWORD_NORMAL_MAP : KEYWORDS_NONE;
+    }
+
+    FrameParameters RenderingSystem::GetFrameParameters() const {
+        FrameParameters parameters;
+        parameters.vp = camera->GetVPMatrix();
+        parameters.cameraPosition = camera->transform->GetGlobalPosition();
+        parameters.screenSize = (glm::vec2) GetRenderTargetSize();
+        parameters.ambient = ambient;
+        parameters.specular = specularFactor;
+        parameters.toonLevels = n_toon_levels;
+        parameters.shader = GetShadingModel();
+        parameters.frameLights = clusteredLightingEnabled ? &clusterLightData : nullptr;
+        return parameters;
+    }
+
+    void RenderingSystem::CollectMeshes(std::vector<Mesh3D*>& opaqueMeshes, std::vector<Mesh3D*>& transparentMeshes) {
+        auto projection = camera->GetProjectionMatrix();
+        lodOrthographic = projection[3][3] > 0.5f;
+        lodPixelsPerUnit = projection[1][1] * GetRenderTargetSize().y * 0.5f;
+        lodViewPosition = camera->transform->GetGlobalPosition();
+        opaqueDistances.clear();
+
+        if(!engine.componentManager.hasComponentOfType<Mesh3D>())
+            return;
+
+        for(auto object : visibleObjects){
+            if(object->type != SceneObjectType::Mesh3D)
+                continue;
+            auto& mesh = *static_cast<Mesh3D*>(object->component);
+            // don't render skybox object.
+            if(skybox != nullptr && *mesh.entity() == *skybox)
+                continue;
+            SelectLOD(mesh, *object);
+
+            auto renderer = mesh.entity()->GetComponent<Renderer>();
+            // early exit if transparent mesh (separate shaders).
+            if(renderer && renderer->material->GetOpacity() != 1.0f){
+                transparentMeshes.emplace_back(&mesh);
+                continue;
             }
+
+            opaqueMeshes.emplace_back(&mesh);
+            auto offset = object->bounds.sphere.center - lodViewPosition;
+            opaqueDistances.push_back(glm::dot(offset, offset));
         }
+    }
+
+    void RenderingSystem::SortFrontToBack(std::vector<Mesh3D *> &opaqueMeshes) {
+        drawOrder.resize(opaqueMeshes.size());
+        for(size_t i = 0; i < opaqueMeshes.size(); i++)
+            drawOrder[i] = {OrderedFloatBits(opaqueDistances[i]), (uint32_t) i};
+        RadixSort(drawOrder, drawOrderScratch);
 
-        return result;
+        sortedMeshes.resize(opaqueMeshes.size());
+        for(size_t i = 0; i < drawOrder.size(); i++)
+            sortedMeshes[i] = opaqueMeshes[drawOrder[i].index];
+        opaqueMeshes.swap(sortedMeshes);
+    }
+
+    void RenderingSystem::SelectLOD(Mesh3D& mesh, const SceneObject& object) const {
+        if(mesh.GetLODCount() <= 1)
+            return;
+        auto threshold = quality.lodErrorThreshold;
+        if(threshold <= 0.0f){
+            mesh.SetLODLevel(0);
+            return;
+        }
+
+        // the model's scale, recovered from its model & world space bounding spheres.
+        const auto& sphere = object.bounds.sphere;
+        auto localRadius = mesh.primitive.localBounds.sphere.radius;
+        auto scale = localRadius > 0.0f ? sphere.radius / localRadius : 1.0f;
+        auto pixelsPerUnit = lodPixelsPerUnit * scale;
+        if(!lodOrthographic){
+            auto distance = glm::length(sphere.center - lodViewPosition) - sphere.radius;
+            pixelsPerUnit /= std::max(distance, 0.001f);
+        }
+
+        // refine as soon as the error becomes visible, but only coarsen once well below the threshold
+        // so that objects near a boundary do not switch back and forth.
+        auto level = mesh.GetLODLevel();
+        while(level > 0 && mesh.GetLOD(level).error * pixelsPerUnit > threshold)
+            level--;
+        while(level + 1 < mesh.GetLODCount() &&
+              mesh.GetLOD(level + 1).error * pixelsPerUnit < threshold * (1.0f - LOD_HYSTERESIS))
+            level++;
+        mesh.SetLODLevel(level);
     }
 
     void RenderingSystem::PrepareDraw(Mesh3D& mesh, Shader* activeShader){
@@ -273,193 +667,559 @@ struct Entry{
         activeShader->setMatrix("mvp", activeShader->CalculateMVPMatrix(model));
         // model matrices
         activeShader->setMatrix("model", model);
-        auto normalMat = glm::mat3(model);
-        // if mat is inversible, apply inverse transposed matrix
-        normalMat = glm::transpose(glm::inverse(glm::mat3(model)));
-        if(abs(glm::determinant(model)) < 1e-6f) {
-            // normalize matrix to kill scale variance
-            normalMat[0] = glm::normalize(normalMat[0]);
-            normalMat[1] = glm::normalize(normalMat[1]);
-            normalMat[2] = glm::normalize(normalMat[2]);
-        }
-        activeShader->setMatrix("normalMat", normalMat);
-
+        activeShader->setMatrix("normalMat", CalculateNormalMatrix(model));
 
         // material
         auto renderer = mesh.entity()->GetComponent<Renderer>();
         if(renderer)
             renderer->ApplyData(*activeShader);
 
-        // lighting x LOD
-        auto pos = mesh.entity()->transform->GetGlobalPosition();
-        //pos.y = 2;
-        float lodDist = 100000000000000000.0f;
-        if(!Loaders.empty())
-            for(auto obj : Loaders){
-                auto objPos = obj->transform->GetGlobalPosition();
-                //objPos.y = 2;
-                lodDist = std::min(lodDist, Vector3::Distance(objPos, pos));
+        LightBlock lights;
+        lights.count = CollectLights(mesh, mesh.entity()->transform->GetGlobalPosition(), lights.lights.data());
+        GLRenderBackend::ApplyLights(*activeShader, lights);
+    }
+
+    void RenderingSystem::SubmitOpaque(const std::vector<OpaqueSubmission>& submissions, Shader* depthShader) {
+        // switches programs only between lists of different shader variants.
+        auto submitLit = [&](){
+            Shader* current = nullptr;
+            for(const auto& [list, shader] : submissions){
+                if(shader && shader != current){
+                    shader->Use();
+                    current = shader;
+                }
+                backend->Submit(*list, shader);
             }
+        };
+        if(!depthShader){
+            submitLit();
+            return;
+        }
 
-        // if dist to any LOD object < dist threshold
-        // compute lighting
-        if(lodDist < DIST_THRESHOLD){
-            activeShader->setInt("LOD", 1);
+        auto& queries = prePassQueries[prePassQueryFrame];
+        CollectPrePassQueries(prePassQueryFrame);
+
+        // fill the depth buffer without writing colors...
+        glBeginQuery(GL_TIME_ELAPSED, queries.ids[0]);
+        glBeginQuery(GL_SAMPLES_PASSED, queries.ids[1]);
+        GLStateCache::ColorMask(false);
+        depthShader->Use();
+        for(const auto& submission : submissions)
+            backend->SubmitDepth(*submission.list, depthShader);
+        GLStateCache::ColorMask(true);
+        glEndQuery(GL_SAMPLES_PASSED);
+        glEndQuery(GL_TIME_ELAPSED);
+
+        // ...so that only the nearest surface of every pixel passes & is shaded.
+        glBeginQuery(GL_TIME_ELAPSED, queries.ids[2]);
+        glBeginQuery(GL_SAMPLES_PASSED, queries.ids[3]);
+        GLStateCache::DepthFunc(GL_EQUAL);
+        GLStateCache::DepthMask(false);
+        submitLit();
+        GLStateCache::DepthMask(true);
+        GLStateCache::DepthFunc(GL_LESS);
+        glEndQuery(GL_SAMPLES_PASSED);
+        glEndQuery(GL_TIME_ELAPSED);
+
+        queries.issued = true;
+        prePassQueryFrame = (prePassQueryFrame + 1) % prePassQueries.size();
+        DEBUG_OPENGL("Depth Pre-Pass")
+    }
+
+    void RenderingSystem::CollectPrePassQueries(size_t frame) {
+        auto& queries = prePassQueries[frame];
+        if(!queries.issued)
+            return;
+        queries.issued = false;
+        // the lit pass' sample count ends last; if it is not ready, drop the frame instead of waiting.
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(queries.ids[3], GL_QUERY_RESULT_AVAILABLE, &available);
+        if(!available)
+            return;
+
+        std::array<GLuint64, 4> results = {};
+        for(size_t i = 0; i < results.size(); i++)
+            glGetQueryObjectui64v(queries.ids[i], GL_QUERY_RESULT, &results[i]);
+        prePassStats.prePassTime = (double) results[0] * 1e-6;
+        prePassStats.prePassSamples = results[1];
+        prePassStats.shadingTime = (double) results[2] * 1e-6;
+        prePassStats.shadedSamples = results[3];
+    }
+
+    void RenderingSystem::DrawRecorded(std::vector<Mesh3D*>& meshes, const std::string& shaderName,
+                                       Shader* depthShader) {
+        if(meshes.empty())
+            return;
+
+        // group the meshes by shader variant, keeping their order within each group.
+        meshKeywords.resize(meshes.size());
+        std::array<size_t, SHADER_VARIANT_COUNT + 1> offsets = {};
+        for(size_t i = 0; i < meshes.size(); i++){
+            auto mesh = meshes[i];
+            meshKeywords[i] = GetShaderKeywords(mesh->entity()->GetComponent<Renderer>(), litObjects.count(mesh) > 0);
+            offsets[meshKeywords[i] + 1]++;
+        }
+        for(size_t v = 0; v < SHADER_VARIANT_COUNT; v++)
+            offsets[v + 1] += offsets[v];
+        variantMeshes.resize(meshes.size());
+        auto cursors = offsets;
+        for(size_t i = 0; i < meshes.size(); i++)
+            variantMeshes[cursors[meshKeywords[i]]++] = meshes[i];
+
+        // chunks never span two variants, so that every list is drawn with a single shader.
+        recordChunks.clear();
+        for(uint32_t v = 0; v < SHADER_VARIANT_COUNT; v++)
+            for(auto begin = offsets[v]; begin < offsets[v + 1]; begin += RECORD_CHUNK_SIZE)
+                recordChunks.push_back({begin, std::min(offsets[v + 1], begin + RECORD_CHUNK_SIZE), v});
+        if(commandLists.size() < recordChunks.size())
+            commandLists.resize(recordChunks.size());
+
+        auto vp = camera->GetVPMatrix();
+        // each chunk records into its own list, so workers never share state.
+        ThreadPool::Global().ParallelFor(recordChunks.size(), [&](size_t begin, size_t end){
+            for(auto c = begin; c < end; c++){
+                auto& list = commandLists[c];
+                list.Clear();
+                for(auto i = recordChunks[c].begin; i < recordChunks[c].end; i++)
+                    RecordMesh(*variantMeshes[i], vp, list);
+            }
+        });
+
+        // replay in chunk order to keep the draw order deterministic.
+        std::array<Shader*, SHADER_VARIANT_COUNT> shaders = {};
+        opaqueSubmissions.clear();
+        for(size_t c = 0; c < recordChunks.size(); c++){
+            auto& shader = shaders[recordChunks[c].keywords];
+            if(!shader)
+                shader = Prepare3DShader(shaderName, recordChunks[c].keywords);
+            opaqueSubmissions.push_back({&commandLists[c], shader});
+        }
+        SubmitOpaque(opaqueSubmissions, depthShader);
+    }
+
+    void RenderingSystem::RecordMesh(Mesh3D& mesh, const glm::mat4& vp, RenderCommandList& list) const {
+        auto entity = mesh.entity();
+        auto model = entity->transform->GetModelMatrix();
+        list.SetTransform({vp * model, model, CalculateNormalMatrix(model)});
+
+        auto renderer = entity->GetComponent<Renderer>();
+        if(renderer)
+            list.SetMaterial(renderer);
 
-            // get lights in grid
-            auto results = QueryNearbyLights(pos);
-            std::vector<Entry> list;
-            list.reserve(results.size());
+        LightBlock lights;
+        lights.count = CollectLights(mesh, entity->transform->GetGlobalPosition(), lights.lights.data());
+        list.SetLights(lights);
+        list.DrawMesh(&mesh);
+    }
 
-            // for each entry in the results, create an Entry object
-            for (int id : results) {
-                auto* e = engine.entityManager.getEntity(id);
-                if (!e) continue;
+    void RenderingSystem::DrawInstanced(std::vector<Mesh3D*>& opaqueMeshes, const std::string& shaderName,
+                                        Shader* depthShader) {
+        if(opaqueMeshes.empty())
+            return;
 
-                auto* L = e->GetComponent<PointLight>();
-                if (!L) continue;
+        if(depthShader){
+            depthShader->Use();
+            depthShader->setMatrix("vp", camera->GetVPMatrix());
+        }
 
-                float d2 = Vector3::Distance(L->position(), pos);
-                list.push_back({L, d2});
+        // build a batch key for each mesh on worker threads & sort so that batches are contiguous.
+        std::vector<BatchEntry> entries(opaqueMeshes.size());
+        ThreadPool::Global().ParallelFor(opaqueMeshes.size(), [&](size_t begin, size_t end){
+            for(auto i = begin; i < end; i++){
+                auto mesh = opaqueMeshes[i];
+                auto& entry = entries[i];
+                entry = {{}, mesh, mesh->entity()->GetComponent<Renderer>(), (uint32_t) i};
+                entry.key.indexType = mesh->GetIndexType();
+                entry.key.geometry = mesh->GetGeometryID();
+                entry.key.lod = mesh->GetLODLevel();
+                if(entry.renderer){
+                    auto& mat = *entry.renderer->material;
+                    const auto& diffuse = mat.GetDiffuse();
+                    entry.key.diffuseTex = entry.renderer->GetDiffuseTexture();
+                    entry.key.normalMap = entry.renderer->GetNormalMap();
+                    entry.key.material = {diffuse.x, diffuse.y, diffuse.z, mat.GetOpacity(),
+                                          mat.GetTiling(), mat.GetMetallic(), mat.GetRoughness()};
+                }
+                entry.key.nLights = CollectLights(*mesh, mesh->entity()->transform->GetGlobalPosition(),
+                                                  entry.key.lights.data());
+                entry.key.keywords = GetShaderKeywords(entry.renderer, entry.key.nLights >= 0);
             }
+        }, RECORD_CHUNK_SIZE);
+        auto byKey = [](const BatchEntry& a, const BatchEntry& b){ return a.key < b.key;};
+        // with a pre-pass, the meshes are sorted front to back: keep that order within each batch.
+        if(depthShader)
+            std::stable_sort(entries.begin(), entries.end(), byKey);
+        else
+            std::sort(entries.begin(), entries.end(), byKey);
+
+        // compute per-instance data of all batches on worker threads, then upload it at once.
+        instanceData.resize(entries.size());
+        ThreadPool::Global().ParallelFor(entries.size(), [&](size_t begin, size_t end){
+            for(auto i = begin; i < end; i++){
+                auto model = entries[i].mesh->entity()->transform->GetModelMatrix();
+                instanceData[i] = {model, CalculateNormalMatrix(model)};
+            }
+        }, RECORD_CHUNK_SIZE);
 
-            // sort entries by distance
-            std::sort(list.begin(), list.end(),
-                      [](auto& a, auto& b){ return a.dist2 < b.dist2; });
+        backend->UploadInstances(instanceData);
 
-            // resize list to acceptable size
-            if (list.size() > MAX_LIGHTS)
-                list.resize(MAX_LIGHTS);
+        // a multi-draw covers all meshes sharing the state, whatever their geometry.
+        auto sameBatch = [&](const BatchEntry& a, const BatchEntry& b){
+            return multiDrawEnabled ? a.key.state() == b.key.state() : a.key == b.key;
+        };
+        batchRanges.clear();
+        size_t first = 0;
+        while(first < entries.size()){
+            size_t last = first + 1;
+            while(last < entries.size() && sameBatch(entries[last], entries[first]))
+                last++;
+            batchRanges.emplace_back(first, last);
+            first = last;
+        }
+        // draw the batches in the order of their nearest instance.
+        if(depthShader)
+            std::sort(batchRanges.begin(), batchRanges.end(), [&](const auto& a, const auto& b){
+                return entries[a.first].order < entries[b.first].order;
+            });
 
-            // unwrap
-            for (int i = 0; i < list.size(); i++)
-                list[i].L->Apply(*activeShader, i);
-            activeShader->setInt("nLights", (int) list.size());
+        if(multiDrawEnabled){
+            multiDrawMeshes.resize(entries.size());
+            for(size_t i = 0; i < entries.size(); i++)
+                multiDrawMeshes[i] = entries[i].mesh;
         }
-        else{
-            // else default to ambient.
-            activeShader->setInt("LOD", 0);
+
+        // one list per shader variant.
+        for(auto& list : instancedCommands)
+            list.Clear();
+        for(const auto& [begin, end] : batchRanges){
+            auto& batch = entries[begin];
+            auto& list = instancedCommands[batch.key.keywords];
+            if(batch.renderer)
+                list.SetMaterial(batch.renderer);
+            list.SetLights({batch.key.nLights, batch.key.lights});
+            if(multiDrawEnabled)
+                list.DrawMeshes(multiDrawMeshes.data() + begin, (int) (end - begin), (int) begin);
+            else
+                list.DrawMesh(batch.mesh, (int) (end - begin), (int) begin);
         }
 
-        activeShader->setInt("n_levels", n_toon_levels);
+        opaqueSubmissions.clear();
+        for(uint32_t v = 0; v < SHADER_VARIANT_COUNT; v++){
+            if(instancedCommands[v].Size() == 0)
+                continue;
+            auto activeShader = Prepare3DShader(shaderName, v);
+            if(activeShader)
+                activeShader->setMatrix("vp", camera->GetVPMatrix());
+            opaqueSubmissions.push_back({&instancedCommands[v], activeShader});
+        }
+        SubmitOpaque(opaqueSubmissions, depthShader);
     }
 
-    void RenderingSystem::DrawTransparentObjects(std::vector<Mesh3D *> &transparentMeshes, Shader* activeShader) {
-        activeShader = ResourceManager::GetShader(shaderNameDict.at("Depth"));
+    Shader* RenderingSystem::PrepareTransparencyShader(const std::string& shaderName) const {
+        auto activeShader = Prepare3DShader(shaderName);
+        auto dims = GetRenderTargetSize();
+        activeShader->setInt("screenWidth", (int) dims.x);
+        activeShader->setInt("screenHeight", (int) dims.y);
+        activeShader->setVector("eta", eta);
+
+        // apply cubemap
+        auto renderer = skybox->GetComponent<CubemapRenderer>();
+        renderer->ApplyData(*activeShader);
+        return activeShader;
+    }
+
+    void RenderingSystem::SortTransparentMeshes(std::vector<Mesh3D *> &transparentMeshes, const glm::mat4 &view) {
+        drawOrder.resize(transparentMeshes.size());
+        for(size_t i = 0; i < transparentMeshes.size(); i++){
+            auto mesh = transparentMeshes[i];
+            auto center = mesh->primitive.localBounds.sphere.center;
+            auto viewPos = view * mesh->entity()->transform->GetModelMatrix() * glm::vec4(center, 1.0f);
+            // the camera looks down -z: ascending z runs from the farthest mesh to the nearest.
+            drawOrder[i] = {OrderedFloatBits(viewPos.z), (uint32_t) i};
+        }
+        RadixSort(drawOrder, drawOrderScratch);
+
+        sortedMeshes.resize(transparentMeshes.size());
+        for(size_t i = 0; i < drawOrder.size(); i++)
+            sortedMeshes[i] = transparentMeshes[drawOrder[i].index];
+        transparentMeshes.swap(sortedMeshes);
+    }
+
+    void RenderingSystem::DrawThicknessPass(const std::vector<Mesh3D *> &transparentMeshes, const glm::mat4 &view,
+                                            GLenum culledFace) {
+        auto activeShader = ResourceManager::GetShader("Depth Mapping");
         activeShader->Apply(camera);
-        activeShader->setFloat("ambient", ambient);
-        activeShader->setFloat("specular", specularFactor);
 
-        // bind thickness fbo
-        // clear color & depth
-        // cull front faces
-        glBindFramebuffer(GL_FRAMEBUFFER, FBO[0]);
+        GLStateCache::Enable(GL_CULL_FACE);
+        GLStateCache::CullFace(culledFace);
+        GLStateCache::Disable(GL_BLEND);
+        GLStateCache::DepthMask(true);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_FRONT);
-        glDisable(GL_BLEND);
-        glDepthMask(GL_TRUE);
-
-        for(auto mesh: transparentMeshes){
-            // I think I just need geometry for this one; Edit to fit.
-            // PrepareDraw(*mesh, activeShader);
-            auto model = mesh->entity()->transform->GetModelMatrix();
+        // nearest first, so that the depth test rejects hidden fragments early.
+        for(auto it = transparentMeshes.rbegin(); it != transparentMeshes.rend(); ++it){
+            auto model = (*it)->entity()->transform->GetModelMatrix();
             activeShader->setMatrix("mvp", activeShader->CalculateMVPMatrix(model));
-            auto view = camera->CalculateViewMatrix();
             activeShader->setMatrix("mv", view * model);
-            mesh->draw(activeShader->GetShaderID());
+            (*it)->draw(activeShader->GetShaderID());
         }
 
-        glBindFramebuffer(GL_FRAMEBUFFER, FBO[1]);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glCullFace(GL_BACK);
-        // redo a second pass for front face.
+        GLStateCache::Disable(GL_CULL_FACE);
+        GLStateCache::CullFace(GL_BACK);
+    }
+
+    void RenderingSystem::DrawSorted(const std::vector<Mesh3D *> &transparentMeshes, GLuint backFaceDepth,
+                                     GLuint frontFaceDepth) {
+        GLStateCache::Enable(GL_BLEND);
+        GLStateCache::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        GLStateCache::Enable(GL_DEPTH_TEST);
+        // turn off depth writing
+        GLStateCache::DepthMask(false);
 
+        auto activeShader = PrepareTransparencyShader("Glassy Shader");
+        GLStateCache::BindTexture(UniformSamplerIndices::DEPTH_BACK_FACE, GL_TEXTURE_2D, backFaceDepth);
+        GLStateCache::BindTexture(UniformSamplerIndices::DEPTH_FRONT_FACE, GL_TEXTURE_2D, frontFaceDepth);
+
+        // back to front, so that nearer surfaces blend over farther ones.
         for(auto mesh: transparentMeshes){
-            // I think I just need geometry for this one; Edit to fit.
-            // PrepareDraw(*mesh, activeShader);
-            auto model = mesh->entity()->transform->GetModelMatrix();
-            activeShader->setMatrix("mvp", activeShader->CalculateMVPMatrix(model));
-            auto view = camera->CalculateViewMatrix();
-            activeShader->setMatrix("mv", view * model);
+            PrepareDraw(*mesh, activeShader);
             mesh->draw(activeShader->GetShaderID());
         }
 
-        // bind "base" fbo (none)
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glEnable(GL_DEPTH_TEST);
-        // turn off depth writing
-        glDepthMask(GL_FALSE);
-        glDisable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
+        GLStateCache::DepthMask(true);
+        GLStateCache::Disable(GL_BLEND);
+    }
+
+    void RenderingSystem::AddSortedPasses(std::vector<Mesh3D *> &transparentMeshes, RenderResource scene) {
+        // the view is the same for all meshes & passes of the frame.
+        auto view = camera->CalculateViewMatrix();
+        SortTransparentMeshes(transparentMeshes, view);
+
+        auto targetSize = GetThicknessTargetSize(GetRenderTargetSize());
+        auto width = (int) targetSize.x, height = (int) targetSize.y;
+        // back faces (front faces culled) into the first texture, front faces into the second.
+        const std::array<GLenum, 2> culledFaces = {GL_FRONT, GL_BACK};
+        const std::array<std::string, 2> passNames = {"Thickness Back Faces", "Thickness Front Faces"};
+        std::array<RenderResource, 2> faceDepth = {};
+        for(size_t pass = 0; pass < faceDepth.size(); pass++){
+            renderGraph.AddPass(passNames[pass], [&](RenderPassBuilder& builder){
+                faceDepth[pass] = builder.Create(passNames[pass], {width, height, GL_R32F});
+                // only needed within a pass, so both passes share the same depth buffer.
+                builder.Create("Thickness Depth", {width, height, GL_DEPTH_COMPONENT24});
+            }, [this, &transparentMeshes, view, culledFace = culledFaces[pass]](const RenderGraph&){
+                DrawThicknessPass(transparentMeshes, view, culledFace);
+            });
+        }
+
+        renderGraph.AddPass("Sorted Transparency", [&](RenderPassBuilder& builder){
+            builder.Read(faceDepth[0]);
+            builder.Read(faceDepth[1]);
+            builder.Write(scene);
+        }, [this, &transparentMeshes, faceDepth](const RenderGraph& graph){
+            DrawSorted(transparentMeshes, graph.GetTexture(faceDepth[0]), graph.GetTexture(faceDepth[1]));
+        });
+    }
 
-        activeShader = ResourceManager::GetShader(shaderNameDict.at("Glassy"));
+    void RenderingSystem::DrawWeightedBlended(const std::vector<Mesh3D *> &transparentMeshes, GLuint opaqueFramebuffer,
+                                              int width, int height) {
+        // test against the opaque scene's depth without writing to it.
+        GLStateCache::BindFramebuffer(GL_READ_FRAMEBUFFER, opaqueFramebuffer);
+        glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+        const GLfloat clearAccumulation[] = {0.0f, 0.0f, 0.0f, 0.0f};
+        const GLfloat clearRevealage[] = {1.0f, 0.0f, 0.0f, 0.0f};
+        glClearBufferfv(GL_COLOR, 0, clearAccumulation);
+        glClearBufferfv(GL_COLOR, 1, clearRevealage);
+
+        GLStateCache::Enable(GL_DEPTH_TEST);
+        GLStateCache::DepthMask(false);
+        GLStateCache::Disable(GL_CULL_FACE);
+        GLStateCache::Enable(GL_BLEND);
+        GLStateCache::BlendFunci(0, GL_ONE, GL_ONE);
+        GLStateCache::BlendFunci(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+
+        // a single unsorted pass; the thickness is estimated from the bounds instead of measured.
+        auto activeShader = PrepareTransparencyShader("Glassy OIT Shader");
+        for(auto mesh: transparentMeshes){
+            PrepareDraw(*mesh, activeShader);
+            auto bounds = mesh->primitive.localBounds.sphere.Transformed(mesh->entity()->transform->GetModelMatrix());
+            activeShader->setFloat("thickness", bounds.radius * MEAN_CHORD_FACTOR);
+            mesh->draw(activeShader->GetShaderID());
+        }
+    }
+
+    void RenderingSystem::CompositeWeightedBlended(GLuint accumulation, GLuint revealage) {
+        // composite the weighted average color over the screen.
+        GLStateCache::Disable(GL_DEPTH_TEST);
+        GLStateCache::Enable(GL_BLEND);
+        GLStateCache::BlendFunc(GL_ONE_MINUS_SRC_ALPHA, GL_SRC_ALPHA);
+        auto activeShader = ResourceManager::GetShader("OIT Composite Shader");
         activeShader->Apply(camera);
-        activeShader->setFloat("ambient", ambient);
-        activeShader->setFloat("specular", specularFactor);
+        GLStateCache::BindTexture(UniformSamplerIndices::OIT_ACCUMULATION, GL_TEXTURE_2D, accumulation);
+        GLStateCache::BindTexture(UniformSamplerIndices::OIT_REVEALAGE, GL_TEXTURE_2D, revealage);
+        GLStateCache::BindVertexArray(VAO.back());
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+
+        GLStateCache::Enable(GL_DEPTH_TEST);
+        GLStateCache::DepthMask(true);
+        GLStateCache::Disable(GL_BLEND);
+    }
 
-        auto dims = engine.context.GetWindowSize();
-        activeShader->setInt("screenWidth", (int) dims.x);
-        activeShader->setInt("screenHeight", (int) dims.y);
-        activeShader->setVector("eta", eta);
+    void RenderingSystem::AddWeightedBlendedPasses(const std::vector<Mesh3D *> &transparentMeshes,
+                                                   RenderResource scene) {
+        // the targets match the scene's framebuffer (not the window), so that its depth can be blitted in.
+        auto viewport = GLStateCache::GetViewport();
+        auto width = viewport[2], height = viewport[3];
+
+        RenderResource accumulation = 0, revealage = 0;
+        renderGraph.AddPass("Weighted Blended Accumulation", [&](RenderPassBuilder& builder){
+            // weighted premultiplied color & weight, then the product of (1 - alpha) of all covering surfaces.
+            accumulation = builder.Create("Accumulation", {width, height, GL_RGBA16F});
+            revealage = builder.Create("Revealage", {width, height, GL_R16F});
+            // the opaque scene's depth is blitted in, which requires the default framebuffer's format.
+            builder.Create("Transparency Depth", {width, height, GL_DEPTH24_STENCIL8});
+            builder.Read(scene);
+        }, [this, &transparentMeshes, scene, width, height](const RenderGraph& graph){
+            DrawWeightedBlended(transparentMeshes, graph.GetFramebuffer(scene), width, height);
+        });
 
+        renderGraph.AddPass("Weighted Blended Composite", [&](RenderPassBuilder& builder){
+            builder.Read(accumulation);
+            builder.Read(revealage);
+            builder.Write(scene);
+        }, [this, accumulation, revealage](const RenderGraph& graph){
+            CompositeWeightedBlended(graph.GetTexture(accumulation), graph.GetTexture(revealage));
+        });
+    }
+
+    void RenderingSystem::DrawTransparentObjects(std::vector<Mesh3D *> &transparentMeshes) {
+        // translucent meshes reflect & refract the skybox; without one, there is nothing to draw them with.
         if(skybox == nullptr)
             return;
 
-        // apply cubemap
-        auto renderer = skybox->GetComponent<CubemapRenderer>();
-        renderer->ApplyData(*activeShader);
-
-        // bind back depth texture
-        glActiveTexture(GL_TEXTURE0 + UniformSamplerIndices::DEPTH_BACK_FACE);
-        glBindTexture(GL_TEXTURE_2D, depthTex[0]);
-        // bind front depth texture
-        glActiveTexture(GL_TEXTURE0 + UniformSamplerIndices::DEPTH_FRONT_FACE);
-        glBindTexture(GL_TEXTURE_2D, depthTex[1]);
+        // the passes run with the render graph (see Draw), which allocates their intermediate targets.
+        auto scene = renderGraph.ImportFramebuffer("Scene", sceneFramebuffer);
+        if(transparencyMode == TransparencyMode::WeightedBlended)
+            AddWeightedBlendedPasses(transparentMeshes, scene);
+        else
+            AddSortedPasses(transparentMeshes, scene);
+    }
 
-        GLint boundCube;
-        glActiveTexture(GL_TEXTURE0 + UniformSamplerIndices::CUBEMAP);
-        glGetIntegerv(GL_TEXTURE_BINDING_CUBE_MAP, &boundCube);
-        assert(boundCube != 0);
+    void RenderingSystem::DrawDebugLines() {
+        auto count = DebugDraw::GetVertexCount();
+        // keep a third of the ring buffer for the other streamed data & the frames in flight.
+        count = std::min(count, streamingBuffer->GetCapacity() / (3 * sizeof(DebugVertex)));
+        auto allocation = count > 0 ? streamingBuffer->Allocate(count * sizeof(DebugVertex), sizeof(DebugVertex))
+                                    : StreamingAllocation();
+        if(allocation.data){
+            count = DebugDraw::WriteVertices(static_cast<DebugVertex*>(allocation.data), count);
 
-        for(auto mesh: transparentMeshes){
-            PrepareDraw(*mesh, activeShader);
-            mesh->draw(activeShader->GetShaderID());
+            auto activeShader = ResourceManager::GetShader("Debug Line Shader");
+            activeShader->Apply(camera);
+            activeShader->setMatrix("vp", camera->GetVPMatrix());
+            GLStateCache::BindBuffer(GL_ARRAY_BUFFER, streamingBuffer->GetBufferID());
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(DebugVertex),
+                                  (GLvoid*) (allocation.offset + offsetof(DebugVertex, position)));
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(DebugVertex),
+                                  (GLvoid*) (allocation.offset + offsetof(DebugVertex, color)));
+            // all debug shapes of the frame in a single draw call.
+            glDrawArrays(GL_LINES, 0, (GLsizei) count);
+            glDisableVertexAttribArray(1);
+            DEBUG_OPENGL("Debug Lines")
         }
+        DebugDraw::EndFrame(Time::deltaTime);
+    }
+
+    void RenderingSystem::DrawSpriteBatches(Shader& activeShader, const glm::mat4& vp) {
+        const auto& vertices = spriteBatcher.GetVertices();
+        const auto& indices = spriteBatcher.GetIndices();
+        if(indices.empty())
+            return;
+
+        auto vertexData = streamingBuffer->Write(vertices.data(), vertices.size() * sizeof(BatchedSpriteVertex));
+        auto indexData = streamingBuffer->Write(indices.data(), indices.size() * sizeof(uint32_t));
+        if(!vertexData.data || !indexData.data)
+            return;
 
-        glDepthMask(GL_TRUE);
-        glDisable(GL_BLEND);
+        activeShader.setMatrix("vp", vp);
+        GLStateCache::BindBuffer(GL_ARRAY_BUFFER, streamingBuffer->GetBufferID());
+        GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, streamingBuffer->GetBufferID());
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(BatchedSpriteVertex),
+                              (GLvoid*) (vertexData.offset + offsetof(BatchedSpriteVertex, position)));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(BatchedSpriteVertex),
+                              (GLvoid*) (vertexData.offset + offsetof(BatchedSpriteVertex, uv)));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(BatchedSpriteVertex),
+                              (GLvoid*) (vertexData.offset + offsetof(BatchedSpriteVertex, color)));
+
+        for(const auto& batch : spriteBatcher.GetBatches()){
+            if(batch.texture)
+                activeShader.ApplyTexture2D(*batch.texture, DIFFUSE);
+            glDrawElements(GL_TRIANGLES, (GLsizei) batch.indexCount, GL_UNSIGNED_INT,
+                           (GLvoid*) (indexData.offset + batch.firstIndex * sizeof(uint32_t)));
+        }
+        DEBUG_OPENGL("Sprite Batches")
     }
 
     void RenderingSystem::Draw() {
-        if(LightGrid.empty())
-            BuildLightGrid();
+        // state may have been changed outside the engine (e.g. by ImGui) since the last frame.
+        GLStateCache::BeginFrame();
+        UpdateQuality();
+        cullingStats = {};
+        ResourceManager::GetAtlas().Flush();
+        frustum.Update(camera->GetVPMatrix());
+        CollectVisibleObjects();
+        CullOccludedObjects();
+        CollectLitObjects();
+        BuildLightClusters();
+        UpdateLightGrid();
+
+        // without a graphics context, only the opaque 3D meshes are prepared and handed to the backend.
+        if(!ctx::Context::HasGraphics()){
+            std::vector<Mesh3D*> transparentMeshes = {};
+            std::vector<Mesh3D*> opaqueMeshes = {};
+            CollectMeshes(opaqueMeshes, transparentMeshes);
+            backend->BeginFrame(GetFrameParameters());
+            if(instancingEnabled)
+                DrawInstanced(opaqueMeshes, (multiDrawEnabled ? multiDrawShaderNameDict
+                                                              : instancedShaderNameDict).at(GetShadingModel()));
+            else
+                DrawRecorded(opaqueMeshes, shaderNameDict.at(GetShadingModel()));
+            backend->EndFrame();
+            DebugDraw::EndFrame(Time::deltaTime);
+            return;
+        }
 
+        // the scene (all but the UI) is drawn at the render scale's resolution.
+        BeginSceneTarget();
         // re-enable depth testing for 'regular' entities.
-        glEnable(GL_DEPTH_TEST);
+        GLStateCache::Enable(GL_DEPTH_TEST);
         auto i = 0;
 
         #pragma region Default Shader
         auto activeShader = ResourceManager::GetShader("Default Shader");
 
         // Mesh2D rendering
-        glBindVertexArray(VAO[i++]);
+        GLStateCache::BindVertexArray(VAO[i++]);
         if(engine.componentManager.hasComponentOfType<Mesh2D>()){
             activeShader->Apply(camera);
-            engine.componentManager.forEachComponent<Mesh2D>([&](Mesh2D& mesh){
+            for(auto object : visibleObjects){
+                if(object->type != SceneObjectType::Mesh2D)
+                    continue;
+                auto& mesh = *static_cast<Mesh2D*>(object->component);
                 auto model = mesh.entity()->transform->GetModelMatrix();
                 activeShader->setMatrix("mvp", activeShader->CalculateMVPMatrix(model));
                 auto renderer = mesh.entity()->GetComponent<Renderer>();
                 if(renderer)
                     renderer->ApplyData(*activeShader);
                 mesh.draw();
-            });
+            }
         }
 
         // line rendering (same shader as Mesh2D's)
-        glBindVertexArray(VAO[i++]);
+        GLStateCache::BindVertexArray(VAO[i++]);
         if(engine.componentManager.hasComponentOfType<Line>()){
             engine.componentManager.forEachComponent<Line>([&] (Line& mesh){
                 auto renderer = mesh.entity()->GetComponent<Renderer>();
@@ -467,22 +1227,23 @@ struct Entry{
                     renderer->ApplyData(*activeShader);
                 auto model = mesh.entity()->transform->GetModelMatrix();
                 activeShader->setMatrix("mvp", activeShader->CalculateMVPMatrix(model));
-                mesh.draw();
+                mesh.draw(*streamingBuffer);
             });
         }
+        DrawDebugLines();
         #pragma endregion
 
         #pragma region 3D rendering
-        glBindVertexArray(VAO[i++]);
+        GLStateCache::BindVertexArray(VAO[i++]);
         if(skybox != nullptr){
-            glDisable(GL_CULL_FACE);
+            GLStateCache::Disable(GL_CULL_FACE);
 
             DEBUG_OPENGL("Skybox")
             activeShader = ResourceManager::GetShader("Skybox Shader");
             activeShader->Apply(camera);
 
-            glDepthMask(GL_FALSE);
-            glDepthFunc(GL_LEQUAL);
+            GLStateCache::DepthMask(false);
+            GLStateCache::DepthFunc(GL_LEQUAL);
             auto view = glm::mat4(glm::mat3(camera->CalculateViewMatrix()));
             auto proj = camera->GetProjectionMatrix();
 
@@ -495,95 +1256,102 @@ struct Entry{
             auto mesh = skybox->GetComponent<Mesh3D>();
             mesh->draw(activeShader->GetShaderID());
 
-            glDepthFunc(GL_LESS);
-            glDepthMask(GL_TRUE);
+            GLStateCache::DepthFunc(GL_LESS);
+            GLStateCache::DepthMask(true);
         }
 
         // Mesh3D rendering
-        activeShader = ResourceManager::GetShader(shaderNameDict.at(active3DShader));
-        activeShader->Apply(camera);
-        activeShader->setFloat("ambient", ambient);
-        activeShader->setFloat("specular", specularFactor);
-
         std::vector<Mesh3D*> transparentMeshes = {};
-
-        if(engine.componentManager.hasComponentOfType<Mesh3D>()){
-            engine.componentManager.forEachComponent<Mesh3D>([&](Mesh3D& mesh){
-                // don't render skybox object.
-                if(skybox != nullptr && *mesh.entity() == *skybox)
-                    return;
-
-                auto renderer = mesh.entity()->GetComponent<Renderer>();
-                // early exit if transparent mesh (separate shaders).
-                if(renderer && renderer->material->GetOpacity() != 1.0f){
-                    transparentMeshes.emplace_back(&mesh);
-                    return;
-                }
-
-                // no fbos
-                PrepareDraw(mesh, activeShader);
-                mesh.draw(activeShader->GetShaderID());
-            });
+        std::vector<Mesh3D*> opaqueMeshes = {};
+        CollectMeshes(opaqueMeshes, transparentMeshes);
+
+        // with a depth pre-pass, the opaque meshes are drawn front to back twice: position only, then lit.
+        Shader* depthShader = nullptr;
+        if(depthPrePassEnabled && !opaqueMeshes.empty()){
+            SortFrontToBack(opaqueMeshes);
+            depthShader = ResourceManager::GetShader(!instancingEnabled ? "Depth Only Shader" :
+                                                     multiDrawEnabled ? "Depth Only Multi-Draw Shader"
+                                                                      : "Depth Only Instanced Shader");
+            depthShader->Apply(camera);
         }
 
+        // opaque meshes are either batched for instancing or recorded individually (no fbos).
+        backend->BeginFrame(GetFrameParameters());
+        if(instancingEnabled)
+            DrawInstanced(opaqueMeshes, (multiDrawEnabled ? multiDrawShaderNameDict
+                                                          : instancedShaderNameDict).at(GetShadingModel()), depthShader);
+        else
+            DrawRecorded(opaqueMeshes, shaderNameDict.at(GetShadingModel()), depthShader);
+        backend->EndFrame();
+
         if(!transparentMeshes.empty()){
-            DrawTransparentObjects(transparentMeshes, activeShader);
+            DrawTransparentObjects(transparentMeshes);
         }
+        // executed every frame, so that the targets of passes no longer declared are freed.
+        renderGraph.Execute();
+        renderGraphStats = renderGraph.GetStats();
+        GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, sceneFramebuffer);
         #pragma endregion
 
         #pragma region Sprite Rendering
-        activeShader = ResourceManager::GetShader("Sprite Shader");
-
-        // Sprite rendering
+        // all sprites are transformed on the CPU & drawn in one call per run of sprites sharing a texture.
+        activeShader = ResourceManager::GetShader("Sprite Batch Shader");
+        activeShader->Apply(camera);
+        GLStateCache::BindVertexArray(VAO[i++]);
 
-        // weed out UI Sprites for later overlay rendering
-        std::vector<SpriteMesh*> uiSprites = {};
+        auto addSprite = [this](SpriteMesh& mesh){
+            auto renderer = mesh.entity()->GetComponent<Renderer>();
+            if(!renderer){
+                DEBUG_ERROR("No sprite renderer attached to mesh on entity " + mesh.entity()->name())
+                return;
+            }
+            auto color = SpriteBatcher::PackColor(glm::vec4((glm::vec3) renderer->material->GetDiffuse(),
+                                                            renderer->material->GetOpacity()));
+            auto texture = renderer->GetDiffuseTexture();
+            auto uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+            // packed textures are drawn from their atlas page, so sprites using different textures batch.
+            auto region = ResourceManager::GetAtlas().Find(texture);
+            if(region && region->page){
+                texture = region->page;
+                uvRect = region->uvRect;
+            }
+            spriteBatcher.Add(mesh.primitive, mesh.entity()->transform->GetModelMatrix(), color, texture, uvRect);
+        };
 
-        glBindVertexArray(VAO[i++]);
-        if(engine.componentManager.hasComponentOfType<SpriteMesh>()){
-            activeShader->Apply(camera);
-            engine.componentManager.forEachComponent<SpriteMesh>([&] (SpriteMesh& mesh){
-                auto renderer = mesh.entity()->GetComponent<Renderer>();
-                if(!renderer){
-                    DEBUG_ERROR("No sprite renderer attached to mesh on entity " + mesh.entity()->name())
-                    return;
-                }
-                if(renderer->GetLayer() == "UI"){
-                    uiSprites.emplace_back(&mesh);
-                    return;
-                }
-                renderer->ApplyData(*activeShader);
-                auto model = mesh.entity()->transform->GetModelMatrix();
-                activeShader->setMatrix("mvp", activeShader->CalculateMVPMatrix(model));
-                mesh.draw();
-            });
+        spriteBatcher.Begin();
+        for(auto object : visibleObjects)
+            if(object->type == SceneObjectType::Sprite)
+                addSprite(*static_cast<SpriteMesh*>(object->component));
+        spriteBatcher.Build(false, &ThreadPool::Global());
+        DrawSpriteBatches(*activeShader, camera->GetVPMatrix());
+        ResolveSceneTarget();
+
+        // UI Sprites are kept apart by the scene index for overlay rendering
+        const auto& uiSprites = engine.GetSceneIndex().GetScreenSpaceObjects();
+        if(!uiSprites.empty()){
+            // disable depth testing here for UI
+            GLStateCache::Disable(GL_DEPTH_TEST);
+
+            spriteBatcher.Begin();
+            for(auto object : uiSprites)
+                addSprite(*static_cast<SpriteMesh*>(object->component));
+            // sorted by ascending z values for layering because no depth test.
+            spriteBatcher.Build(true, &ThreadPool::Global());
+
+            auto screenWidth = (float) camera->GetWidth();
+            auto screenHeight = (float) camera->GetHeight();
+            DrawSpriteBatches(*activeShader, glm::ortho(-screenWidth / 2, screenWidth / 2,
+                                                        -screenHeight / 2, screenHeight / 2));
         }
+        #pragma endregion
 
-        // return if no UI sprites to render
-        if(uiSprites.empty())
-            return;
-
-        // disable depth testing here for UI
-        glDisable(GL_DEPTH_TEST);
-
-        // sort by ascending z values for layering because no depth test.
-        std::sort(uiSprites.begin(), uiSprites.end(), CompareZValues);
-
-        activeShader = ResourceManager::GetShader("UI Shader");
+        // fence this frame's streamed data so its memory is reused once the GPU finished reading it.
+        streamingBuffer->EndFrame();
+        streamingStats = streamingBuffer->GetStats();
+        streamingBuffer->ResetStats();
 
-        glBindVertexArray(VAO[i++]);
-        activeShader->Apply(camera);
-        for (auto mesh : uiSprites) {
-            auto renderer = mesh->entity()->GetComponent<Renderer>();
-            renderer->ApplyData(*activeShader);
-            auto screenWidth = camera->GetWidth();
-            auto screenHeight = camera->GetHeight();
-            auto projection = glm::ortho(-(float) screenWidth / 2, (float) screenWidth / 2,
-                                         - (float) screenHeight / 2, (float) screenHeight / 2);
-            auto modelProjection = projection * mesh->entity()->transform->GetModelMatrix();
-            activeShader->setMatrix("mvp", modelProjection);
-            mesh->draw();
-        }
-        #pragma endregion
+        glQueryCounter(frameTimerQueries[frameTimerFrame].ids[1], GL_TIMESTAMP);
+        frameTimerQueries[frameTimerFrame].issued = true;
+        frameTimerFrame = (frameTimerFrame + 1) % frameTimerQueries.size();
     }
 }
@@ -21,6 +21,7 @@ namespace EisEngine::systems{
                 return;
 
             transform.modelMatrix = calculateModelMatrix(transform);
+            transform.version = ++Transform::versionCounter;
         });
     }
 
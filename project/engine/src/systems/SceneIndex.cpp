@@ -0,0 +1,202 @@
+#include "engine/systems/SceneIndex.h"
+#include "engine/Game.h"
+#include "engine/Components.h"
+
+namespace EisEngine::systems {
+    // model space bounds of each tracked component type.
+    const BoundingVolume& LocalBounds(Mesh2D& mesh) { return mesh.primitive.localBounds;}
+    const BoundingVolume& LocalBounds(Mesh3D& mesh) { return mesh.primitive.localBounds;}
+    const BoundingVolume& LocalBounds(SpriteMesh& mesh) { return mesh.primitive.localBounds;}
+
+    // UI sprites are drawn with a screen space projection, so world space queries must not return them.
+    bool IsScreenSpace(Mesh2D&) { return false;}
+    bool IsScreenSpace(Mesh3D&) { return false;}
+    bool IsScreenSpace(SpriteMesh& mesh) {
+        auto renderer = mesh.entity()->GetComponent<Renderer>();
+        return renderer && renderer->GetLayer() == "UI";
+    }
+
+    SceneIndex::SceneIndex(Game &engine) : System(engine), renderables(0.1f), lights(0.5f) { }
+
+    void SceneIndex::Update() {
+        frame++;
+        screenSpaceObjects.clear();
+
+        Track<Mesh2D>(SceneObjectType::Mesh2D);
+        Track<Mesh3D>(SceneObjectType::Mesh3D);
+        Track<SpriteMesh>(SceneObjectType::Sprite);
+
+        if(engine.componentManager.hasComponentOfType<PointLight>()){
+            engine.componentManager.forEachComponent<PointLight>([&](PointLight& light){
+                if(light.isDeleted())
+                    return;
+                auto& entry = objects[&light];
+                if(!entry || entry->type != SceneObjectType::Light || entry->owner != light.GetOwner()){
+                    if(entry && entry->proxy != DynamicAABBTree::nullNode)
+                        (entry->type == SceneObjectType::Light ? lights : renderables).DestroyProxy(entry->proxy);
+                    entry = std::make_unique<SceneObject>();
+                    entry->component = &light;
+                    entry->type = SceneObjectType::Light;
+                    entry->owner = light.GetOwner();
+                }
+                auto& object = *entry;
+                object.lastSeen = frame;
+                object.transform = light.entity()->transform;
+
+                // the range depends on the light's intensity as well, so lights refit every frame;
+                // the fat boxes keep this cheap for lights that did not move.
+                auto previous = object.bounds.sphere.center;
+                glm::vec3 pos = light.position();
+                object.bounds.sphere = {pos, light.GetRange()};
+                object.bounds.box = object.bounds.sphere.ToAABB();
+                object.version = object.transform->GetVersion();
+                if(object.proxy == DynamicAABBTree::nullNode)
+                    object.proxy = lights.CreateProxy(object.bounds.box, &object);
+                else
+                    lights.MoveProxy(object.proxy, object.bounds.box, pos - previous);
+            });
+        }
+
+        RemoveStale();
+    }
+
+    template<typename C>
+    void SceneIndex::Track(SceneObjectType type) {
+        if(!engine.componentManager.hasComponentOfType<C>())
+            return;
+
+        engine.componentManager.forEachComponent<C>([&](C& component){
+            if(component.isDeleted())
+                return;
+
+            auto& entry = objects[&component];
+            // a different component may have been allocated at the address of a removed one.
+            auto isNew = !entry || entry->type != type || entry->owner != component.GetOwner();
+            if(isNew){
+                if(entry && entry->proxy != DynamicAABBTree::nullNode)
+                    (entry->type == SceneObjectType::Light ? lights : renderables).DestroyProxy(entry->proxy);
+                entry = std::make_unique<SceneObject>();
+                entry->component = &component;
+                entry->type = type;
+                entry->owner = component.GetOwner();
+            }
+
+            auto& object = *entry;
+            object.lastSeen = frame;
+            object.transform = component.entity()->transform;
+
+            auto screenSpace = IsScreenSpace(component);
+            auto version = object.transform->GetVersion();
+            auto layerChanged = screenSpace != (object.proxy == DynamicAABBTree::nullNode);
+            if(isNew || layerChanged || version != object.version){
+                object.version = version;
+                Refit(object, LocalBounds(component), screenSpace);
+            }
+
+            if(screenSpace)
+                screenSpaceObjects.push_back(&object);
+        });
+    }
+
+    void SceneIndex::Refit(SceneObject &object, const BoundingVolume &localBounds, bool screenSpace) {
+        auto previous = object.bounds.box.Center();
+        object.bounds = localBounds.Transformed(object.transform->GetModelMatrix());
+
+        if(screenSpace){
+            if(object.proxy != DynamicAABBTree::nullNode){
+                renderables.DestroyProxy(object.proxy);
+                object.proxy = DynamicAABBTree::nullNode;
+            }
+            return;
+        }
+
+        if(object.proxy == DynamicAABBTree::nullNode)
+            object.proxy = renderables.CreateProxy(object.bounds.box, &object);
+        else
+            renderables.MoveProxy(object.proxy, object.bounds.box, object.bounds.box.Center() - previous);
+    }
+
+    void SceneIndex::RemoveStale() {
+        for(auto it = objects.begin(); it != objects.end();){
+            auto& object = *it->second;
+            if(object.lastSeen == frame){
+                ++it;
+                continue;
+            }
+
+            if(object.proxy != DynamicAABBTree::nullNode)
+                (object.type == SceneObjectType::Light ? lights : renderables).DestroyProxy(object.proxy);
+            it = objects.erase(it);
+        }
+    }
+
+    void SceneIndex::QueryFrustum(const Frustum &frustum, std::vector<SceneObject*> &out) const {
+        renderables.QueryFrustum(frustum, [&](int proxy){
+            auto object = static_cast<SceneObject*>(renderables.GetUserData(proxy));
+            if(frustum.TestVolume(object->bounds))
+                out.push_back(object);
+            return true;
+        });
+    }
+
+    void SceneIndex::QuerySphere(const BoundingSphere &sphere, std::vector<SceneObject*> &out) const {
+        renderables.QuerySphere(sphere, [&](int proxy){
+            auto object = static_cast<SceneObject*>(renderables.GetUserData(proxy));
+            if(sphere.Overlaps(object->bounds.box))
+                out.push_back(object);
+            return true;
+        });
+    }
+
+    void SceneIndex::QueryAABB(const AABB &box, std::vector<SceneObject*> &out) const {
+        renderables.QueryAABB(box, [&](int proxy){
+            auto object = static_cast<SceneObject*>(renderables.GetUserData(proxy));
+            if(box.Overlaps(object->bounds.box))
+                out.push_back(object);
+            return true;
+        });
+    }
+
+    void SceneIndex::QueryLights(const BoundingSphere &sphere, std::vector<PointLight*> &out) const {
+        lights.QuerySphere(sphere, [&](int proxy){
+            auto object = static_cast<SceneObject*>(lights.GetUserData(proxy));
+            auto d = object->bounds.sphere.center - sphere.center;
+            auto r = object->bounds.sphere.radius + sphere.radius;
+            if(glm::dot(d, d) <= r * r)
+                out.push_back(static_cast<PointLight*>(object->component));
+            return true;
+        });
+    }
+
+    void SceneIndex::QueryLights(const Frustum &frustum, std::vector<PointLight*> &out) const {
+        lights.QueryFrustum(frustum, [&](int proxy){
+            auto object = static_cast<SceneObject*>(lights.GetUserData(proxy));
+            if(frustum.TestSphere(object->bounds.sphere))
+                out.push_back(static_cast<PointLight*>(object->component));
+            return true;
+        });
+    }
+
+    SceneObject *SceneIndex::Raycast(const Ray &ray, float maxDistance, float *hitDistance) const {
+        SceneObject* closest = nullptr;
+        renderables.Raycast(ray, maxDistance, [&](int proxy, float){
+            auto object = static_cast<SceneObject*>(renderables.GetUserData(proxy));
+            float t;
+            if(ray.Intersects(object->bounds.box, maxDistance, t)){
+                maxDistance = t;
+                closest = object;
+            }
+            return maxDistance;
+        });
+
+        if(closest && hitDistance)
+            *hitDistance = maxDistance;
+        return closest;
+    }
+
+    void SceneIndex::GetRenderables(std::vector<SceneObject*> &out) const {
+        for(const auto& [_, object] : objects)
+            if(object->type != SceneObjectType::Light && object->proxy != DynamicAABBTree::nullNode)
+                out.push_back(object.get());
+    }
+}
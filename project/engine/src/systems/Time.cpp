@@ -3,15 +3,21 @@
 #include "engine/systems/Time.h"
 #include "engine/Game.h"
 
+#include <chrono>
+
 namespace EisEngine::systems {
     Time::Time(Game &engine) : System(engine)
-    { engine.onUpdate.addListener([&] (Game &engine){ UpdateDeltaTime();});}
+    { engine.onUpdate.addListener([&] (Game &engine){ UpdateDeltaTime(engine.context);});}
 
     float Time::deltaTime = 1.0f/60.0f;
 
-    void Time::UpdateDeltaTime() {
-        auto frameTime = (float) glfwGetTime();
-        deltaTime = frameTime - lastFrameTime;
+    void Time::UpdateDeltaTime(const ctx::Context& context) {
+        // headless contexts have no GLFW timer; like it (see Context::run), their clock starts at one frame.
+        static const auto start = std::chrono::steady_clock::now();
+        auto frameTime = ctx::Context::HasGraphics() ? (float) glfwGetTime() :
+                1.0f / 60 + std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+        auto fixedTimeStep = (float) context.GetFixedTimeStep();
+        deltaTime = fixedTimeStep > 0.0f ? fixedTimeStep : frameTime - lastFrameTime;
         lastFrameTime = frameTime;
     }
 }
@@ -1,5 +1,16 @@
 #include "engine/utilities/Debug.h"
+#include "engine/utilities/DebugDraw.h"
+#include "engine/utilities/Vector3.h"
 
 namespace EisEngine{
     LogPriority Debug::Priority = LogPriority::InfoP;
+
+    void Debug::DrawLine(const Vector3 &start, const Vector3 &end, const Color &color, float duration)
+    { DebugDraw::AddLine((glm::vec3) start, (glm::vec3) end, DebugDraw::PackColor(color), duration);}
+
+    void Debug::DrawBox(const Vector3 &center, const Vector3 &halfExtents, const Color &color, float duration)
+    { DebugDraw::AddBox((glm::vec3) center, (glm::vec3) halfExtents, DebugDraw::PackColor(color), duration);}
+
+    void Debug::DrawSphere(const Vector3 &center, float radius, const Color &color, float duration)
+    { DebugDraw::AddSphere((glm::vec3) center, radius, DebugDraw::PackColor(color), duration);}
 }
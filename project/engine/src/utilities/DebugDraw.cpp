@@ -0,0 +1,142 @@
+#include "engine/utilities/DebugDraw.h"
+#include "engine/utilities/Color.h"
+#include "engine/utilities/Math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// the amount of line segments of each of a debug sphere's circles.
+#define SPHERE_SEGMENTS 24
+
+namespace EisEngine {
+    std::mutex DebugDraw::mutex;
+    std::vector<DebugVertex> DebugDraw::frameVertices = {};
+    std::vector<DebugDraw::TimedLine> DebugDraw::timedLines = {};
+    std::vector<DebugVertex> DebugDraw::persistentVertices = {};
+    std::vector<char> DebugDraw::persistentAlive = {};
+    std::vector<uint32_t> DebugDraw::freePersistentIds = {};
+    size_t DebugDraw::persistentCount = 0;
+
+    uint32_t DebugDraw::PackColor(const glm::vec4 &color) {
+        auto toByte = [](float v){ return (uint32_t) std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f);};
+        return toByte(color.x) | toByte(color.y) << 8 | toByte(color.z) << 16 | toByte(color.w) << 24;
+    }
+
+    uint32_t DebugDraw::PackColor(const Color &color) { return PackColor(glm::vec4(color.r, color.g, color.b, color.a));}
+
+    void DebugDraw::PushLine(const glm::vec3 &start, const glm::vec3 &end, uint32_t color, float duration) {
+        if(duration > 0.0f)
+            timedLines.push_back({{start, color}, {end, color}, duration});
+        else {
+            frameVertices.push_back({start, color});
+            frameVertices.push_back({end, color});
+        }
+    }
+
+    void DebugDraw::AddLine(const glm::vec3 &start, const glm::vec3 &end, uint32_t color, float duration) {
+        std::lock_guard<std::mutex> lock(mutex);
+        PushLine(start, end, color, duration);
+    }
+
+    void DebugDraw::AddBox(const glm::vec3 &center, const glm::vec3 &halfExtents, uint32_t color, float duration) {
+        // corner i has the sign of axis a set if bit a of i is set.
+        auto corner = [&](int i){
+            return center + halfExtents * glm::vec3(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f);
+        };
+        std::lock_guard<std::mutex> lock(mutex);
+        for(int i = 0; i < 8; i++)
+            for(int axis = 1; axis < 8; axis <<= 1)
+                if(!(i & axis))
+                    PushLine(corner(i), corner(i | axis), color, duration);
+    }
+
+    void DebugDraw::AddSphere(const glm::vec3 &center, float radius, uint32_t color, float duration) {
+        const auto step = 2.0f * Math::PI / SPHERE_SEGMENTS;
+        std::lock_guard<std::mutex> lock(mutex);
+        for(int axis = 0; axis < 3; axis++){
+            // the circle spans the two axes other than the current one.
+            auto point = [&](int segment){
+                auto p = glm::vec3(0.0f);
+                p[(axis + 1) % 3] = std::cos((float) segment * step) * radius;
+                p[(axis + 2) % 3] = std::sin((float) segment * step) * radius;
+                return center + p;
+            };
+            for(int s = 0; s < SPHERE_SEGMENTS; s++)
+                PushLine(point(s), point(s + 1), color, duration);
+        }
+    }
+
+    uint32_t DebugDraw::AddPersistentLine(const glm::vec3 &start, const glm::vec3 &end, uint32_t color) {
+        std::lock_guard<std::mutex> lock(mutex);
+        uint32_t id;
+        if(!freePersistentIds.empty()){
+            id = freePersistentIds.back();
+            freePersistentIds.pop_back();
+        }
+        else {
+            id = (uint32_t) persistentAlive.size();
+            persistentAlive.push_back(0);
+            persistentVertices.resize(persistentVertices.size() + 2);
+        }
+        persistentAlive[id] = 1;
+        persistentVertices[2 * id] = {start, color};
+        persistentVertices[2 * id + 1] = {end, color};
+        persistentCount++;
+        return id;
+    }
+
+    void DebugDraw::SetPersistentLinePoints(uint32_t id, const glm::vec3 &start, const glm::vec3 &end) {
+        std::lock_guard<std::mutex> lock(mutex);
+        persistentVertices[2 * id].position = start;
+        persistentVertices[2 * id + 1].position = end;
+    }
+
+    void DebugDraw::SetPersistentLineColor(uint32_t id, uint32_t color) {
+        std::lock_guard<std::mutex> lock(mutex);
+        persistentVertices[2 * id].color = color;
+        persistentVertices[2 * id + 1].color = color;
+    }
+
+    void DebugDraw::RemovePersistentLine(uint32_t id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(!persistentAlive[id])
+            return;
+        persistentAlive[id] = 0;
+        freePersistentIds.push_back(id);
+        persistentCount--;
+    }
+
+    size_t DebugDraw::GetVertexCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return 2 * persistentCount + 2 * timedLines.size() + frameVertices.size();
+    }
+
+    size_t DebugDraw::WriteVertices(DebugVertex *out, size_t maxVertices) {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t written = 0;
+        for(size_t id = 0; id < persistentAlive.size() && written + 2 <= maxVertices; id++){
+            if(!persistentAlive[id])
+                continue;
+            out[written++] = persistentVertices[2 * id];
+            out[written++] = persistentVertices[2 * id + 1];
+        }
+        for(size_t i = 0; i < timedLines.size() && written + 2 <= maxVertices; i++){
+            out[written++] = timedLines[i].start;
+            out[written++] = timedLines[i].end;
+        }
+        auto count = std::min(frameVertices.size(), (maxVertices - written) & ~(size_t) 1);
+        std::memcpy(out + written, frameVertices.data(), count * sizeof(DebugVertex));
+        return written + count;
+    }
+
+    void DebugDraw::EndFrame(float deltaTime) {
+        std::lock_guard<std::mutex> lock(mutex);
+        frameVertices.clear();
+        for(auto& line : timedLines)
+            line.remaining -= deltaTime;
+        timedLines.erase(std::remove_if(timedLines.begin(), timedLines.end(),
+                                        [](const TimedLine& line){ return line.remaining <= 0.0f;}),
+                         timedLines.end());
+    }
+}
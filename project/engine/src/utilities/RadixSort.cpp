@@ -0,0 +1,47 @@
+#include "engine/utilities/RadixSort.h"
+
+#include <array>
+#include <cstring>
+
+namespace EisEngine {
+    uint32_t OrderedFloatBits(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        // negative floats sort in reverse & below positive ones.
+        return bits & 0x80000000u ? ~bits : bits | 0x80000000u;
+    }
+
+    void RadixSort(std::vector<SortEntry> &entries, std::vector<SortEntry> &scratch) {
+        if(entries.size() < 2)
+            return;
+
+        // count the digits of all passes at once.
+        std::array<std::array<uint32_t, 256>, 8> counts = {};
+        for(const auto& entry : entries)
+            for(int pass = 0; pass < 8; pass++)
+                counts[pass][(entry.key >> (8 * pass)) & 0xFF]++;
+
+        scratch.resize(entries.size());
+        auto* source = &entries;
+        auto* target = &scratch;
+        auto digit = [](const SortEntry& entry, int pass){ return (entry.key >> (8 * pass)) & 0xFF;};
+        for(int pass = 0; pass < 8; pass++){
+            auto& count = counts[pass];
+            // all keys share this digit: the pass would not change the order.
+            if(count[digit(entries.front(), pass)] == entries.size())
+                continue;
+
+            uint32_t offset = 0;
+            for(auto& c : count){
+                auto n = c;
+                c = offset;
+                offset += n;
+            }
+            for(const auto& entry : *source)
+                (*target)[count[digit(entry, pass)]++] = entry;
+            std::swap(source, target);
+        }
+        if(source != &entries)
+            entries.swap(scratch);
+    }
+}
@@ -0,0 +1,136 @@
+#include "engine/utilities/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+namespace EisEngine {
+    ThreadPool::ThreadPool(unsigned int threadCount) {
+        workers.reserve(threadCount);
+        for(unsigned int i = 0; i < threadCount; i++)
+            workers.emplace_back([this]{ WorkerLoop();});
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        for(auto& worker : workers)
+            worker.join();
+    }
+
+    unsigned int ThreadPool::DefaultThreadCount() {
+        auto hardwareThreads = std::thread::hardware_concurrency();
+        return hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    ThreadPool &ThreadPool::Global() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    void ThreadPool::WorkerLoop() {
+        while(true){
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeUp.wait(lock, [this]{ return stopping || !tasks.empty();});
+                if(tasks.empty())
+                    return;
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::future<void> ThreadPool::Submit(std::function<void()> task) {
+        auto packaged = std::make_shared<std::packaged_task<void()>>(std::move(task));
+        auto future = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace_back([packaged]{ (*packaged)();});
+        }
+        wakeUp.notify_one();
+        return future;
+    }
+
+    void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t, size_t)> &f, size_t minChunkSize) {
+        if(count == 0)
+            return;
+
+        // the calling thread processes a chunk as well.
+        auto maxChunks = (size_t) workers.size() + 1;
+        auto chunks = std::min(maxChunks, (count + minChunkSize - 1) / std::max<size_t>(minChunkSize, 1));
+        if(chunks <= 1){
+            f(0, count);
+            return;
+        }
+
+        auto chunkSize = (count + chunks - 1) / chunks;
+        size_t remaining = chunks - 1;
+        std::mutex doneMutex;
+        std::condition_variable done;
+        // the first exception thrown by any chunk, rethrown once all chunks are done.
+        std::exception_ptr error;
+        auto run = [&](size_t begin, size_t end){
+            try{
+                if(begin < end)
+                    f(begin, end);
+            }
+            catch(...){
+                std::lock_guard<std::mutex> errorLock(doneMutex);
+                if(!error)
+                    error = std::current_exception();
+            }
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for(size_t c = 1; c < chunks; c++){
+                auto begin = c * chunkSize;
+                auto end = std::min(count, begin + chunkSize);
+                tasks.emplace_back([&, begin, end]{
+                    // a throwing chunk still counts as done, so the caller never waits forever.
+                    run(begin, end);
+                    std::lock_guard<std::mutex> doneLock(doneMutex);
+                    if(--remaining == 0)
+                        done.notify_one();
+                });
+            }
+        }
+        wakeUp.notify_all();
+
+        // the queued chunks refer to this call's locals, so the caller's chunk must not unwind before they finish.
+        run(0, std::min(count, chunkSize));
+
+        // help with queued tasks while waiting, so nested calls from worker threads cannot deadlock.
+        while(true){
+            {
+                std::unique_lock<std::mutex> lock(doneMutex);
+                if(remaining == 0)
+                    break;
+            }
+
+            std::function<void()> task;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if(!tasks.empty()){
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+            }
+            if(task){
+                task();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(doneMutex);
+            done.wait_for(lock, std::chrono::microseconds(100), [&]{ return remaining == 0;});
+        }
+        if(error)
+            std::rethrow_exception(error);
+    }
+}
@@ -0,0 +1,102 @@
+#include "engine/utilities/rendering/BoundingVolume.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace EisEngine::rendering {
+    float AABB::SurfaceArea() const {
+        auto d = max - min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    // Arvo's method: each output axis accumulates the min/max contribution of each input axis.
+    AABB AABB::Transformed(const glm::mat4 &m) const {
+        AABB result;
+        result.min = glm::vec3(m[3].x, m[3].y, m[3].z);
+        result.max = result.min;
+        for(int i = 0; i < 3; i++)
+            for(int j = 0; j < 3; j++){
+                auto a = m[i][j] * min[i];
+                auto b = m[i][j] * max[i];
+                result.min[j] += std::min(a, b);
+                result.max[j] += std::max(a, b);
+            }
+        return result;
+    }
+
+    AABB AABB::Merged(const AABB &other) const {
+        return {glm::min(min, other.min), glm::max(max, other.max)};
+    }
+
+    bool AABB::Contains(const AABB &other) const {
+        return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+               max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+    }
+
+    bool AABB::Overlaps(const AABB &other) const {
+        return min.x <= other.max.x && max.x >= other.min.x &&
+               min.y <= other.max.y && max.y >= other.min.y &&
+               min.z <= other.max.z && max.z >= other.min.z;
+    }
+
+    AABB AABB::FromPoints(const std::vector<glm::vec3> &points) {
+        if(points.empty())
+            return {};
+
+        AABB result{points[0], points[0]};
+        for(const auto& p : points){
+            result.min = glm::min(result.min, p);
+            result.max = glm::max(result.max, p);
+        }
+        return result;
+    }
+
+    BoundingSphere BoundingSphere::Transformed(const glm::mat4 &m) const {
+        auto c = m * glm::vec4(center, 1.0f);
+        // scale the radius by the largest axis scale to stay conservative under non-uniform scaling.
+        auto sx = glm::dot(glm::vec3(m[0].x, m[0].y, m[0].z), glm::vec3(m[0].x, m[0].y, m[0].z));
+        auto sy = glm::dot(glm::vec3(m[1].x, m[1].y, m[1].z), glm::vec3(m[1].x, m[1].y, m[1].z));
+        auto sz = glm::dot(glm::vec3(m[2].x, m[2].y, m[2].z), glm::vec3(m[2].x, m[2].y, m[2].z));
+        auto scale = std::sqrt(std::max(sx, std::max(sy, sz)));
+        return {glm::vec3(c.x, c.y, c.z), radius * scale};
+    }
+
+    bool BoundingSphere::Overlaps(const AABB &box) const {
+        auto closest = glm::clamp(center, box.min, box.max);
+        auto d = closest - center;
+        return glm::dot(d, d) <= radius * radius;
+    }
+
+    // slab test; divisions by zero produce infinities which compare correctly.
+    bool Ray::Intersects(const AABB &box, float maxDistance, float &hitDistance) const {
+        float tMin = 0.0f;
+        float tMax = maxDistance;
+        for(int i = 0; i < 3; i++){
+            auto inv = 1.0f / direction[i];
+            auto t0 = (box.min[i] - origin[i]) * inv;
+            auto t1 = (box.max[i] - origin[i]) * inv;
+            if(inv < 0.0f)
+                std::swap(t0, t1);
+            tMin = std::max(tMin, t0);
+            tMax = std::min(tMax, t1);
+            if(tMax < tMin)
+                return false;
+        }
+        hitDistance = tMin;
+        return true;
+    }
+
+    BoundingVolume BoundingVolume::FromPoints(const std::vector<glm::vec3> &points) {
+        BoundingVolume result;
+        result.box = AABB::FromPoints(points);
+        result.sphere.center = result.box.Center();
+
+        float maxDist2 = 0.0f;
+        for(const auto& p : points){
+            auto d = p - result.sphere.center;
+            maxDist2 = std::max(maxDist2, glm::dot(d, d));
+        }
+        result.sphere.radius = std::sqrt(maxDist2);
+        return result;
+    }
+}
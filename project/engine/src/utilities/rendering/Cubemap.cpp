@@ -1,6 +1,8 @@
 #include "engine/utilities/rendering/Cubemap.h"
 #include "engine/utilities/rendering/Shader.h"
 #include "engine/utilities/Debug.h"
+#include "engine/Context.h"
+#include "engine/utilities/rendering/GLStateCache.h"
 
 namespace EisEngine {
     Cubemap::Cubemap() :
@@ -9,7 +11,8 @@ namespace EisEngine {
         wrapR(GL_CLAMP_TO_EDGE), minFilterMode(GL_LINEAR),
         maxFilterMode(GL_LINEAR)
     {
-        glGenTextures(1, &textureID);
+        if(ctx::Context::HasGraphics())
+            glGenTextures(1, &textureID);
     }
 
     void Cubemap::Generate(unsigned int& index, unsigned int w, unsigned int h, unsigned char* data) {
@@ -21,8 +24,10 @@ namespace EisEngine {
             this->height = (int) h;
         else if (this->height != h)
             DEBUG_RUNTIME_ERROR("Attempting to create a Cubemap with textures of different dimensions!")
+        if(!ctx::Context::HasGraphics())
+            return;
 
-        glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+        rendering::GLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, textureID);
         glTexImage2D(
                 GL_TEXTURE_CUBE_MAP_POSITIVE_X + index,
                 0,
@@ -35,11 +40,13 @@ namespace EisEngine {
                 data
                 );
 
-        glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+        rendering::GLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, 0);
     }
 
     void Cubemap::SetParams() {
-        glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+        if(!ctx::Context::HasGraphics())
+            return;
+        rendering::GLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, textureID);
 
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, (GLint) maxFilterMode);
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, (GLint) minFilterMode);
@@ -47,10 +54,10 @@ namespace EisEngine {
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, (GLint) wrapT);
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, (GLint) wrapR);
 
-        glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+        rendering::GLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, 0);
     }
 
     void Cubemap::Bind() const {
-        glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+        rendering::GLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, textureID);
     }
 }
\ No newline at end of file
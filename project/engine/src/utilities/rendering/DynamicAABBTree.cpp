@@ -0,0 +1,237 @@
+#include "engine/utilities/rendering/DynamicAABBTree.h"
+
+#include <cassert>
+
+namespace EisEngine::rendering {
+    DynamicAABBTree::DynamicAABBTree(float margin) : margin(margin) { }
+
+    int DynamicAABBTree::AllocateNode() {
+        if(freeList == nullNode){
+            nodes.emplace_back();
+            return (int) nodes.size() - 1;
+        }
+
+        auto id = freeList;
+        freeList = nodes[id].parent;
+        nodes[id] = Node();
+        return id;
+    }
+
+    void DynamicAABBTree::FreeNode(int nodeId) {
+        nodes[nodeId].parent = freeList;
+        nodes[nodeId].height = -1;
+        freeList = nodeId;
+    }
+
+    int DynamicAABBTree::CreateProxy(const AABB &box, void *userData) {
+        auto id = AllocateNode();
+        auto& node = nodes[id];
+        node.box = {box.min - glm::vec3(margin), box.max + glm::vec3(margin)};
+        node.userData = userData;
+        node.height = 0;
+        InsertLeaf(id);
+        proxyCount++;
+        return id;
+    }
+
+    void DynamicAABBTree::DestroyProxy(int proxyId) {
+        assert(nodes[proxyId].IsLeaf());
+        RemoveLeaf(proxyId);
+        FreeNode(proxyId);
+        proxyCount--;
+    }
+
+    bool DynamicAABBTree::MoveProxy(int proxyId, const AABB &box, const glm::vec3 &displacement) {
+        assert(nodes[proxyId].IsLeaf());
+        if(nodes[proxyId].box.Contains(box))
+            return false;
+
+        RemoveLeaf(proxyId);
+
+        // enlarge the box in the direction of movement to anticipate the next frames.
+        AABB fat = {box.min - glm::vec3(margin), box.max + glm::vec3(margin)};
+        auto d = 2.0f * displacement;
+        for(int i = 0; i < 3; i++){
+            if(d[i] < 0.0f)
+                fat.min[i] += d[i];
+            else
+                fat.max[i] += d[i];
+        }
+        nodes[proxyId].box = fat;
+
+        InsertLeaf(proxyId);
+        return true;
+    }
+
+    void DynamicAABBTree::Clear() {
+        nodes.clear();
+        root = nullNode;
+        freeList = nullNode;
+        proxyCount = 0;
+    }
+
+    void DynamicAABBTree::InsertLeaf(int leaf) {
+        if(root == nullNode){
+            root = leaf;
+            nodes[root].parent = nullNode;
+            return;
+        }
+
+        // find the best sibling using the surface area heuristic.
+        auto leafBox = nodes[leaf].box;
+        auto index = root;
+        while(!nodes[index].IsLeaf()){
+            auto child1 = nodes[index].child1;
+            auto child2 = nodes[index].child2;
+
+            auto area = nodes[index].box.SurfaceArea();
+            auto combinedArea = nodes[index].box.Merged(leafBox).SurfaceArea();
+
+            // cost of creating a new parent for this node and the new leaf.
+            auto cost = 2.0f * combinedArea;
+            // minimum cost of pushing the leaf further down the tree.
+            auto inheritanceCost = 2.0f * (combinedArea - area);
+
+            auto descendCost = [&](int child){
+                auto merged = leafBox.Merged(nodes[child].box).SurfaceArea();
+                if(nodes[child].IsLeaf())
+                    return merged + inheritanceCost;
+                return merged - nodes[child].box.SurfaceArea() + inheritanceCost;
+            };
+            auto cost1 = descendCost(child1);
+            auto cost2 = descendCost(child2);
+
+            if(cost < cost1 && cost < cost2)
+                break;
+
+            index = cost1 < cost2 ? child1 : child2;
+        }
+        auto sibling = index;
+
+        // create a new parent.
+        auto oldParent = nodes[sibling].parent;
+        auto newParent = AllocateNode();
+        nodes[newParent].parent = oldParent;
+        nodes[newParent].box = leafBox.Merged(nodes[sibling].box);
+        nodes[newParent].height = nodes[sibling].height + 1;
+        nodes[newParent].child1 = sibling;
+        nodes[newParent].child2 = leaf;
+        nodes[sibling].parent = newParent;
+        nodes[leaf].parent = newParent;
+
+        if(oldParent != nullNode){
+            if(nodes[oldParent].child1 == sibling)
+                nodes[oldParent].child1 = newParent;
+            else
+                nodes[oldParent].child2 = newParent;
+        }
+        else
+            root = newParent;
+
+        // walk back up the tree fixing heights and boxes.
+        index = nodes[leaf].parent;
+        while(index != nullNode){
+            index = Balance(index);
+
+            auto child1 = nodes[index].child1;
+            auto child2 = nodes[index].child2;
+            nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+            nodes[index].box = nodes[child1].box.Merged(nodes[child2].box);
+
+            index = nodes[index].parent;
+        }
+    }
+
+    void DynamicAABBTree::RemoveLeaf(int leaf) {
+        if(leaf == root){
+            root = nullNode;
+            return;
+        }
+
+        auto parent = nodes[leaf].parent;
+        auto grandParent = nodes[parent].parent;
+        auto sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+        if(grandParent == nullNode){
+            root = sibling;
+            nodes[sibling].parent = nullNode;
+            FreeNode(parent);
+            return;
+        }
+
+        // destroy the parent and connect the sibling to the grandparent.
+        if(nodes[grandParent].child1 == parent)
+            nodes[grandParent].child1 = sibling;
+        else
+            nodes[grandParent].child2 = sibling;
+        nodes[sibling].parent = grandParent;
+        FreeNode(parent);
+
+        auto index = grandParent;
+        while(index != nullNode){
+            index = Balance(index);
+
+            auto child1 = nodes[index].child1;
+            auto child2 = nodes[index].child2;
+            nodes[index].box = nodes[child1].box.Merged(nodes[child2].box);
+            nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+
+            index = nodes[index].parent;
+        }
+    }
+
+    // rotates the taller child up if the subtree heights differ by more than one.
+    int DynamicAABBTree::Balance(int iA) {
+        auto& A = nodes[iA];
+        if(A.IsLeaf() || A.height < 2)
+            return iA;
+
+        auto iB = A.child1;
+        auto iC = A.child2;
+        auto balance = nodes[iC].height - nodes[iB].height;
+
+        // rotates the grandchild pair of 'up' into A's slot; 'other' stays as A's remaining child.
+        auto rotate = [&](int iUp, bool upIsChild2) -> int {
+            auto& Up = nodes[iUp];
+            auto iF = Up.child1;
+            auto iG = Up.child2;
+
+            Up.child1 = iA;
+            Up.parent = nodes[iA].parent;
+            nodes[iA].parent = iUp;
+
+            if(Up.parent != nullNode){
+                if(nodes[Up.parent].child1 == iA)
+                    nodes[Up.parent].child1 = iUp;
+                else
+                    nodes[Up.parent].child2 = iUp;
+            }
+            else
+                root = iUp;
+
+            auto iOther = upIsChild2 ? nodes[iA].child1 : nodes[iA].child2;
+            // keep the taller grandchild under 'up', move the shorter one down to A.
+            auto iKeep = nodes[iF].height > nodes[iG].height ? iF : iG;
+            auto iMove = iKeep == iF ? iG : iF;
+
+            Up.child2 = iKeep;
+            if(upIsChild2)
+                nodes[iA].child2 = iMove;
+            else
+                nodes[iA].child1 = iMove;
+            nodes[iMove].parent = iA;
+
+            nodes[iA].box = nodes[iOther].box.Merged(nodes[iMove].box);
+            nodes[iA].height = 1 + std::max(nodes[iOther].height, nodes[iMove].height);
+            Up.box = nodes[iA].box.Merged(nodes[iKeep].box);
+            Up.height = 1 + std::max(nodes[iA].height, nodes[iKeep].height);
+            return iUp;
+        };
+
+        if(balance > 1)
+            return rotate(iC, true);
+        if(balance < -1)
+            return rotate(iB, false);
+        return iA;
+    }
+}
@@ -0,0 +1,101 @@
+#include "engine/utilities/rendering/FrameReadback.h"
+#include "engine/utilities/rendering/GLStateCache.h"
+#include "engine/utilities/Debug.h"
+
+#include <algorithm>
+
+namespace EisEngine::rendering {
+    FrameReadback::FrameReadback(Callback callback, size_t bufferCount) :
+    callback(std::move(callback)), slots(std::max<size_t>(bufferCount, 1)) {}
+
+    FrameReadback::~FrameReadback() {
+        for(auto& slot : slots){
+            if(slot.fence)
+                glDeleteSync(slot.fence);
+            ReleaseSlot(slot);
+        }
+    }
+
+    void FrameReadback::ReleaseSlot(Slot &slot) {
+        if(slot.buffer == 0)
+            return;
+        GLStateCache::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        GLStateCache::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        GLStateCache::OnBufferDeleted(slot.buffer);
+        glDeleteBuffers(1, &slot.buffer);
+        slot.buffer = 0;
+        slot.mapped = nullptr;
+        slot.capacity = 0;
+    }
+
+    void FrameReadback::Reserve(Slot &slot, size_t size) {
+        if(slot.capacity >= size)
+            return;
+        ReleaseSlot(slot);
+        // the GPU writes & the CPU reads the mapped memory; coherent mapping makes the writes visible once fenced.
+        auto flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glGenBuffers(1, &slot.buffer);
+        GLStateCache::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glBufferStorage(GL_PIXEL_PACK_BUFFER, (GLsizeiptr) size, nullptr, flags);
+        slot.mapped = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr) size, flags));
+        slot.capacity = size;
+        DEBUG_OPENGL("Frame Readback")
+        if(!slot.mapped)
+            DEBUG_RUNTIME_ERROR("Could not map a frame readback buffer.")
+    }
+
+    void FrameReadback::Capture(GLuint framebuffer, int width, int height) {
+        auto& slot = slots[next];
+        // all buffers in flight: the oldest frame has to arrive before its buffer is reused.
+        if(slot.fence){
+            stats.stalls++;
+            Deliver(slot, true);
+        }
+        Reserve(slot, (size_t) width * height * 4);
+
+        GLStateCache::BindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+        GLStateCache::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        // with a pack buffer bound, the pixels are copied into it asynchronously instead of returned.
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        GLStateCache::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        slot.frame = {frameIndex++, width, height, slot.mapped};
+        DEBUG_OPENGL("Frame Readback")
+
+        stats.captured++;
+        next = (next + 1) % slots.size();
+    }
+
+    bool FrameReadback::Deliver(Slot &slot, bool wait) {
+        if(!slot.fence)
+            return false;
+        auto status = glClientWaitSync(slot.fence, 0, 0);
+        if(status == GL_TIMEOUT_EXPIRED){
+            if(!wait)
+                return false;
+            do status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+            while(status == GL_TIMEOUT_EXPIRED);
+        }
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+        if(callback)
+            callback(slot.frame);
+        stats.delivered++;
+        return true;
+    }
+
+    void FrameReadback::Collect() {
+        // oldest first, stopping at the first frame still in flight to keep the capture order.
+        for(size_t i = 0; i < slots.size(); i++){
+            auto& slot = slots[(next + i) % slots.size()];
+            if(slot.fence && !Deliver(slot, false))
+                return;
+        }
+    }
+
+    void FrameReadback::Flush() {
+        for(size_t i = 0; i < slots.size(); i++)
+            Deliver(slots[(next + i) % slots.size()], true);
+    }
+}
@@ -0,0 +1,100 @@
+#include "engine/utilities/rendering/Frustum.h"
+#include "engine/utilities/Simd.h"
+
+#include <cmath>
+
+namespace EisEngine::rendering {
+    Frustum::Frustum(const glm::mat4 &viewProjection) { Update(viewProjection);}
+
+    // Gribb-Hartmann plane extraction; glm matrices are column major, so row i = (m[0][i], m[1][i], m[2][i], m[3][i]).
+    void Frustum::Update(const glm::mat4 &m) {
+        auto row = [&m](int i){ return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);};
+        auto r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+
+        planes = {r3 + r0, r3 - r0, r3 + r1, r3 - r1, r3 + r2, r3 - r2};
+
+        for(auto& p : planes){
+            auto len = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+            if(len > 0.0f)
+                p = p / len;
+        }
+
+        for(int i = 0; i < 8; i++){
+            const auto& p = planes[i < 6 ? i : 5];
+            nx[i] = p.x;
+            ny[i] = p.y;
+            nz[i] = p.z;
+            d[i] = p.w;
+            ax[i] = std::fabs(p.x);
+            ay[i] = std::fabs(p.y);
+            az[i] = std::fabs(p.z);
+        }
+    }
+
+    bool Frustum::TestSphere(const BoundingSphere &sphere) const {
+        const auto& c = sphere.center;
+#ifdef EIS_SSE
+        const auto cx = _mm_set1_ps(c.x);
+        const auto cy = _mm_set1_ps(c.y);
+        const auto cz = _mm_set1_ps(c.z);
+        const auto r = _mm_set1_ps(-sphere.radius);
+        for(int i = 0; i < 8; i += 4){
+            auto dist = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_load_ps(&nx[i]), cx), _mm_mul_ps(_mm_load_ps(&ny[i]), cy)),
+                    _mm_add_ps(_mm_mul_ps(_mm_load_ps(&nz[i]), cz), _mm_load_ps(&d[i])));
+            // outside if signed distance < -radius for any plane.
+            if(_mm_movemask_ps(_mm_cmplt_ps(dist, r)))
+                return false;
+        }
+        return true;
+#else
+        for(const auto& p : planes)
+            if(p.x * c.x + p.y * c.y + p.z * c.z + p.w < -sphere.radius)
+                return false;
+        return true;
+#endif
+    }
+
+    bool Frustum::TestAABB(const AABB &box) const {
+        auto c = box.Center();
+        auto e = box.Extents();
+#ifdef EIS_SSE
+        const auto cx = _mm_set1_ps(c.x);
+        const auto cy = _mm_set1_ps(c.y);
+        const auto cz = _mm_set1_ps(c.z);
+        const auto ex = _mm_set1_ps(e.x);
+        const auto ey = _mm_set1_ps(e.y);
+        const auto ez = _mm_set1_ps(e.z);
+        const auto zero = _mm_setzero_ps();
+        for(int i = 0; i < 8; i += 4){
+            auto dist = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_load_ps(&nx[i]), cx), _mm_mul_ps(_mm_load_ps(&ny[i]), cy)),
+                    _mm_add_ps(_mm_mul_ps(_mm_load_ps(&nz[i]), cz), _mm_load_ps(&d[i])));
+            // projected radius of the box onto the plane normal.
+            auto radius = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_load_ps(&ax[i]), ex), _mm_mul_ps(_mm_load_ps(&ay[i]), ey)),
+                    _mm_mul_ps(_mm_load_ps(&az[i]), ez));
+            if(_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(dist, radius), zero)))
+                return false;
+        }
+        return true;
+#else
+        for(const auto& p : planes){
+            auto dist = p.x * c.x + p.y * c.y + p.z * c.z + p.w;
+            auto radius = std::fabs(p.x) * e.x + std::fabs(p.y) * e.y + std::fabs(p.z) * e.z;
+            if(dist + radius < 0.0f)
+                return false;
+        }
+        return true;
+#endif
+    }
+
+    size_t Frustum::CullAABBs(const AABB *boxes, size_t count, unsigned char *visibility) const {
+        size_t visible = 0;
+        for(size_t i = 0; i < count; i++){
+            visibility[i] = TestAABB(boxes[i]) ? 1 : 0;
+            visible += visibility[i];
+        }
+        return visible;
+    }
+}
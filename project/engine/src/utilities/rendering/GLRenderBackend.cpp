@@ -0,0 +1,179 @@
+#include "engine/utilities/rendering/GLRenderBackend.h"
+#include "engine/utilities/rendering/Shader.h"
+#include "engine/components/meshes/Mesh3D.h"
+#include "engine/components/PointLight.h"
+#include "engine/components/Renderer.h"
+#include "engine/utilities/rendering/GLStateCache.h"
+
+#include <cstddef>
+
+// the shader storage binding point of the per-draw data of multi-draws; 0 - 2 hold the light clusters.
+#define DRAW_DATA_BINDING 3
+
+namespace EisEngine::rendering {
+    // the multi-draw shaders read the instance data as tightly packed floats: a mat4 followed by a mat3.
+    static_assert(sizeof(InstanceData) == 25 * sizeof(float), "InstanceData must be tightly packed");
+
+    // points the per-instance attributes to the instance buffer, starting at the given instance.
+    void BindInstanceAttributes(GLuint instanceVBO, GLintptr offset, GLint modelLoc, GLint normalLoc,
+                                size_t firstInstance){
+        GLStateCache::BindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        auto base = offset + firstInstance * sizeof(InstanceData);
+        // a mat4 attribute occupies 4 consecutive locations, a mat3 attribute 3.
+        if(modelLoc != -1)
+            for(int i = 0; i < 4; i++){
+                glEnableVertexAttribArray(modelLoc + i);
+                glVertexAttribPointer(modelLoc + i, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                                      (GLvoid*)(base + offsetof(InstanceData, model) + i * sizeof(glm::vec4)));
+                glVertexAttribDivisor(modelLoc + i, 1);
+            }
+        if(normalLoc != -1)
+            for(int i = 0; i < 3; i++){
+                glEnableVertexAttribArray(normalLoc + i);
+                glVertexAttribPointer(normalLoc + i, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                                      (GLvoid*)(base + offsetof(InstanceData, normalMat) + i * sizeof(glm::vec3)));
+                glVertexAttribDivisor(normalLoc + i, 1);
+            }
+    }
+
+    // resets per-instance attributes so that the shared VAO can be reused by non-instanced draws.
+    void ResetInstanceAttributes(GLint modelLoc, GLint normalLoc){
+        if(modelLoc != -1)
+            for(int i = 0; i < 4; i++){
+                glVertexAttribDivisor(modelLoc + i, 0);
+                glDisableVertexAttribArray(modelLoc + i);
+            }
+        if(normalLoc != -1)
+            for(int i = 0; i < 3; i++){
+                glVertexAttribDivisor(normalLoc + i, 0);
+                glDisableVertexAttribArray(normalLoc + i);
+            }
+    }
+
+    GLRenderBackend::GLRenderBackend(StreamingRingBuffer &stream) : stream(stream) { }
+
+    void GLRenderBackend::UploadInstances(const std::vector<InstanceData> &instances) {
+        instancesUploaded = false;
+        if(instances.empty())
+            return;
+        // written behind the data of draws still in flight instead of reallocating the buffer.
+        auto allocation = stream.Write(instances.data(), instances.size() * sizeof(InstanceData));
+        instanceOffset = allocation.offset;
+        instancesUploaded = allocation.data != nullptr;
+    }
+
+    void GLRenderBackend::ApplyLights(Shader &activeShader, const LightBlock &lights) {
+        // meshes out of range of a loader are drawn with the unlit shader variant, which has no lights.
+        if(lights.count < 0)
+            return;
+        for (int i = 0; i < lights.count; i++)
+            lights.lights[i]->Apply(activeShader, i);
+        activeShader.setInt("nLights", lights.count);
+    }
+
+    void GLRenderBackend::Submit(const RenderCommandList &list, Shader *activeShader) {
+        auto program = activeShader->GetShaderID();
+        GLint modelLoc = -1, normalLoc = -1;
+        auto instanceAttributesBound = false;
+
+        for(const auto& command : list.GetCommands()){
+            switch(command.type){
+                case RenderCommandType::SetMaterial:
+                    list.GetMaterial(command.payload)->ApplyData(*activeShader);
+                    break;
+                case RenderCommandType::SetTransform: {
+                    const auto& block = list.GetTransform(command.payload);
+                    activeShader->setMatrix("mvp", block.mvp);
+                    activeShader->setMatrix("model", block.model);
+                    activeShader->setMatrix("normalMat", block.normalMat);
+                    break;
+                }
+                case RenderCommandType::SetLights:
+                    ApplyLights(*activeShader, list.GetLights(command.payload));
+                    break;
+                case RenderCommandType::DrawMesh: {
+                    const auto& draw = list.GetDraw(command.payload);
+                    if(draw.instanceCount == 0){
+                        draw.mesh->draw(program);
+                        break;
+                    }
+                    if(!instancesUploaded)
+                        break;
+                    if(!instanceAttributesBound){
+                        modelLoc = glGetAttribLocation(program, "instanceModel");
+                        normalLoc = glGetAttribLocation(program, "instanceNormalMat");
+                        instanceAttributesBound = true;
+                    }
+                    draw.mesh->BindGeometry(program);
+                    BindInstanceAttributes(stream.GetBufferID(), instanceOffset, modelLoc, normalLoc, draw.firstInstance);
+                    draw.mesh->drawInstanced(draw.instanceCount);
+                    break;
+                }
+                case RenderCommandType::DrawMeshes:
+                    MultiDraw(list, list.GetMultiDraw(command.payload), *activeShader);
+                    break;
+            }
+        }
+
+        // reset per-instance attributes so that the shared VAO can be reused by non-instanced draws.
+        if(instanceAttributesBound)
+            ResetInstanceAttributes(modelLoc, normalLoc);
+    }
+
+    void GLRenderBackend::SubmitDepth(const RenderCommandList &list, Shader *depthShader) {
+        auto program = depthShader->GetShaderID();
+        auto modelLoc = glGetAttribLocation(program, "instanceModel");
+        auto instanced = false;
+
+        // materials & lights do not affect depth.
+        for(const auto& command : list.GetCommands()){
+            if(command.type == RenderCommandType::SetTransform)
+                depthShader->setMatrix("mvp", list.GetTransform(command.payload).mvp);
+            else if(command.type == RenderCommandType::DrawMesh){
+                const auto& draw = list.GetDraw(command.payload);
+                if(draw.instanceCount == 0){
+                    draw.mesh->draw(program);
+                    continue;
+                }
+                if(!instancesUploaded)
+                    continue;
+                draw.mesh->BindGeometry(program);
+                BindInstanceAttributes(stream.GetBufferID(), instanceOffset, modelLoc, -1, draw.firstInstance);
+                draw.mesh->drawInstanced(draw.instanceCount);
+                instanced = true;
+            }
+            else if(command.type == RenderCommandType::DrawMeshes)
+                MultiDraw(list, list.GetMultiDraw(command.payload), *depthShader);
+        }
+
+        if(instanced)
+            ResetInstanceAttributes(modelLoc, -1);
+    }
+
+    void GLRenderBackend::MultiDraw(const RenderCommandList &list, const MultiDrawCommand &draw, Shader &shader) {
+        // the draws read their transforms from the instance data.
+        if(!instancesUploaded)
+            return;
+        indirectCommands.resize(draw.drawCount);
+        for(int i = 0; i < draw.drawCount; i++){
+            auto mesh = list.GetMultiDrawMesh(draw.firstMesh + i);
+            indirectCommands[i] = {(GLuint) mesh->GetLOD(mesh->GetLODLevel()).count, 1, mesh->GetFirstIndex(),
+                                   mesh->GetBaseVertex(), 0};
+        }
+        auto size = indirectCommands.size() * sizeof(DrawElementsIndirectCommand);
+        auto commands = stream.Write(indirectCommands.data(), size);
+        if(!commands.data)
+            return;
+
+        // batches never mix index types (see RenderingSystem::DrawInstanced), so the first mesh's applies to all.
+        auto indexType = list.GetMultiDrawMesh(draw.firstMesh)->GetIndexType();
+        StaticGeometry::Bind(shader.GetShaderID(), indexType);
+        GLStateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, stream.GetBufferID());
+        GLStateCache::BindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_BINDING, stream.GetBufferID());
+        // the instance data is 16 byte aligned, so its offset is a whole amount of floats.
+        auto drawData = instanceOffset + draw.firstDraw * sizeof(InstanceData);
+        shader.setInt("drawDataOffset", (int) (drawData / sizeof(float)));
+        glMultiDrawElementsIndirect(GL_TRIANGLES, indexType, (GLvoid*) commands.offset, draw.drawCount, 0);
+        DEBUG_OPENGL("Multi-Draw")
+    }
+}
@@ -0,0 +1,227 @@
+#include "engine/utilities/rendering/GLStateCache.h"
+
+// marks a cached value as unknown; no valid object name or enum value.
+#define UNKNOWN_STATE 0xFFFFFFFFu
+
+namespace EisEngine::rendering {
+    // an array with all values unknown.
+    template<typename T, size_t N>
+    std::array<T, N> Unknown(T value = (T) UNKNOWN_STATE){
+        std::array<T, N> array;
+        array.fill(value);
+        return array;
+    }
+
+    GLuint GLStateCache::program = UNKNOWN_STATE;
+    GLuint GLStateCache::vertexArray = UNKNOWN_STATE;
+    std::array<GLuint, 7> GLStateCache::buffers = Unknown<GLuint, 7>();
+    GLuint GLStateCache::activeTexture = UNKNOWN_STATE;
+    std::array<std::array<GLuint, 3>, MAX_TRACKED_TEXTURE_UNITS> GLStateCache::textures =
+            Unknown<std::array<GLuint, 3>, MAX_TRACKED_TEXTURE_UNITS>(Unknown<GLuint, 3>());
+    GLuint GLStateCache::readFramebuffer = UNKNOWN_STATE;
+    GLuint GLStateCache::drawFramebuffer = UNKNOWN_STATE;
+    std::array<int8_t, 3> GLStateCache::capabilities = Unknown<int8_t, 3>(-1);
+    std::array<GLenum, 2> GLStateCache::blendFunc = Unknown<GLenum, 2>();
+    int8_t GLStateCache::depthMask = -1;
+    GLenum GLStateCache::depthFunc = UNKNOWN_STATE;
+    GLenum GLStateCache::cullFace = UNKNOWN_STATE;
+    int8_t GLStateCache::colorMask = -1;
+    std::array<GLint, 4> GLStateCache::viewport = Unknown<GLint, 4>(-1);
+    StateCacheStats GLStateCache::currentFrame = {};
+    StateCacheStats GLStateCache::previousFrame = {};
+
+    template<typename T>
+    bool GLStateCache::Change(T &cached, const T &value) {
+        if(cached == value){
+            currentFrame.filtered++;
+            return false;
+        }
+        cached = value;
+        currentFrame.issued++;
+        return true;
+    }
+
+    int GLStateCache::BufferSlot(GLenum target) {
+        switch(target){
+            case GL_ARRAY_BUFFER: return 0;
+            case GL_ELEMENT_ARRAY_BUFFER: return 1;
+            case GL_SHADER_STORAGE_BUFFER: return 2;
+            case GL_UNIFORM_BUFFER: return 3;
+            case GL_DRAW_INDIRECT_BUFFER: return 4;
+            case GL_PIXEL_PACK_BUFFER: return 5;
+            case GL_PIXEL_UNPACK_BUFFER: return 6;
+            default: return -1;
+        }
+    }
+
+    int GLStateCache::TextureSlot(GLenum target) {
+        switch(target){
+            case GL_TEXTURE_2D: return 0;
+            case GL_TEXTURE_CUBE_MAP: return 1;
+            case GL_TEXTURE_2D_ARRAY: return 2;
+            default: return -1;
+        }
+    }
+
+    int8_t *GLStateCache::Capability(GLenum capability) {
+        switch(capability){
+            case GL_BLEND: return &capabilities[0];
+            case GL_DEPTH_TEST: return &capabilities[1];
+            case GL_CULL_FACE: return &capabilities[2];
+            default: return nullptr;
+        }
+    }
+
+    void GLStateCache::UseProgram(GLuint value) {
+        if(Change(program, value))
+            glUseProgram(value);
+    }
+
+    void GLStateCache::BindVertexArray(GLuint value) {
+        if(!Change(vertexArray, value))
+            return;
+        glBindVertexArray(value);
+        buffers[BufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN_STATE;
+    }
+
+    void GLStateCache::BindBuffer(GLenum target, GLuint buffer) {
+        auto slot = BufferSlot(target);
+        if(slot < 0 || Change(buffers[slot], buffer))
+            glBindBuffer(target, buffer);
+    }
+
+    void GLStateCache::BindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+        glBindBufferBase(target, index, buffer);
+        currentFrame.issued++;
+        auto slot = BufferSlot(target);
+        if(slot >= 0)
+            buffers[slot] = buffer;
+    }
+
+    void GLStateCache::BindTexture(GLuint unit, GLenum target, GLuint texture) {
+        auto slot = TextureSlot(target);
+        if(slot >= 0 && unit < MAX_TRACKED_TEXTURE_UNITS && textures[unit][slot] == texture){
+            currentFrame.filtered++;
+            return;
+        }
+        if(Change(activeTexture, unit))
+            glActiveTexture(GL_TEXTURE0 + unit);
+        BindTexture(target, texture);
+    }
+
+    void GLStateCache::BindTexture(GLenum target, GLuint texture) {
+        auto slot = TextureSlot(target);
+        // the active unit is unknown after an invalidation; bind on the default unit then.
+        if(activeTexture == UNKNOWN_STATE){
+            glActiveTexture(GL_TEXTURE0);
+            activeTexture = 0;
+            currentFrame.issued++;
+        }
+        if(slot < 0 || activeTexture >= MAX_TRACKED_TEXTURE_UNITS || Change(textures[activeTexture][slot], texture))
+            glBindTexture(target, texture);
+    }
+
+    void GLStateCache::BindFramebuffer(GLenum target, GLuint framebuffer) {
+        if(target == GL_FRAMEBUFFER){
+            if(readFramebuffer == framebuffer && drawFramebuffer == framebuffer){
+                currentFrame.filtered++;
+                return;
+            }
+            readFramebuffer = drawFramebuffer = framebuffer;
+            currentFrame.issued++;
+            glBindFramebuffer(target, framebuffer);
+            return;
+        }
+        auto& cached = target == GL_READ_FRAMEBUFFER ? readFramebuffer : drawFramebuffer;
+        if(Change(cached, framebuffer))
+            glBindFramebuffer(target, framebuffer);
+    }
+
+    void GLStateCache::Enable(GLenum capability) {
+        auto cached = Capability(capability);
+        if(!cached || Change(*cached, (int8_t) 1))
+            glEnable(capability);
+    }
+
+    void GLStateCache::Disable(GLenum capability) {
+        auto cached = Capability(capability);
+        if(!cached || Change(*cached, (int8_t) 0))
+            glDisable(capability);
+    }
+
+    void GLStateCache::BlendFunc(GLenum source, GLenum destination) {
+        if(Change(blendFunc, {source, destination}))
+            glBlendFunc(source, destination);
+    }
+
+    void GLStateCache::BlendFunci(GLuint drawBuffer, GLenum source, GLenum destination) {
+        glBlendFunci(drawBuffer, source, destination);
+        currentFrame.issued++;
+        // the draw buffers no longer share a single blend function.
+        blendFunc = {UNKNOWN_STATE, UNKNOWN_STATE};
+    }
+
+    void GLStateCache::DepthMask(bool write) {
+        if(Change(depthMask, (int8_t) write))
+            glDepthMask(write ? GL_TRUE : GL_FALSE);
+    }
+
+    void GLStateCache::DepthFunc(GLenum function) {
+        if(Change(depthFunc, function))
+            glDepthFunc(function);
+    }
+
+    void GLStateCache::CullFace(GLenum face) {
+        if(Change(cullFace, face))
+            glCullFace(face);
+    }
+
+    void GLStateCache::ColorMask(bool write) {
+        auto value = write ? GL_TRUE : GL_FALSE;
+        if(Change(colorMask, (int8_t) write))
+            glColorMask(value, value, value, value);
+    }
+
+    void GLStateCache::Viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+        if(Change(viewport, {x, y, width, height}))
+            glViewport(x, y, width, height);
+    }
+
+    std::array<GLint, 4> GLStateCache::GetViewport() {
+        if(viewport[2] < 0)
+            glGetIntegerv(GL_VIEWPORT, viewport.data());
+        return viewport;
+    }
+
+    void GLStateCache::OnBufferDeleted(GLuint buffer) {
+        for(auto& bound : buffers)
+            if(bound == buffer)
+                bound = UNKNOWN_STATE;
+    }
+
+    void GLStateCache::OnTextureDeleted(GLuint texture) {
+        for(auto& unit : textures)
+            for(auto& bound : unit)
+                if(bound == texture)
+                    bound = UNKNOWN_STATE;
+    }
+
+    void GLStateCache::Invalidate() {
+        program = vertexArray = activeTexture = UNKNOWN_STATE;
+        readFramebuffer = drawFramebuffer = UNKNOWN_STATE;
+        buffers.fill(UNKNOWN_STATE);
+        for(auto& unit : textures)
+            unit.fill(UNKNOWN_STATE);
+        capabilities.fill(-1);
+        blendFunc.fill(UNKNOWN_STATE);
+        depthMask = colorMask = -1;
+        depthFunc = cullFace = UNKNOWN_STATE;
+        viewport = {-1, -1, -1, -1};
+    }
+
+    void GLStateCache::BeginFrame() {
+        previousFrame = currentFrame;
+        currentFrame = {};
+        Invalidate();
+    }
+}
@@ -0,0 +1,185 @@
+#include "engine/utilities/rendering/GeometryArena.h"
+#include "engine/utilities/rendering/GLStateCache.h"
+#include "engine/utilities/Debug.h"
+#include "engine/Context.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace EisEngine::rendering {
+    // rounds a size up to a multiple of the alignment, which need not be a power of two (e.g. a vertex size).
+    size_t AlignUp(size_t size, size_t alignment){
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    GeometryArena::GeometryArena(size_t capacity, size_t alignment) :
+    capacity(AlignUp(std::max<size_t>(capacity, 1), std::max<size_t>(alignment, 1))),
+    alignment(std::max<size_t>(alignment, 1)) {
+        freeBlocks.push_back({0, this->capacity});
+    }
+
+    void GeometryArena::CreateBuffer() {
+        if(!ctx::Context::HasGraphics())
+            return;
+        glGenBuffers(1, &buffer);
+        // the copy targets are no vertex array state, so that uploads leave the bound VAO's index buffer alone.
+        GLStateCache::BindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr) capacity, nullptr, GL_STATIC_DRAW);
+        DEBUG_OPENGL("Geometry Arena")
+    }
+
+    bool GeometryArena::TakeFreeBlock(size_t size, size_t &offset) {
+        auto it = std::find_if(freeBlocks.begin(), freeBlocks.end(), [&](const Block& block){
+            return block.size >= size;
+        });
+        if(it == freeBlocks.end())
+            return false;
+        offset = it->offset;
+        it->offset += size;
+        it->size -= size;
+        if(it->size == 0)
+            freeBlocks.erase(it);
+        return true;
+    }
+
+    GeometryArena::Handle GeometryArena::Allocate(const void *data, size_t size) {
+        if(size == 0)
+            return INVALID_HANDLE;
+        auto alignedSize = AlignUp(size, alignment);
+        if(buffer == 0)
+            CreateBuffer();
+
+        size_t offset = 0;
+        if(!TakeFreeBlock(alignedSize, offset)){
+            // compacting suffices if the free ranges add up to enough memory, else the arena grows.
+            auto required = used + alignedSize;
+            Relocate(required <= capacity ? capacity : std::max(capacity * 2, AlignUp(required, alignment)));
+            TakeFreeBlock(alignedSize, offset);
+        }
+
+        Handle handle;
+        if(!freeHandles.empty()){
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+        }
+        else{
+            handle = (Handle) allocations.size();
+            allocations.emplace_back();
+        }
+        allocations[handle] = {offset, alignedSize};
+        used += alignedSize;
+
+        if(data && buffer != 0){
+            GLStateCache::BindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr) offset, (GLsizeiptr) size, data);
+            DEBUG_OPENGL("Geometry Arena")
+        }
+        return handle;
+    }
+
+    void GeometryArena::Free(Handle handle) {
+        if(handle == INVALID_HANDLE || handle >= allocations.size() || allocations[handle].size == 0)
+            return;
+        auto block = allocations[handle];
+        allocations[handle] = {};
+        freeHandles.push_back(handle);
+        used -= block.size;
+
+        // insert sorted by offset & merge with the neighbouring free ranges.
+        auto next = std::lower_bound(freeBlocks.begin(), freeBlocks.end(), block, [](const Block& a, const Block& b){
+            return a.offset < b.offset;
+        });
+        if(next != freeBlocks.end() && block.offset + block.size == next->offset){
+            block.size += next->size;
+            next = freeBlocks.erase(next);
+        }
+        if(next != freeBlocks.begin()){
+            auto previous = std::prev(next);
+            if(previous->offset + previous->size == block.offset){
+                previous->size += block.size;
+                return;
+            }
+        }
+        freeBlocks.insert(next, block);
+    }
+
+    void GeometryArena::Defragment() {
+        if(freeBlocks.size() > 1 || (freeBlocks.size() == 1 && freeBlocks[0].offset + freeBlocks[0].size != capacity))
+            Relocate(capacity);
+    }
+
+    void GeometryArena::Relocate(size_t newCapacity) {
+        if(newCapacity > capacity)
+            growths++;
+        else
+            defragmentations++;
+
+        // the allocations keep their order, so that the copies read & write ascending ranges.
+        std::vector<Handle> order(allocations.size());
+        std::iota(order.begin(), order.end(), 0);
+        order.erase(std::remove_if(order.begin(), order.end(), [&](Handle h){ return allocations[h].size == 0;}),
+                    order.end());
+        std::sort(order.begin(), order.end(), [&](Handle a, Handle b){
+            return allocations[a].offset < allocations[b].offset;
+        });
+
+        // glCopyBufferSubData may not copy between overlapping ranges of a buffer, so copy into a new one.
+        auto oldBuffer = buffer;
+        capacity = newCapacity;
+        CreateBuffer();
+        if(oldBuffer != 0)
+            GLStateCache::BindBuffer(GL_COPY_READ_BUFFER, oldBuffer);
+
+        size_t offset = 0;
+        for(auto handle : order){
+            auto& allocation = allocations[handle];
+            if(oldBuffer != 0 && buffer != 0)
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (GLintptr) allocation.offset,
+                                    (GLintptr) offset, (GLsizeiptr) allocation.size);
+            allocation.offset = offset;
+            offset += allocation.size;
+        }
+        freeBlocks.clear();
+        if(offset < capacity)
+            freeBlocks.push_back({offset, capacity - offset});
+
+        if(oldBuffer != 0){
+            GLStateCache::OnBufferDeleted(oldBuffer);
+            glDeleteBuffers(1, &oldBuffer);
+            DEBUG_OPENGL("Geometry Arena Relocation")
+        }
+    }
+
+    void GeometryArena::Release() {
+        if(buffer == 0)
+            return;
+        if(ctx::Context::HasGraphics()){
+            GLStateCache::OnBufferDeleted(buffer);
+            glDeleteBuffers(1, &buffer);
+        }
+        buffer = 0;
+    }
+
+    float GeometryArena::GetFragmentation() const {
+        auto free = capacity - used;
+        if(free == 0)
+            return 0.0f;
+        size_t largest = 0;
+        for(const auto& block : freeBlocks)
+            largest = std::max(largest, block.size);
+        return 1.0f - (float) largest / (float) free;
+    }
+
+    GeometryArenaStats GeometryArena::GetStats() const {
+        GeometryArenaStats stats;
+        stats.capacity = capacity;
+        stats.used = used;
+        stats.allocations = allocations.size() - freeHandles.size();
+        stats.freeBlocks = freeBlocks.size();
+        for(const auto& block : freeBlocks)
+            stats.largestFreeBlock = std::max(stats.largestFreeBlock, block.size);
+        stats.defragmentations = defragmentations;
+        stats.growths = growths;
+        return stats;
+    }
+}
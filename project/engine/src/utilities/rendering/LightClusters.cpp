@@ -0,0 +1,143 @@
+#include "engine/utilities/rendering/LightClusters.h"
+#include "engine/utilities/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace EisEngine::rendering {
+    LightClusters::LightClusters(const glm::uvec3 &dimensions) : dimensions(dimensions),
+        ranges(dimensions.x * dimensions.y * dimensions.z, ClusterRange{0, 0}),
+        sliceEntries(dimensions.z) { }
+
+    void LightClusters::SetProjection(const glm::mat4 &projection) {
+        projectionScale = glm::vec2(projection[0][0], projection[1][1]);
+        // perspective matrices move -z into w, orthographic ones keep w = 1.
+        orthographic = projection[3][3] > 0.5f;
+        if(orthographic){
+            nearPlane = (projection[3][2] + 1.0f) / projection[2][2];
+            farPlane = (projection[3][2] - 1.0f) / projection[2][2];
+        }
+        else{
+            nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+            farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+        }
+    }
+
+    glm::vec3 LightClusters::GetSliceParameters() const {
+        auto slices = (float) dimensions.z;
+        if(orthographic){
+            auto scale = slices / (farPlane - nearPlane);
+            return {scale, -nearPlane * scale, 0.0f};
+        }
+        auto logRange = std::log(farPlane / nearPlane);
+        return {slices / logRange, -slices * std::log(nearPlane) / logRange, 1.0f};
+    }
+
+    float LightClusters::SliceStart(uint32_t slice) const {
+        auto t = (float) slice / (float) dimensions.z;
+        if(orthographic)
+            return nearPlane + (farPlane - nearPlane) * t;
+        return nearPlane * std::pow(farPlane / nearPlane, t);
+    }
+
+    uint32_t LightClusters::SliceOf(float depth) const {
+        auto params = GetSliceParameters();
+        if(params.z > 0.5f && depth <= 0.0f)
+            return 0;
+        auto s = (params.z > 0.5f ? std::log(depth) : depth) * params.x + params.y;
+        return (uint32_t) std::clamp(std::floor(s), 0.0f, (float) dimensions.z - 1.0f);
+    }
+
+    void LightClusters::Assign(const glm::mat4 &view, const std::vector<ClusterLight> &lights, ThreadPool *pool) {
+        std::vector<glm::vec4> viewLights;
+        viewLights.reserve(lights.size());
+        for(const auto& light : lights){
+            auto p = view * glm::vec4(light.posRange.x, light.posRange.y, light.posRange.z, 1.0f);
+            // store the depth as a positive distance in front of the camera.
+            viewLights.emplace_back(p.x, p.y, -p.z, light.posRange.w);
+        }
+
+        for(auto& range : ranges)
+            range = {0, 0};
+
+        auto assignSlices = [&](size_t begin, size_t end){
+            for(auto s = begin; s < end; s++)
+                AssignSlice((uint32_t) s, viewLights);
+        };
+        if(pool)
+            pool->ParallelFor(dimensions.z, assignSlices);
+        else
+            assignSlices(0, dimensions.z);
+
+        // prefix sum over all clusters gives each cluster its place in the index list.
+        auto limit = maxLightsPerCluster > 0 ? maxLightsPerCluster : UINT32_MAX;
+        uint32_t total = 0;
+        for(auto& range : ranges){
+            range.offset = total;
+            total += std::min(range.count, limit);
+            range.count = 0;
+        }
+        indices.resize(total);
+
+        // slices own disjoint clusters, so they can be scattered independently.
+        auto tilesPerSlice = dimensions.x * dimensions.y;
+        auto scatterSlices = [&](size_t begin, size_t end){
+            for(auto s = begin; s < end; s++)
+                for(const auto& [tile, light] : sliceEntries[s]){
+                    auto& range = ranges[tile + tilesPerSlice * s];
+                    // entries are ordered by light, so a full cluster keeps the lights given first.
+                    if(range.count < limit)
+                        indices[range.offset + range.count++] = light;
+                }
+        };
+        if(pool)
+            pool->ParallelFor(dimensions.z, scatterSlices);
+        else
+            scatterSlices(0, dimensions.z);
+    }
+
+    void LightClusters::AssignSlice(uint32_t slice, const std::vector<glm::vec4> &viewLights) {
+        auto& entries = sliceEntries[slice];
+        entries.clear();
+
+        auto zNear = SliceStart(slice);
+        auto zFar = SliceStart(slice + 1);
+        auto toTile = [](float ndc, uint32_t tiles){
+            return (uint32_t) std::clamp((int) std::floor((ndc + 1.0f) * 0.5f * (float) tiles), 0, (int) tiles - 1);
+        };
+
+        for(uint32_t i = 0; i < viewLights.size(); i++){
+            const auto& light = viewLights[i];
+            auto r = light.w;
+            if(light.z + r < zNear || light.z - r > zFar)
+                continue;
+
+            // screen space extent of the light's bounding box within this slice.
+            glm::vec2 lo, hi;
+            if(orthographic){
+                lo = (glm::vec2(light.x, light.y) - r) * projectionScale;
+                hi = (glm::vec2(light.x, light.y) + r) * projectionScale;
+            }
+            else{
+                auto dMin = std::max(zNear, light.z - r);
+                auto dMax = std::min(zFar, light.z + r);
+                for(int axis = 0; axis < 2; axis++){
+                    auto a = light[axis] - r;
+                    auto b = light[axis] + r;
+                    lo[axis] = (a < 0.0f ? a / dMin : a / dMax) * projectionScale[axis];
+                    hi[axis] = (b > 0.0f ? b / dMin : b / dMax) * projectionScale[axis];
+                }
+            }
+            if(hi.x < -1.0f || lo.x > 1.0f || hi.y < -1.0f || lo.y > 1.0f)
+                continue;
+
+            auto x0 = toTile(lo.x, dimensions.x), x1 = toTile(hi.x, dimensions.x);
+            auto y0 = toTile(lo.y, dimensions.y), y1 = toTile(hi.y, dimensions.y);
+            for(auto y = y0; y <= y1; y++)
+                for(auto x = x0; x <= x1; x++){
+                    entries.emplace_back(x + dimensions.x * y, i);
+                    ranges[ClusterIndex(x, y, slice)].count++;
+                }
+        }
+    }
+}
@@ -0,0 +1,120 @@
+#include "engine/utilities/rendering/LightGrid.h"
+#include "engine/ecs/Entity.h"
+#include "engine/components/PointLight.h"
+#include "engine/components/Transform.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace EisEngine::rendering {
+    LightGrid::LightGrid(float cellSize) : cellSize(cellSize) { }
+
+    LightGrid::CellKey LightGrid::KeyOf(const glm::vec3 &pos) const {
+        return Pack((int32_t) std::floor(pos.x / cellSize), (int32_t) std::floor(pos.z / cellSize));
+    }
+
+    void LightGrid::BeginUpdate() {
+        frame++;
+    }
+
+    void LightGrid::Track(PointLight &light) {
+        auto& state = tracked[&light];
+        // a different light may have been allocated at the address of a removed one.
+        auto isNew = state.transform == nullptr || state.owner != light.GetOwner();
+        if(isNew){
+            if(state.transform)
+                Erase(&light, state.cell);
+            state.owner = light.GetOwner();
+            state.transform = light.entity()->transform;
+        }
+        state.lastSeen = frame;
+
+        auto version = state.transform->GetVersion();
+        if(!isNew && version == state.version)
+            return;
+        state.version = version;
+
+        glm::vec3 pos = state.transform->GetGlobalPosition();
+        auto cell = KeyOf(pos);
+        if(!isNew && cell == state.cell){
+            for(auto& entry : cells[cell])
+                if(entry.light == &light)
+                    entry.position = pos;
+            return;
+        }
+
+        if(!isNew)
+            Erase(&light, state.cell);
+        Insert(&light, cell, pos);
+        state.cell = cell;
+    }
+
+    void LightGrid::EndUpdate() {
+        for(auto it = tracked.begin(); it != tracked.end();){
+            if(it->second.lastSeen == frame){
+                ++it;
+                continue;
+            }
+            Erase(it->first, it->second.cell);
+            it = tracked.erase(it);
+        }
+    }
+
+    void LightGrid::Insert(PointLight *light, CellKey cell, const glm::vec3 &pos) {
+        cells[cell].push_back({light, pos});
+    }
+
+    void LightGrid::Erase(PointLight *light, CellKey cell) {
+        auto it = cells.find(cell);
+        if(it == cells.end())
+            return;
+
+        auto& entries = it->second;
+        for(size_t i = 0; i < entries.size(); i++)
+            if(entries[i].light == light){
+                entries[i] = entries.back();
+                entries.pop_back();
+                break;
+            }
+        if(entries.empty())
+            cells.erase(it);
+    }
+
+    int LightGrid::QueryNearest(const glm::vec3 &pos, int k, LightCandidate *scratch, int scratchCapacity,
+                                PointLight **out) const {
+        if(k <= 0 || scratchCapacity <= k)
+            return 0;
+
+        auto closer = [](const LightCandidate& a, const LightCandidate& b){ return a.distance2 < b.distance2;};
+        auto cx = (int32_t) std::floor(pos.x / cellSize);
+        auto cz = (int32_t) std::floor(pos.z / cellSize);
+
+        int count = 0;
+        for(int32_t dx = -1; dx <= 1; dx++)
+            for(int32_t dz = -1; dz <= 1; dz++){
+                auto it = cells.find(Pack(cx + dx, cz + dz));
+                if(it == cells.end())
+                    continue;
+
+                for(const auto& entry : it->second){
+                    // keep only the k closest candidates once the scratch buffer is full.
+                    if(count == scratchCapacity){
+                        std::nth_element(scratch, scratch + k, scratch + count, closer);
+                        count = k;
+                    }
+                    auto d = entry.position - pos;
+                    scratch[count++] = {entry.light, glm::dot(d, d)};
+                }
+            }
+
+        if(count > k){
+            std::nth_element(scratch, scratch + k, scratch + count, closer);
+            count = k;
+        }
+        std::sort(scratch, scratch + count, closer);
+
+        for(int i = 0; i < count; i++)
+            out[i] = scratch[i].light;
+        return count;
+    }
+}
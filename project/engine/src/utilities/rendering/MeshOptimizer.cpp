@@ -0,0 +1,348 @@
+#include "engine/utilities/rendering/MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+
+// the size of the LRU cache modelled by the vertex cache optimization.
+#define VERTEX_CACHE_SIZE 32
+// the score of the vertices of the last emitted triangle; lower than the next slots', so that strips do not
+// simply continue from the newest edge.
+#define LAST_TRIANGLE_SCORE 0.75f
+// how fast a vertex's score decays as it moves towards the end of the cache.
+#define CACHE_DECAY_POWER 1.5f
+// the bonus of vertices with few remaining triangles, so that they are finished instead of left behind.
+#define VALENCE_BOOST_SCALE 2.0f
+#define VALENCE_BOOST_POWER 0.5f
+// the width & height in pixels of the views rasterized to measure overdraw.
+#define OVERDRAW_RESOLUTION 128
+
+namespace EisEngine::rendering {
+    // marks a triangle or vertex as not found / not assigned.
+    const unsigned int NONE = std::numeric_limits<unsigned int>::max();
+
+    // a FIFO post-transform vertex cache: a vertex stays cached until 'size' other vertices entered after it.
+    struct CacheSimulation {
+        // the time at which each vertex entered the cache, 0 if never.
+        std::vector<size_t> entered;
+        size_t size;
+        // the amount of vertices that entered the cache so far.
+        size_t time = 0;
+
+        CacheSimulation(size_t vertexCount, size_t size) : entered(vertexCount, 0), size(size) { }
+
+        // the amount of vertices of a triangle missing the cache, which then enter it.
+        int Triangle(const unsigned int* triangle){
+            auto misses = 0;
+            for(int i = 0; i < 3; i++){
+                auto v = triangle[i];
+                if(entered[v] == 0 || time - entered[v] >= size){
+                    entered[v] = ++time;
+                    misses++;
+                }
+            }
+            return misses;
+        }
+
+        // evicts all vertices.
+        void Flush(){ time += size;}
+    };
+
+    // scores a vertex by its position in the cache (-1 if not cached) & its amount of unemitted triangles.
+    float VertexScore(int cachePosition, unsigned int remaining){
+        if(remaining == 0)
+            return -1.0f;
+        auto score = 0.0f;
+        if(cachePosition >= 0){
+            if(cachePosition < 3)
+                score = LAST_TRIANGLE_SCORE;
+            else
+                score = std::pow(1.0f - (float) (cachePosition - 3) / (VERTEX_CACHE_SIZE - 3), CACHE_DECAY_POWER);
+        }
+        return score + VALENCE_BOOST_SCALE * std::pow((float) remaining, -VALENCE_BOOST_POWER);
+    }
+
+    std::vector<unsigned int> OptimizeVertexCache(const std::vector<unsigned int> &indices, size_t vertexCount) {
+        auto triangleCount = indices.size() / 3;
+        if(triangleCount < 2)
+            return indices;
+
+        // the triangles of each vertex; the first 'remaining' entries are those not emitted yet.
+        std::vector<unsigned int> remaining(vertexCount, 0);
+        for(auto index : indices)
+            remaining[index]++;
+        std::vector<unsigned int> offsets(vertexCount + 1, 0);
+        for(size_t v = 0; v < vertexCount; v++)
+            offsets[v + 1] = offsets[v] + remaining[v];
+        std::vector<unsigned int> adjacency(indices.size());
+        std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+        for(size_t i = 0; i < indices.size(); i++)
+            adjacency[fill[indices[i]]++] = (unsigned int) (i / 3);
+
+        std::vector<int> cachePosition(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+        for(size_t v = 0; v < vertexCount; v++)
+            vertexScores[v] = VertexScore(-1, remaining[v]);
+        std::vector<float> triangleScores(triangleCount);
+        auto bestTriangle = NONE;
+        auto bestScore = -1.0f;
+        for(size_t t = 0; t < triangleCount; t++){
+            triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+                                vertexScores[indices[t * 3 + 2]];
+            if(triangleScores[t] > bestScore){
+                bestScore = triangleScores[t];
+                bestTriangle = (unsigned int) t;
+            }
+        }
+
+        std::vector<char> emitted(triangleCount, 0);
+        std::vector<unsigned int> cache, nextCache;
+        cache.reserve(VERTEX_CACHE_SIZE + 3);
+        nextCache.reserve(VERTEX_CACHE_SIZE + 3);
+        std::vector<unsigned int> result;
+        result.reserve(indices.size());
+        size_t cursor = 0;
+
+        for(size_t n = 0; n < triangleCount; n++){
+            // no cached vertex has triangles left: continue with the next unemitted triangle.
+            if(bestTriangle == NONE){
+                while(emitted[cursor])
+                    cursor++;
+                bestTriangle = (unsigned int) cursor;
+            }
+            auto triangle = &indices[bestTriangle * 3];
+            emitted[bestTriangle] = 1;
+            result.insert(result.end(), triangle, triangle + 3);
+
+            // remove the triangle from its vertices' remaining triangles.
+            for(int i = 0; i < 3; i++){
+                auto v = triangle[i];
+                auto begin = adjacency.begin() + offsets[v];
+                auto it = std::find(begin, begin + remaining[v], bestTriangle);
+                std::iter_swap(it, begin + remaining[v] - 1);
+                remaining[v]--;
+            }
+
+            // the triangle's vertices move to the front of the cache, pushing the others back.
+            nextCache.clear();
+            for(int i = 0; i < 3; i++)
+                if(std::find(nextCache.begin(), nextCache.end(), triangle[i]) == nextCache.end())
+                    nextCache.push_back(triangle[i]);
+            for(auto v : cache)
+                if(v != triangle[0] && v != triangle[1] && v != triangle[2])
+                    nextCache.push_back(v);
+
+            // rescore the vertices whose position changed & their triangles; the best cached triangle is next.
+            for(size_t i = 0; i < nextCache.size(); i++){
+                auto v = nextCache[i];
+                cachePosition[v] = i < VERTEX_CACHE_SIZE ? (int) i : -1;
+                vertexScores[v] = VertexScore(cachePosition[v], remaining[v]);
+            }
+            bestTriangle = NONE;
+            bestScore = -1.0f;
+            for(size_t i = 0; i < nextCache.size(); i++){
+                auto v = nextCache[i];
+                for(auto a = offsets[v]; a < offsets[v] + remaining[v]; a++){
+                    auto t = adjacency[a];
+                    triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+                                        vertexScores[indices[t * 3 + 2]];
+                    if(i < VERTEX_CACHE_SIZE && triangleScores[t] > bestScore){
+                        bestScore = triangleScores[t];
+                        bestTriangle = t;
+                    }
+                }
+            }
+            if(nextCache.size() > VERTEX_CACHE_SIZE)
+                nextCache.resize(VERTEX_CACHE_SIZE);
+            std::swap(cache, nextCache);
+        }
+        return result;
+    }
+
+    std::vector<unsigned int> OptimizeOverdraw(const std::vector<glm::vec3> &positions,
+                                               const std::vector<unsigned int> &indices, float threshold) {
+        auto triangleCount = indices.size() / 3;
+        if(triangleCount < 2)
+            return indices;
+
+        // hard boundaries: a cluster starts wherever the cache starts over, i.e. all three vertices of a triangle
+        // miss; moving such clusters around barely changes the amount of misses.
+        std::vector<size_t> hardStarts;
+        CacheSimulation cache(positions.size(), VERTEX_CACHE_SIZE);
+        for(size_t t = 0; t < triangleCount; t++)
+            if(cache.Triangle(&indices[t * 3]) == 3)
+                hardStarts.push_back(t);
+        hardStarts.push_back(triangleCount);
+
+        // soft boundaries: a cluster is split once its own misses, starting with an empty cache, come close enough
+        // to the misses of the whole cluster; the smaller clusters are sorted more finely.
+        std::vector<size_t> clusterStarts;
+        for(size_t h = 0; h + 1 < hardStarts.size(); h++){
+            auto begin = hardStarts[h], end = hardStarts[h + 1];
+            cache.Flush();
+            size_t misses = 0;
+            for(auto t = begin; t < end; t++)
+                misses += cache.Triangle(&indices[t * 3]);
+            auto clusterThreshold = (float) misses / (float) (end - begin) * threshold;
+
+            cache.Flush();
+            clusterStarts.push_back(begin);
+            auto start = begin;
+            misses = 0;
+            for(auto t = begin; t + 1 < end; t++){
+                misses += cache.Triangle(&indices[t * 3]);
+                if((float) misses / (float) (t + 1 - start) <= clusterThreshold){
+                    clusterStarts.push_back(t + 1);
+                    start = t + 1;
+                    misses = 0;
+                    cache.Flush();
+                }
+            }
+        }
+        if(clusterStarts.size() < 2)
+            return indices;
+        clusterStarts.push_back(triangleCount);
+
+        // the area weighted centroids & normals of the mesh & its clusters.
+        struct Cluster {
+            glm::vec3 centroid = glm::vec3(0.0f);
+            glm::vec3 normal = glm::vec3(0.0f);
+            float area = 0.0f;
+            float key = 0.0f;
+        };
+        std::vector<Cluster> clusters(clusterStarts.size() - 1);
+        auto meshCentroid = glm::vec3(0.0f);
+        auto meshArea = 0.0f;
+        for(size_t c = 0; c < clusters.size(); c++){
+            auto& cluster = clusters[c];
+            for(auto t = clusterStarts[c]; t < clusterStarts[c + 1]; t++){
+                const auto& a = positions[indices[t * 3]];
+                const auto& b = positions[indices[t * 3 + 1]];
+                const auto& d = positions[indices[t * 3 + 2]];
+                auto normal = glm::cross(b - a, d - a);
+                auto area = glm::length(normal);
+                cluster.centroid += (a + b + d) * (area / 3.0f);
+                cluster.normal += normal;
+                cluster.area += area;
+            }
+            meshCentroid += cluster.centroid;
+            meshArea += cluster.area;
+            if(cluster.area > 0.0f)
+                cluster.centroid /= cluster.area;
+        }
+        if(meshArea > 0.0f)
+            meshCentroid /= meshArea;
+
+        // clusters far out along their own normal lie on the outside & are drawn first.
+        for(auto& cluster : clusters){
+            auto length = glm::length(cluster.normal);
+            cluster.key = length > 0.0f ? glm::dot(cluster.centroid - meshCentroid, cluster.normal / length) : 0.0f;
+        }
+        std::vector<size_t> order(clusters.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b){
+            return clusters[a].key > clusters[b].key;
+        });
+
+        std::vector<unsigned int> result;
+        result.reserve(indices.size());
+        for(auto c : order)
+            result.insert(result.end(), indices.begin() + (long) clusterStarts[c] * 3,
+                          indices.begin() + (long) clusterStarts[c + 1] * 3);
+
+        // keep the cache efficiency if the new order costs too much of it.
+        if(AnalyzeVertexCache(result, positions.size()) > AnalyzeVertexCache(indices, positions.size()) * threshold)
+            return indices;
+        return result;
+    }
+
+    std::vector<unsigned int> OptimizeVertexFetch(std::vector<unsigned int> &indices, size_t vertexCount) {
+        std::vector<unsigned int> remap(vertexCount, NONE);
+        unsigned int next = 0;
+        for(auto& index : indices){
+            if(remap[index] == NONE)
+                remap[index] = next++;
+            index = remap[index];
+        }
+        for(auto& newIndex : remap)
+            if(newIndex == NONE)
+                newIndex = next++;
+        return remap;
+    }
+
+    float AnalyzeVertexCache(const std::vector<unsigned int> &indices, size_t vertexCount, size_t cacheSize) {
+        if(indices.size() < 3)
+            return 0.0f;
+        CacheSimulation cache(vertexCount, cacheSize);
+        size_t misses = 0;
+        for(size_t t = 0; t + 2 < indices.size(); t += 3)
+            misses += cache.Triangle(&indices[t]);
+        return (float) misses / (float) (indices.size() / 3);
+    }
+
+    float AnalyzeOverdraw(const std::vector<glm::vec3> &positions, const std::vector<unsigned int> &indices) {
+        if(positions.empty() || indices.size() < 3)
+            return 0.0f;
+        auto minimum = positions[0], maximum = positions[0];
+        for(const auto& p : positions){
+            minimum = glm::min(minimum, p);
+            maximum = glm::max(maximum, p);
+        }
+        auto size = maximum - minimum;
+        auto extent = std::max(std::max(size.x, size.y), size.z);
+        if(extent <= 0.0f)
+            return 0.0f;
+        auto scale = (OVERDRAW_RESOLUTION - 1) / extent;
+
+        std::vector<float> depth(OVERDRAW_RESOLUTION * OVERDRAW_RESOLUTION);
+        size_t shaded = 0, covered = 0;
+        for(int axis = 0; axis < 3; axis++)
+            for(auto direction : {1.0f, -1.0f}){
+                auto u = (axis + 1) % 3, v = (axis + 2) % 3;
+                std::fill(depth.begin(), depth.end(), std::numeric_limits<float>::infinity());
+
+                for(size_t t = 0; t + 2 < indices.size(); t += 3){
+                    glm::vec3 screen[3];
+                    for(int i = 0; i < 3; i++){
+                        const auto& p = positions[indices[t + i]];
+                        screen[i] = {(p[u] - minimum[u]) * scale, (p[v] - minimum[v]) * scale, p[axis] * direction};
+                    }
+                    auto area = (screen[1].x - screen[0].x) * (screen[2].y - screen[0].y) -
+                                (screen[1].y - screen[0].y) * (screen[2].x - screen[0].x);
+                    if(std::abs(area) < 1e-8f)
+                        continue;
+
+                    auto minX = std::max(0, (int) std::floor(std::min({screen[0].x, screen[1].x, screen[2].x})));
+                    auto minY = std::max(0, (int) std::floor(std::min({screen[0].y, screen[1].y, screen[2].y})));
+                    auto maxX = std::min(OVERDRAW_RESOLUTION - 1,
+                                         (int) std::ceil(std::max({screen[0].x, screen[1].x, screen[2].x})));
+                    auto maxY = std::min(OVERDRAW_RESOLUTION - 1,
+                                         (int) std::ceil(std::max({screen[0].y, screen[1].y, screen[2].y})));
+                    for(auto y = minY; y <= maxY; y++)
+                        for(auto x = minX; x <= maxX; x++){
+                            auto px = (float) x + 0.5f, py = (float) y + 0.5f;
+                            // barycentric weights from the edge functions, for either winding.
+                            auto w0 = ((screen[1].x - px) * (screen[2].y - py) -
+                                       (screen[1].y - py) * (screen[2].x - px)) / area;
+                            auto w1 = ((screen[2].x - px) * (screen[0].y - py) -
+                                       (screen[2].y - py) * (screen[0].x - px)) / area;
+                            auto w2 = 1.0f - w0 - w1;
+                            if(w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+                                continue;
+                            auto z = w0 * screen[0].z + w1 * screen[1].z + w2 * screen[2].z;
+                            auto& stored = depth[y * OVERDRAW_RESOLUTION + x];
+                            if(z < stored){
+                                stored = z;
+                                shaded++;
+                            }
+                        }
+                }
+                for(auto d : depth)
+                    if(d != std::numeric_limits<float>::infinity())
+                        covered++;
+            }
+        return covered > 0 ? (float) shaded / (float) covered : 0.0f;
+    }
+}
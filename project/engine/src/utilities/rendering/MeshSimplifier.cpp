@@ -0,0 +1,245 @@
+#include "engine/utilities/rendering/MeshSimplifier.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <queue>
+#include <unordered_map>
+
+namespace EisEngine::rendering {
+    // symmetric 4x4 error quadric: xx, xy, xz, xw, yy, yz, yw, zz, zw, ww.
+    struct Quadric {
+        double a[10] = {};
+
+        static Quadric FromPlane(const glm::dvec3& n, double d){
+            return {{n.x * n.x, n.x * n.y, n.x * n.z, n.x * d,
+                     n.y * n.y, n.y * n.z, n.y * d,
+                     n.z * n.z, n.z * d,
+                     d * d}};
+        }
+
+        Quadric& operator+=(const Quadric& other){
+            for(int i = 0; i < 10; i++)
+                a[i] += other.a[i];
+            return *this;
+        }
+
+        // sum of squared distances of p to all planes accumulated in the quadric.
+        [[nodiscard]] double Evaluate(const glm::vec3& p) const {
+            double x = p.x, y = p.y, z = p.z;
+            auto result = a[0] * x * x + 2 * a[1] * x * y + 2 * a[2] * x * z + 2 * a[3] * x
+                        + a[4] * y * y + 2 * a[5] * y * z + 2 * a[6] * y
+                        + a[7] * z * z + 2 * a[8] * z
+                        + a[9];
+            return std::max(result, 0.0);
+        }
+    };
+
+    // a candidate collapse of vertex 'from' onto vertex 'to'.
+    struct Collapse {
+        double cost;
+        unsigned int from, to;
+        unsigned int fromVersion, toVersion;
+
+        bool operator>(const Collapse& other) const { return cost > other.cost;}
+    };
+
+    // maps each vertex to the first vertex sharing its exact position.
+    std::vector<unsigned int> BuildPositionRemap(const std::vector<glm::vec3>& positions){
+        struct KeyHash {
+            size_t operator()(const std::array<uint32_t, 3>& k) const
+            { return (k[0] * 73856093u) ^ (k[1] * 19349663u) ^ (k[2] * 83492791u);}
+        };
+        std::unordered_map<std::array<uint32_t, 3>, unsigned int, KeyHash> firstVertex;
+        firstVertex.reserve(positions.size());
+
+        std::vector<unsigned int> remap(positions.size());
+        for(unsigned int v = 0; v < positions.size(); v++){
+            std::array<uint32_t, 3> key;
+            std::memcpy(key.data(), &positions[v], sizeof(key));
+            remap[v] = firstVertex.emplace(key, v).first->second;
+        }
+        return remap;
+    }
+
+    std::vector<unsigned int> SimplifyMesh(const std::vector<glm::vec3>& positions,
+                                           const std::vector<unsigned int>& indices,
+                                           size_t targetIndexCount, float& error) {
+        error = 0.0f;
+        auto vertexCount = (unsigned int) positions.size();
+        auto triangleCount = indices.size() / 3;
+        if(indices.size() <= targetIndexCount)
+            return indices;
+
+        // attribute seams split a position into several vertices; those must stay in place.
+        auto remap = BuildPositionRemap(positions);
+        std::vector<int> wedges(vertexCount, 0);
+        for(unsigned int v = 0; v < vertexCount; v++)
+            wedges[remap[v]]++;
+
+        std::vector<bool> locked(vertexCount, false);
+        for(unsigned int v = 0; v < vertexCount; v++)
+            if(wedges[remap[v]] > 1)
+                locked[v] = true;
+
+        // border (or non-manifold) edges are used by a single (or more than two) triangles.
+        std::unordered_map<uint64_t, int> edgeUse;
+        edgeUse.reserve(indices.size());
+        auto edgeKey = [&](unsigned int a, unsigned int b){
+            auto pa = remap[a], pb = remap[b];
+            return ((uint64_t) std::min(pa, pb) << 32) | std::max(pa, pb);
+        };
+        for(size_t i = 0; i < indices.size(); i += 3)
+            for(int e = 0; e < 3; e++)
+                edgeUse[edgeKey(indices[i + e], indices[i + (e + 1) % 3])]++;
+        for(size_t i = 0; i < indices.size(); i += 3)
+            for(int e = 0; e < 3; e++){
+                auto a = indices[i + e], b = indices[i + (e + 1) % 3];
+                if(edgeUse[edgeKey(a, b)] != 2)
+                    locked[a] = locked[b] = true;
+            }
+
+        // per position quadrics of all adjacent triangle planes.
+        std::vector<Quadric> quadrics(vertexCount);
+        std::vector<std::vector<unsigned int>> vertexTriangles(vertexCount);
+        for(size_t t = 0; t < triangleCount; t++){
+            auto i0 = indices[3 * t], i1 = indices[3 * t + 1], i2 = indices[3 * t + 2];
+            glm::dvec3 p0 = positions[i0], p1 = positions[i1], p2 = positions[i2];
+            auto n = glm::cross(p1 - p0, p2 - p0);
+            auto length = glm::length(n);
+            if(length > 0.0){
+                n /= length;
+                auto plane = Quadric::FromPlane(n, -glm::dot(n, p0));
+                quadrics[remap[i0]] += plane;
+                quadrics[remap[i1]] += plane;
+                quadrics[remap[i2]] += plane;
+            }
+            vertexTriangles[i0].push_back((unsigned int) t);
+            vertexTriangles[i1].push_back((unsigned int) t);
+            vertexTriangles[i2].push_back((unsigned int) t);
+        }
+
+        std::vector<unsigned int> triangles = indices;
+        std::vector<bool> triangleAlive(triangleCount, true);
+        std::vector<bool> removed(vertexCount, false);
+        std::vector<unsigned int> version(vertexCount, 0);
+        std::priority_queue<Collapse, std::vector<Collapse>, std::greater<>> queue;
+
+        auto push = [&](unsigned int from, unsigned int to){
+            if(from == to || locked[from])
+                return;
+            auto q = quadrics[remap[from]];
+            q += quadrics[remap[to]];
+            queue.push({q.Evaluate(positions[to]), from, to, version[from], version[to]});
+        };
+        for(size_t i = 0; i < indices.size(); i += 3)
+            for(int e = 0; e < 3; e++){
+                push(indices[i + e], indices[i + (e + 1) % 3]);
+                push(indices[i + (e + 1) % 3], indices[i + e]);
+            }
+
+        // rejects collapses that remove no triangle (no longer an edge) or flip a remaining one.
+        auto canCollapse = [&](unsigned int from, unsigned int to){
+            auto sharesTriangle = false;
+            for(auto t : vertexTriangles[from]){
+                if(!triangleAlive[t])
+                    continue;
+                auto tri = &triangles[3 * t];
+                if(tri[0] == to || tri[1] == to || tri[2] == to){
+                    sharesTriangle = true;
+                    continue;
+                }
+
+                glm::vec3 p[3], q[3];
+                for(int k = 0; k < 3; k++){
+                    p[k] = positions[tri[k]];
+                    q[k] = positions[tri[k] == from ? to : tri[k]];
+                }
+                auto before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                auto after = glm::cross(q[1] - q[0], q[2] - q[0]);
+                if(glm::dot(before, after) <= 0.0f)
+                    return false;
+            }
+            return sharesTriangle;
+        };
+
+        auto indexCount = indices.size();
+        double maxCost = 0.0;
+        while(indexCount > targetIndexCount && !queue.empty()){
+            auto collapse = queue.top();
+            queue.pop();
+            auto from = collapse.from, to = collapse.to;
+            if(removed[from] || removed[to] || version[from] != collapse.fromVersion ||
+               version[to] != collapse.toVersion)
+                continue;
+            if(!canCollapse(from, to))
+                continue;
+
+            maxCost = std::max(maxCost, collapse.cost);
+            for(auto t : vertexTriangles[from]){
+                if(!triangleAlive[t])
+                    continue;
+                auto tri = &triangles[3 * t];
+                if(tri[0] == to || tri[1] == to || tri[2] == to){
+                    triangleAlive[t] = false;
+                    indexCount -= 3;
+                    continue;
+                }
+                for(int k = 0; k < 3; k++)
+                    if(tri[k] == from)
+                        tri[k] = to;
+                vertexTriangles[to].push_back(t);
+            }
+            quadrics[remap[to]] += quadrics[remap[from]];
+            vertexTriangles[from].clear();
+            removed[from] = true;
+            version[to]++;
+
+            // the collapse changed the cost of every edge around the target vertex.
+            for(auto t : vertexTriangles[to]){
+                if(!triangleAlive[t])
+                    continue;
+                for(int k = 0; k < 3; k++){
+                    auto other = triangles[3 * t + k];
+                    push(other, to);
+                    push(to, other);
+                }
+            }
+        }
+
+        std::vector<unsigned int> result;
+        result.reserve(indexCount);
+        for(size_t t = 0; t < triangleCount; t++)
+            if(triangleAlive[t])
+                result.insert(result.end(), triangles.begin() + 3 * t, triangles.begin() + 3 * t + 3);
+        error = (float) std::sqrt(maxCost);
+        return result;
+    }
+
+    std::vector<MeshLOD> GenerateLODChain(const std::vector<glm::vec3>& positions,
+                                          const std::vector<unsigned int>& indices,
+                                          int maxLevels, size_t minTriangles) {
+        std::vector<MeshLOD> chain;
+        const auto* current = &indices;
+        float error = 0.0f;
+        for(int level = 0; level < maxLevels; level++){
+            auto target = current->size() / 6 * 3;
+            if(target < minTriangles * 3)
+                break;
+
+            float levelError;
+            auto simplified = SimplifyMesh(positions, *current, target, levelError);
+            // stop once borders and seams prevent meaningful reduction.
+            if(simplified.size() * 10 > current->size() * 9)
+                break;
+
+            // each level is simplified from the previous one, so errors add up.
+            error += levelError;
+            chain.push_back({std::move(simplified), error});
+            current = &chain.back().indices;
+        }
+        return chain;
+    }
+}
@@ -0,0 +1,288 @@
+#include "engine/utilities/rendering/OcclusionCuller.h"
+#include "engine/utilities/ThreadPool.h"
+#include "engine/utilities/Simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// the edge length of the square screen tiles rasterized by a single task, a multiple of four.
+#define TILE_SIZE 32
+// the amount of occluder triangles clipped & set up per task.
+#define SETUP_CHUNK_SIZE 256
+// the smallest amount of boxes tested per task.
+#define CULL_CHUNK_SIZE 64
+// boxes with a corner this close to the camera plane (clip space w) are treated as visible.
+#define NEAR_EPSILON 1e-5f
+
+namespace EisEngine::rendering {
+    OcclusionCuller::OcclusionCuller(int width, int height) : width(width), height(height) { }
+
+    void OcclusionCuller::Resize(int newWidth, int newHeight) {
+        width = std::max(newWidth, 1);
+        height = std::max(newHeight, 1);
+    }
+
+    void OcclusionCuller::BeginFrame(const glm::mat4 &vp) {
+        viewProjection = vp;
+        tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+        tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+        // rows of the depth buffer are padded to a multiple of four pixels, so that every group stays in bounds.
+        levels.resize(1);
+        levels[0].width = width;
+        levels[0].height = height;
+        levels[0].stride = (width + 3) & ~3;
+        levels[0].depth.assign((size_t) levels[0].stride * height, 1.0f);
+        bins.resize((size_t) tilesX * tilesY);
+        for(auto& bin : bins)
+            bin.clear();
+
+        clipVertices.clear();
+        queued.clear();
+        triangles.clear();
+        stats = {};
+    }
+
+    void OcclusionCuller::AddOccluder(const std::vector<glm::vec3> &positions, const unsigned int *indices,
+                                      size_t indexCount, const glm::mat4 &model) {
+        auto mvp = viewProjection * model;
+        auto base = (uint32_t) clipVertices.size();
+        for(const auto& position : positions)
+            clipVertices.push_back(mvp * glm::vec4(position, 1.0f));
+        for(size_t i = 0; i + 2 < indexCount; i += 3)
+            for(size_t corner = 0; corner < 3; corner++)
+                queued.push_back(base + indices[i + corner]);
+    }
+
+    void OcclusionCuller::Setup(const glm::vec4 *clip, std::vector<SetupTriangle> &outTriangles) const {
+        // clip against the near plane (z >= -w); a triangle becomes a polygon of up to four corners.
+        glm::vec4 polygon[4];
+        int corners = 0;
+        for(int i = 0; i < 3; i++){
+            const auto& a = clip[i];
+            const auto& b = clip[(i + 1) % 3];
+            auto da = a.z + a.w, db = b.z + b.w;
+            if(da >= 0.0f)
+                polygon[corners++] = a;
+            if((da >= 0.0f) != (db >= 0.0f))
+                polygon[corners++] = a + (b - a) * (da / (da - db));
+        }
+
+        for(int fan = 1; fan + 1 < corners; fan++){
+            const glm::vec4* v[3] = {&polygon[0], &polygon[fan], &polygon[fan + 1]};
+            glm::vec2 p[3];
+            glm::vec3 z;
+            for(int i = 0; i < 3; i++){
+                auto invW = 1.0f / v[i]->w;
+                p[i] = {(v[i]->x * invW * 0.5f + 0.5f) * (float) width, (v[i]->y * invW * 0.5f + 0.5f) * (float) height};
+                z[i] = v[i]->z * invW * 0.5f + 0.5f;
+            }
+
+            // twice the signed area; dividing by it makes the edge functions of both windings positive inside.
+            auto area = (p[2].x - p[1].x) * (p[0].y - p[1].y) - (p[2].y - p[1].y) * (p[0].x - p[1].x);
+            if(std::abs(area) < 1e-8f)
+                continue;
+
+            SetupTriangle setup{};
+            setup.minX = std::max(0, (int) std::floor(std::min({p[0].x, p[1].x, p[2].x})));
+            setup.minY = std::max(0, (int) std::floor(std::min({p[0].y, p[1].y, p[2].y})));
+            setup.maxX = std::min(width - 1, (int) std::ceil(std::max({p[0].x, p[1].x, p[2].x})));
+            setup.maxY = std::min(height - 1, (int) std::ceil(std::max({p[0].y, p[1].y, p[2].y})));
+            if(setup.minX > setup.maxX || setup.minY > setup.maxY)
+                continue;
+
+            // the edge function of the edge opposite a corner is that corner's barycentric coordinate.
+            for(int i = 0; i < 3; i++){
+                const auto& a = p[(i + 1) % 3];
+                const auto& b = p[(i + 2) % 3];
+                setup.a[i] = -(b.y - a.y) / area;
+                setup.b[i] = (b.x - a.x) / area;
+                setup.c[i] = ((b.y - a.y) * a.x - (b.x - a.x) * a.y) / area;
+            }
+            // depth is affine in screen space, so it folds into a single plane equation.
+            setup.zA = glm::dot(setup.a, z);
+            setup.zB = glm::dot(setup.b, z);
+            setup.zC = glm::dot(setup.c, z);
+            outTriangles.push_back(setup);
+        }
+    }
+
+    void OcclusionCuller::Resolve(ThreadPool *pool) {
+        auto triangleCount = queued.size() / 3;
+        auto chunkCount = (triangleCount + SETUP_CHUNK_SIZE - 1) / SETUP_CHUNK_SIZE;
+        std::vector<std::vector<SetupTriangle>> chunkTriangles(chunkCount);
+        auto setupChunks = [&](size_t begin, size_t end){
+            for(auto c = begin; c < end; c++){
+                auto last = std::min(triangleCount, (c + 1) * SETUP_CHUNK_SIZE);
+                for(auto t = c * SETUP_CHUNK_SIZE; t < last; t++){
+                    const glm::vec4 clip[3] = {clipVertices[queued[3 * t]], clipVertices[queued[3 * t + 1]],
+                                               clipVertices[queued[3 * t + 2]]};
+                    Setup(clip, chunkTriangles[c]);
+                }
+            }
+        };
+        if(pool)
+            pool->ParallelFor(chunkCount, setupChunks);
+        else
+            setupChunks(0, chunkCount);
+        for(const auto& chunk : chunkTriangles)
+            triangles.insert(triangles.end(), chunk.begin(), chunk.end());
+        stats.occluderTriangles = triangles.size();
+
+        for(uint32_t t = 0; t < triangles.size(); t++){
+            const auto& triangle = triangles[t];
+            for(auto ty = triangle.minY / TILE_SIZE; ty <= triangle.maxY / TILE_SIZE; ty++)
+                for(auto tx = triangle.minX / TILE_SIZE; tx <= triangle.maxX / TILE_SIZE; tx++)
+                    bins[(size_t) ty * tilesX + tx].push_back(t);
+        }
+
+        // tiles cover disjoint pixels, so they can be rasterized without synchronization.
+        auto tileCount = (size_t) tilesX * tilesY;
+        auto rasterizeTiles = [&](size_t begin, size_t end){
+            for(auto tile = begin; tile < end; tile++)
+                RasterizeTile((int) tile);
+        };
+        if(pool)
+            pool->ParallelFor(tileCount, rasterizeTiles);
+        else
+            rasterizeTiles(0, tileCount);
+
+        BuildPyramid();
+    }
+
+    void OcclusionCuller::RasterizeTile(int tile) {
+        auto tileX = (tile % tilesX) * TILE_SIZE;
+        auto tileY = (tile / tilesX) * TILE_SIZE;
+        auto tileMaxX = std::min(tileX + TILE_SIZE, width) - 1;
+        auto tileMaxY = std::min(tileY + TILE_SIZE, height) - 1;
+        auto& buffer = levels[0];
+        const auto laneOffset = Float4::Ramp(0.5f);
+        const auto zero = Float4::Set(0.0f);
+
+        for(auto index : bins[tile]){
+            const auto& t = triangles[index];
+            // start at a multiple of four pixels; the padded rows keep the last group in bounds.
+            auto x0 = std::max(t.minX, tileX) & ~3;
+            auto x1 = std::min(t.maxX, tileMaxX);
+            auto y0 = std::max(t.minY, tileY);
+            auto y1 = std::min(t.maxY, tileMaxY);
+            const Float4 a[3] = {Float4::Set(t.a[0]), Float4::Set(t.a[1]), Float4::Set(t.a[2])};
+            const auto zA = Float4::Set(t.zA);
+            const auto lastX = Float4::Set((float) x1 + 1.0f);
+
+            for(auto y = y0; y <= y1; y++){
+                auto py = (float) y + 0.5f;
+                Float4 rowBase[3];
+                for(int i = 0; i < 3; i++)
+                    rowBase[i] = Float4::Set(t.b[i] * py + t.c[i]);
+                const auto zRow = Float4::Set(t.zB * py + t.zC);
+
+                auto* depthRow = &buffer.depth[(size_t) y * buffer.stride];
+                for(auto x = x0; x <= x1; x += 4){
+                    auto px = Float4::Set((float) x) + laneOffset;
+                    auto mask = (a[0] * px + rowBase[0]).GreaterEqual(zero) & (a[1] * px + rowBase[1]).GreaterEqual(zero) &
+                                (a[2] * px + rowBase[2]).GreaterEqual(zero) & px.Less(lastX);
+                    if(!mask)
+                        continue;
+
+                    auto fragDepth = zA * px + zRow;
+                    mask &= fragDepth.Less(Float4::Load(depthRow + x)) & fragDepth.GreaterEqual(zero);
+                    if(!mask)
+                        continue;
+
+                    float d[4];
+                    fragDepth.Store(d);
+                    for(int lane = 0; lane < 4; lane++)
+                        if(mask & (1 << lane))
+                            depthRow[x + lane] = d[lane];
+                }
+            }
+        }
+    }
+
+    void OcclusionCuller::BuildPyramid() {
+        while(levels.back().width > 1 || levels.back().height > 1){
+            const auto& source = levels.back();
+            Level level;
+            level.width = (source.width + 1) / 2;
+            level.height = (source.height + 1) / 2;
+            level.stride = level.width;
+            level.depth.resize((size_t) level.width * level.height);
+            // a texel covers texels 2x & 2x + 1 of the level below; odd edges repeat their last texel.
+            for(int y = 0; y < level.height; y++){
+                const auto* row0 = &source.depth[(size_t) (2 * y) * source.stride];
+                const auto* row1 = &source.depth[(size_t) std::min(2 * y + 1, source.height - 1) * source.stride];
+                for(int x = 0; x < level.width; x++){
+                    auto x1 = std::min(2 * x + 1, source.width - 1);
+                    level.depth[(size_t) y * level.stride + x] =
+                            std::max({row0[2 * x], row0[x1], row1[2 * x], row1[x1]});
+                }
+            }
+            levels.push_back(std::move(level));
+        }
+    }
+
+    float OcclusionCuller::GetDepth(int level, int x, int y) const {
+        const auto& l = levels[level];
+        return l.depth[(size_t) y * l.stride + x];
+    }
+
+    bool OcclusionCuller::IsVisible(const AABB &box) const {
+        if(levels.empty())
+            return true;
+
+        // the screen rectangle & the nearest depth of the box' corners.
+        glm::vec2 lo(std::numeric_limits<float>::max()), hi(std::numeric_limits<float>::lowest());
+        auto nearest = std::numeric_limits<float>::max();
+        for(int corner = 0; corner < 8; corner++){
+            glm::vec3 point((corner & 1) ? box.max.x : box.min.x, (corner & 2) ? box.max.y : box.min.y,
+                            (corner & 4) ? box.max.z : box.min.z);
+            auto clip = viewProjection * glm::vec4(point, 1.0f);
+            // corners behind the camera do not project; such boxes may surround the camera.
+            if(clip.w <= NEAR_EPSILON)
+                return true;
+            auto ndc = glm::vec3(clip) / clip.w;
+            lo = glm::min(lo, glm::vec2(ndc.x, ndc.y));
+            hi = glm::max(hi, glm::vec2(ndc.x, ndc.y));
+            nearest = std::min(nearest, ndc.z * 0.5f + 0.5f);
+        }
+        if(nearest <= 0.0f)
+            return true;
+
+        auto toPixel = [](float ndc, int size){
+            return std::clamp((int) std::floor((ndc * 0.5f + 0.5f) * (float) size), 0, size - 1);
+        };
+        auto x0 = toPixel(lo.x, width), x1 = toPixel(hi.x, width);
+        auto y0 = toPixel(lo.y, height), y1 = toPixel(hi.y, height);
+
+        // the finest level on which the rectangle covers at most 2x2 texels.
+        int level = 0;
+        while(level + 1 < (int) levels.size() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1))
+            level++;
+
+        auto farthest = 0.0f;
+        for(auto y = y0 >> level; y <= y1 >> level; y++)
+            for(auto x = x0 >> level; x <= x1 >> level; x++)
+                farthest = std::max(farthest, GetDepth(level, x, y));
+        return nearest <= farthest;
+    }
+
+    size_t OcclusionCuller::CullAABBs(const AABB *boxes, size_t count, unsigned char *visibility, ThreadPool *pool) {
+        auto testBoxes = [&](size_t begin, size_t end){
+            for(auto i = begin; i < end; i++)
+                visibility[i] = IsVisible(boxes[i]) ? 1 : 0;
+        };
+        if(pool)
+            pool->ParallelFor(count, testBoxes, CULL_CHUNK_SIZE);
+        else
+            testBoxes(0, count);
+
+        size_t visible = 0;
+        for(size_t i = 0; i < count; i++)
+            visible += visibility[i];
+        stats.tested += count;
+        stats.occluded += count - visible;
+        return visible;
+    }
+}
@@ -1,4 +1,5 @@
 #include "engine/utilities/rendering/PrimitiveMesh3D.h"
+#include "engine/utilities/rendering/MeshOptimizer.h"
 #include "engine/utilities/Vector2.h"
 #include "engine/utilities/Math.h"
 #include "engine/utilities/Debug.h"
@@ -139,6 +140,13 @@ namespace EisEngine::rendering {
         bitangents = bitans;
     }
 
+    void PrimitiveMesh3D::GenerateLODs(const int& maxLevels) {
+        lods = GenerateLODChain(vertices, indices, maxLevels);
+        // simplification scrambles the triangle order, so restore the vertex cache locality of each level.
+        for(auto& lod : lods)
+            lod.indices = OptimizeVertexCache(lod.indices, vertices.size());
+    }
+
     std::vector<Vector3> PrimitiveMesh3D::GetVertices() const {
         std::vector<Vector3> result = {};
         result.reserve(vertices.size());
@@ -0,0 +1,113 @@
+#include "engine/utilities/rendering/ProgramBinaryCache.h"
+#include "engine/utilities/Debug.h"
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+// identifies the cache files of the engine ("EISB").
+#define CACHE_MAGIC 0x42534945u
+// the basis & the multiplier of the 64 bit FNV-1a hash.
+#define FNV_OFFSET 14695981039346656037ull
+#define FNV_PRIME 1099511628211ull
+
+namespace EisEngine::rendering {
+    // precedes the program binary in a cache file.
+    struct BinaryHeader {
+        uint32_t magic;
+        uint32_t format;
+        uint32_t length;
+    };
+
+    uint64_t HashText(const std::string& text, uint64_t hash){
+        for(auto c : text){
+            hash ^= (unsigned char) c;
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    ProgramBinaryCache::ProgramBinaryCache(fs::path directory) : directory(std::move(directory)) { }
+
+    uint64_t ProgramBinaryCache::MakeKey(const std::string &vertexSource, const std::string &fragmentSource) const {
+        // binaries are only valid for the driver which created them.
+        if(driver.empty())
+            for(auto name : {GL_VENDOR, GL_RENDERER, GL_VERSION}){
+                auto value = glGetString(name);
+                driver += std::string(value ? (const char*) value : "") + '\n';
+            }
+        auto hash = HashText(driver, FNV_OFFSET);
+        hash = HashText(vertexSource, hash);
+        // separates the stages, so that moving text from one to the other changes the key.
+        hash = HashText(std::string(1, '\0'), hash);
+        return HashText(fragmentSource, hash);
+    }
+
+    bool ProgramBinaryCache::IsEnabled() const {
+        if(directory.empty())
+            return false;
+        if(supported < 0){
+            GLint formats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+            supported = formats > 0;
+        }
+        return supported > 0;
+    }
+
+    bool ProgramBinaryCache::Load(GLuint program, uint64_t key) const {
+        if(!IsEnabled())
+            return false;
+        std::ifstream file(GetPath(key), std::ios::binary);
+        if(!file)
+            return false;
+
+        BinaryHeader header{};
+        if(!file.read((char*) &header, sizeof(header)) || header.magic != CACHE_MAGIC || header.length == 0)
+            return false;
+        std::vector<char> binary(header.length);
+        if(!file.read(binary.data(), (std::streamsize) binary.size()))
+            return false;
+
+        glProgramBinary(program, header.format, binary.data(), (GLsizei) binary.size());
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        return linked == GL_TRUE;
+    }
+
+    void ProgramBinaryCache::Store(GLuint program, uint64_t key) const {
+        if(!IsEnabled())
+            return;
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if(length <= 0)
+            return;
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        glGetProgramBinary(program, length, &length, &format, binary.data());
+
+        std::error_code error;
+        fs::create_directories(directory, error);
+        auto path = GetPath(key);
+        // written to a temporary file first, so that an interrupted write never leaves a truncated binary.
+        auto temporary = fs::path(path).concat(".tmp");
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            BinaryHeader header{CACHE_MAGIC, (uint32_t) format, (uint32_t) length};
+            file.write((const char*) &header, sizeof(header));
+            file.write(binary.data(), length);
+            if(!file){
+                DEBUG_WARN("Could not write the shader cache file " + temporary.string())
+                return;
+            }
+        }
+        fs::rename(temporary, path, error);
+        if(error)
+            DEBUG_WARN("Could not write the shader cache file " + path.string() + ": " + error.message())
+    }
+
+    fs::path ProgramBinaryCache::GetPath(uint64_t key) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long) key);
+        return directory / name;
+    }
+}
@@ -0,0 +1,143 @@
+#include "engine/utilities/rendering/QualityGovernor.h"
+#include <gui/imgui.h>
+
+#include <algorithm>
+#include <array>
+#include <string>
+
+// the weight of a new frame time in the exponential moving average.
+#define SMOOTHING_FACTOR 0.1
+// fraction above the budget the frame time must exceed before degrading.
+#define DEGRADE_MARGIN 0.05
+// fraction of the budget the frame time must stay below before recovering.
+#define RECOVER_HEADROOM 0.75
+// the amount of consecutive frames over budget before degrading.
+#define DEGRADE_FRAMES 15
+// the amount of consecutive frames well below budget before recovering; longer, so that recovery is cautious.
+#define RECOVER_FRAMES 120
+// the amount of frames after a change during which the smoothed times settle & no further change happens.
+#define COOLDOWN_FRAMES 30
+// the amount of decisions kept for display.
+#define MAX_DECISIONS 8
+
+namespace EisEngine::rendering {
+    // the degradation of the base settings at one quality level.
+    struct QualityStep {
+        // upper bound of the render scale.
+        float renderScale;
+        bool simpleShading;
+        // upper bound of the lights per cluster, 0 if unlimited.
+        uint32_t maxLightsPerCluster;
+        // factors applied to the LOD error threshold & the thickness pass scale.
+        float lodFactor;
+        float thicknessFactor;
+    };
+
+    // the quality levels, each degrading one knob further; the knobs costing the least image quality come first.
+    const std::array<QualityStep, 9> QUALITY_LADDER = {{
+        {1.0f, false, 0, 1.0f, 1.0f},
+        {1.0f, false, 0, 1.0f, 0.5f},
+        {1.0f, false, 0, 2.0f, 0.5f},
+        {1.0f, false, 32, 2.0f, 0.5f},
+        {1.0f, true, 32, 2.0f, 0.5f},
+        {0.85f, true, 32, 2.0f, 0.5f},
+        {0.85f, true, 16, 4.0f, 0.25f},
+        {0.7f, true, 16, 4.0f, 0.25f},
+        {0.5f, true, 8, 4.0f, 0.25f}
+    }};
+
+    QualityGovernor::QualityGovernor(double budget) : budget(budget) { }
+
+    int QualityGovernor::GetLevelCount() { return (int) QUALITY_LADDER.size();}
+
+    void QualityGovernor::SetEnabled(bool value) {
+        enabled = value;
+        level = 0;
+        framesOver = framesUnder = cooldown = 0;
+    }
+
+    void QualityGovernor::SetBudget(double milliseconds) {
+        budget = std::max(milliseconds, 1.0);
+        framesOver = framesUnder = 0;
+    }
+
+    bool QualityGovernor::Update(double cpu, double gpu) {
+        frame++;
+        cpuTime = cpuTime < 0.0 ? cpu : cpuTime + (cpu - cpuTime) * SMOOTHING_FACTOR;
+        if(gpu >= 0.0)
+            gpuTime = gpuTime < 0.0 ? gpu : gpuTime + (gpu - gpuTime) * SMOOTHING_FACTOR;
+        if(!enabled)
+            return false;
+        if(cooldown > 0){
+            cooldown--;
+            return false;
+        }
+
+        // the slower processor limits the frame rate.
+        auto frameTime = std::max(cpuTime, gpuTime);
+        framesOver = frameTime > budget * (1.0 + DEGRADE_MARGIN) ? framesOver + 1 : 0;
+        framesUnder = frameTime < budget * RECOVER_HEADROOM ? framesUnder + 1 : 0;
+
+        if(framesOver >= DEGRADE_FRAMES && level + 1 < GetLevelCount()){
+            ChangeLevel(level + 1);
+            return true;
+        }
+        if(framesUnder >= RECOVER_FRAMES && level > 0){
+            ChangeLevel(level - 1);
+            return true;
+        }
+        return false;
+    }
+
+    void QualityGovernor::ChangeLevel(int newLevel) {
+        decisions.push_back({frame, level, newLevel, cpuTime, gpuTime});
+        if(decisions.size() > MAX_DECISIONS)
+            decisions.pop_front();
+        level = newLevel;
+        framesOver = framesUnder = 0;
+        cooldown = COOLDOWN_FRAMES;
+    }
+
+    QualitySettings QualityGovernor::GetSettings(const QualitySettings &base) const {
+        if(!enabled)
+            return base;
+        const auto& step = QUALITY_LADDER[level];
+        auto settings = base;
+        settings.renderScale = std::min(base.renderScale, step.renderScale);
+        settings.simpleShading = base.simpleShading || step.simpleShading;
+        if(step.maxLightsPerCluster > 0)
+            settings.maxLightsPerCluster = base.maxLightsPerCluster > 0
+                    ? std::min(base.maxLightsPerCluster, step.maxLightsPerCluster) : step.maxLightsPerCluster;
+        // a threshold of 0 (always full detail) is scaled up from a single pixel.
+        settings.lodErrorThreshold = step.lodFactor > 1.0f ?
+                std::max(base.lodErrorThreshold, 1.0f) * step.lodFactor : base.lodErrorThreshold;
+        settings.thicknessScale = std::max(base.thicknessScale * step.thicknessFactor, 0.05f);
+        return settings;
+    }
+
+    void QualityGovernor::DrawImGui(const QualitySettings &base) {
+        ImGui::SeparatorText("Quality Governor");
+        auto active = enabled;
+        if(ImGui::Checkbox("Adapt Quality", &active))
+            SetEnabled(active);
+        auto budgetValue = (float) budget;
+        if(ImGui::SliderFloat("Frame Budget (ms)", &budgetValue, 4.0f, 50.0f, "%.1f"))
+            SetBudget(budgetValue);
+        ImGui::Text("CPU %.2f ms | GPU %.2f ms", std::max(cpuTime, 0.0), std::max(gpuTime, 0.0));
+        ImGui::Text("Level %d / %d%s", level, GetLevelCount() - 1, cooldown > 0 ? " (settling)" : "");
+
+        auto settings = GetSettings(base);
+        ImGui::Text("Render scale %.2f, thickness scale %.2f", settings.renderScale, settings.thicknessScale);
+        ImGui::Text("LOD error %.1f px, lights per cluster %s, %s shading", settings.lodErrorThreshold,
+                    settings.maxLightsPerCluster > 0 ? std::to_string(settings.maxLightsPerCluster).c_str() : "all",
+                    settings.simpleShading ? "simple" : "full");
+
+        if(decisions.empty())
+            return;
+        ImGui::Text("Decisions:");
+        for(auto it = decisions.rbegin(); it != decisions.rend(); ++it)
+            ImGui::BulletText("frame %llu: %s to level %d (CPU %.2f ms, GPU %.2f ms)",
+                              (unsigned long long) it->frame, it->toLevel > it->fromLevel ? "degraded" : "recovered",
+                              it->toLevel, it->cpuTime, std::max(it->gpuTime, 0.0));
+    }
+}
@@ -0,0 +1,44 @@
+#include "engine/utilities/rendering/RenderBackend.h"
+
+namespace EisEngine::rendering {
+    void RecordingRenderBackend::UploadInstances(const std::vector<InstanceData> &instances) {
+        counts.instanceUploads++;
+        counts.instanceBytes += instances.size() * sizeof(InstanceData);
+    }
+
+    void RecordingRenderBackend::Submit(const RenderCommandList &list, Shader *activeShader) {
+        counts.submissions++;
+        counts.commands += list.Size();
+        for(const auto& command : list.GetCommands()){
+            switch(command.type){
+                case RenderCommandType::SetMaterial:
+                    counts.materialChanges++;
+                    break;
+                case RenderCommandType::SetTransform:
+                    counts.transformChanges++;
+                    break;
+                case RenderCommandType::SetLights:
+                    counts.lightChanges++;
+                    break;
+                case RenderCommandType::DrawMesh: {
+                    const auto& draw = list.GetDraw(command.payload);
+                    counts.drawCalls++;
+                    counts.objects += draw.instanceCount == 0 ? 1 : draw.instanceCount;
+                    break;
+                }
+                case RenderCommandType::DrawMeshes:
+                    counts.drawCalls++;
+                    counts.objects += list.GetMultiDraw(command.payload).drawCount;
+                    break;
+            }
+        }
+
+        if(capture)
+            captured.push_back(list);
+    }
+
+    void RecordingRenderBackend::Reset() {
+        counts = {};
+        captured.clear();
+    }
+}
@@ -0,0 +1,43 @@
+#include "engine/utilities/rendering/RenderCommandList.h"
+
+namespace EisEngine::rendering {
+    void RenderCommandList::Clear() {
+        commands.clear();
+        materials.clear();
+        transforms.clear();
+        lights.clear();
+        draws.clear();
+        multiDraws.clear();
+        multiDrawMeshes.clear();
+    }
+
+    void RenderCommandList::SetMaterial(Renderer *renderer) {
+        if(!materials.empty() && materials.back() == renderer)
+            return;
+        commands.push_back({RenderCommandType::SetMaterial, (uint32_t) materials.size()});
+        materials.push_back(renderer);
+    }
+
+    void RenderCommandList::SetTransform(const TransformBlock &block) {
+        commands.push_back({RenderCommandType::SetTransform, (uint32_t) transforms.size()});
+        transforms.push_back(block);
+    }
+
+    void RenderCommandList::SetLights(const LightBlock &block) {
+        if(!lights.empty() && lights.back().count == block.count && lights.back().lights == block.lights)
+            return;
+        commands.push_back({RenderCommandType::SetLights, (uint32_t) lights.size()});
+        lights.push_back(block);
+    }
+
+    void RenderCommandList::DrawMesh(Mesh3D *mesh, int instanceCount, int firstInstance) {
+        commands.push_back({RenderCommandType::DrawMesh, (uint32_t) draws.size()});
+        draws.push_back({mesh, instanceCount, firstInstance});
+    }
+
+    void RenderCommandList::DrawMeshes(Mesh3D *const *meshes, int drawCount, int firstDraw) {
+        commands.push_back({RenderCommandType::DrawMeshes, (uint32_t) multiDraws.size()});
+        multiDraws.push_back({(uint32_t) multiDrawMeshes.size(), drawCount, firstDraw});
+        multiDrawMeshes.insert(multiDrawMeshes.end(), meshes, meshes + drawCount);
+    }
+}
@@ -0,0 +1,291 @@
+#include "engine/utilities/rendering/RenderGraph.h"
+#include "engine/utilities/rendering/GLStateCache.h"
+#include "engine/utilities/Debug.h"
+#include "engine/Context.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <unordered_set>
+
+// the amount of frames a pooled texture is kept without being used.
+#define TRANSIENT_TEXTURE_LIFETIME 8
+
+namespace EisEngine::rendering {
+    // the attachment point of textures of the given format.
+    GLenum AttachmentPoint(GLenum format, GLenum colorAttachment){
+        switch(format){
+            case GL_DEPTH_COMPONENT16:
+            case GL_DEPTH_COMPONENT24:
+            case GL_DEPTH_COMPONENT32F:
+                return GL_DEPTH_ATTACHMENT;
+            case GL_DEPTH24_STENCIL8:
+            case GL_DEPTH32F_STENCIL8:
+                return GL_DEPTH_STENCIL_ATTACHMENT;
+            default:
+                return colorAttachment;
+        }
+    }
+
+    // the (approximate) memory of a texel of the given format.
+    size_t BytesPerTexel(GLenum format){
+        switch(format){
+            case GL_R8:
+                return 1;
+            case GL_R16F:
+            case GL_DEPTH_COMPONENT16:
+                return 2;
+            case GL_RGBA16F:
+            case GL_DEPTH32F_STENCIL8:
+                return 8;
+            case GL_RGBA32F:
+                return 16;
+            default:
+                return 4;
+        }
+    }
+
+    size_t TextureBytes(const RenderTargetDesc& desc){
+        return (size_t) desc.width * desc.height * BytesPerTexel(desc.format);
+    }
+
+    RenderResource RenderPassBuilder::Create(const std::string &name, const RenderTargetDesc &desc) {
+        auto resource = (RenderResource) graph.resources.size();
+        RenderGraph::Resource created;
+        created.name = name;
+        created.desc = desc;
+        graph.resources.push_back(created);
+        graph.passes[pass].writes.push_back(resource);
+        return resource;
+    }
+
+    RenderResource RenderPassBuilder::Write(RenderResource resource) {
+        graph.passes[pass].writes.push_back(resource);
+        graph.passes[pass].loads.push_back(resource);
+        return resource;
+    }
+
+    RenderResource RenderPassBuilder::Read(RenderResource resource) {
+        graph.passes[pass].reads.push_back(resource);
+        return resource;
+    }
+
+    void RenderGraph::AddPass(const std::string &name, const std::function<void(RenderPassBuilder &)> &setup,
+                              ExecuteFunction execute) {
+        Pass pass;
+        pass.name = name;
+        pass.execute = std::move(execute);
+        passes.push_back(std::move(pass));
+        RenderPassBuilder builder(*this, passes.size() - 1);
+        setup(builder);
+    }
+
+    RenderResource RenderGraph::ImportFramebuffer(const std::string &name, GLuint framebuffer) {
+        Resource imported;
+        imported.name = name;
+        imported.imported = true;
+        imported.framebuffer = framebuffer;
+        resources.push_back(imported);
+        return (RenderResource) resources.size() - 1;
+    }
+
+    void RenderGraph::Cull() {
+        // walking backwards, a pass is needed if it writes an imported framebuffer or a resource a needed pass reads.
+        std::vector<bool> needed(resources.size(), false);
+        for(auto it = passes.rbegin(); it != passes.rend(); ++it){
+            auto& pass = *it;
+            pass.culled = std::none_of(pass.writes.begin(), pass.writes.end(), [&](RenderResource resource){
+                return resources[resource].imported || needed[resource];
+            });
+            if(pass.culled)
+                continue;
+            // overwritten resources do not depend on earlier passes, loaded ones do.
+            for(auto resource : pass.writes)
+                needed[resource] = false;
+            for(auto resource : pass.loads)
+                needed[resource] = true;
+            for(auto resource : pass.reads)
+                needed[resource] = true;
+        }
+    }
+
+    void RenderGraph::Acquire(Resource &resource) {
+        auto it = std::find_if(pool.begin(), pool.end(), [&](const PooledTexture& pooled){
+            return !pooled.inUse && pooled.desc == resource.desc;
+        });
+        if(it == pool.end()){
+            PooledTexture created;
+            created.desc = resource.desc;
+            if(ctx::Context::HasGraphics()){
+                glGenTextures(1, &created.texture);
+                GLStateCache::BindTexture(GL_TEXTURE_2D, created.texture);
+                glTexStorage2D(GL_TEXTURE_2D, 1, resource.desc.format, resource.desc.width, resource.desc.height);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                GLStateCache::BindTexture(GL_TEXTURE_2D, 0);
+                DEBUG_OPENGL(resource.name)
+            }
+            pool.push_back(created);
+            it = pool.end() - 1;
+        }
+        it->inUse = true;
+        it->lastUse = frame;
+        resource.texture = it->texture;
+        resource.pooled = (size_t) (it - pool.begin());
+    }
+
+    GLuint RenderGraph::GetPassFramebuffer(const std::vector<RenderResource> &attachments) {
+        std::vector<GLuint> textures = {};
+        for(auto resource : attachments)
+            textures.push_back(resources[resource].texture);
+        auto it = framebuffers.find(textures);
+        if(it != framebuffers.end())
+            return it->second;
+
+        GLuint framebuffer = 0;
+        if(ctx::Context::HasGraphics()){
+            glGenFramebuffers(1, &framebuffer);
+            GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+            std::vector<GLenum> drawBuffers = {};
+            for(auto resource : attachments){
+                auto colorAttachment = GL_COLOR_ATTACHMENT0 + (GLenum) drawBuffers.size();
+                auto attachment = AttachmentPoint(resources[resource].desc.format, colorAttachment);
+                glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, resources[resource].texture, 0);
+                if(attachment == colorAttachment)
+                    drawBuffers.push_back(colorAttachment);
+            }
+            if(drawBuffers.empty())
+                glDrawBuffer(GL_NONE);
+            else
+                glDrawBuffers((GLsizei) drawBuffers.size(), drawBuffers.data());
+            // checked in all builds: a wrong format or size mismatch of aliased textures shows here.
+            if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+                DEBUG_ERROR("Render graph framebuffer with [" + resources[attachments.front()].name +
+                            "] attached is incomplete.")
+            DEBUG_OPENGL("Render Graph Framebuffer")
+        }
+        framebuffers.emplace(textures, framebuffer);
+        return framebuffer;
+    }
+
+    void RenderGraph::Execute() {
+        Cull();
+        frame++;
+        stats = {};
+        stats.passes = passes.size();
+
+        // the lifetime of a transient resource spans the executed passes using it.
+        for(size_t i = 0; i < passes.size(); i++){
+            const auto& pass = passes[i];
+            if(pass.culled){
+                stats.culledPasses++;
+                continue;
+            }
+            for(const auto* accesses : {&pass.reads, &pass.writes}){
+                for(auto resource : *accesses){
+                    auto& used = resources[resource];
+                    used.firstUse = std::min(used.firstUse, i);
+                    used.lastUse = std::max(used.lastUse, i);
+                }
+            }
+        }
+        for(const auto& resource : resources){
+            if(resource.imported || resource.firstUse == SIZE_MAX)
+                continue;
+            stats.transientResources++;
+            stats.unaliasedBytes += TextureBytes(resource.desc);
+        }
+
+        auto hasGraphics = ctx::Context::HasGraphics();
+        std::array<GLint, 4> viewport = {};
+        if(hasGraphics)
+            viewport = GLStateCache::GetViewport();
+        std::unordered_set<size_t> texturesUsed = {};
+        for(size_t i = 0; i < passes.size(); i++){
+            auto& pass = passes[i];
+            if(pass.culled)
+                continue;
+            for(const auto* accesses : {&pass.reads, &pass.writes}){
+                for(auto resource : *accesses){
+                    auto& used = resources[resource];
+                    if(used.imported || used.firstUse != i)
+                        continue;
+                    Acquire(used);
+                    texturesUsed.insert(used.pooled);
+                }
+            }
+
+            // a pass draws into an imported framebuffer or into its transient textures.
+            auto imported = std::find_if(pass.writes.begin(), pass.writes.end(), [&](RenderResource resource){
+                return resources[resource].imported;
+            });
+            if(hasGraphics && imported != pass.writes.end()){
+                assert(pass.writes.size() == 1);
+                GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, resources[*imported].framebuffer);
+                GLStateCache::Viewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+            }
+            else if(hasGraphics && !pass.writes.empty()){
+                GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, GetPassFramebuffer(pass.writes));
+                const auto& desc = resources[pass.writes.front()].desc;
+                GLStateCache::Viewport(0, 0, desc.width, desc.height);
+            }
+            pass.execute(*this);
+            if(hasGraphics)
+                DEBUG_OPENGL(pass.name)
+
+            // resources past their last use hand their textures to the following passes.
+            for(const auto* accesses : {&pass.reads, &pass.writes}){
+                for(auto resource : *accesses){
+                    const auto& used = resources[resource];
+                    if(!used.imported && used.lastUse == i)
+                        pool[used.pooled].inUse = false;
+                }
+            }
+        }
+        if(hasGraphics)
+            GLStateCache::Viewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        stats.texturesUsed = texturesUsed.size();
+
+        passes.clear();
+        resources.clear();
+        Purge(TRANSIENT_TEXTURE_LIFETIME);
+        stats.pooledTextures = pool.size();
+        for(const auto& pooled : pool)
+            stats.pooledBytes += TextureBytes(pooled.desc);
+    }
+
+    void RenderGraph::Purge(uint64_t maxUnusedFrames) {
+        std::vector<GLuint> expired = {};
+        pool.erase(std::remove_if(pool.begin(), pool.end(), [&](const PooledTexture& pooled){
+            if(pooled.inUse || frame - pooled.lastUse < maxUnusedFrames)
+                return false;
+            expired.push_back(pooled.texture);
+            return true;
+        }), pool.end());
+        if(expired.empty() || !ctx::Context::HasGraphics())
+            return;
+
+        // deleting a bound framebuffer unbinds it behind the state cache's back.
+        GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
+        for(auto it = framebuffers.begin(); it != framebuffers.end();){
+            auto attached = std::any_of(it->first.begin(), it->first.end(), [&](GLuint texture){
+                return std::find(expired.begin(), expired.end(), texture) != expired.end();
+            });
+            if(!attached){
+                ++it;
+                continue;
+            }
+            glDeleteFramebuffers(1, &it->second);
+            it = framebuffers.erase(it);
+        }
+        for(auto texture : expired)
+            GLStateCache::OnTextureDeleted(texture);
+        glDeleteTextures((GLsizei) expired.size(), expired.data());
+    }
+
+    void RenderGraph::Release() {
+        Purge(0);
+    }
+}
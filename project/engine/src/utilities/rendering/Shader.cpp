@@ -3,6 +3,7 @@
 #include "engine/ResourceManager.h"
 #include "engine/utilities/Color.h"
 #include "engine/systems/Camera.h"
+#include "engine/utilities/rendering/GLStateCache.h"
 
 namespace EisEngine::rendering {
     Shader::Shader(
@@ -37,6 +38,9 @@ namespace EisEngine::rendering {
         glDetachShader(shaderProgram, fragmentShader);
     }
 
+    Shader::Shader(const unsigned int &program, const std::string &name) :
+    name(name), shaderProgram(program) { }
+
     Shader::Shader(EisEngine::rendering::Shader &&other) noexcept {
         std::swap(this->shaderProgram, other.shaderProgram);
         std::swap(this->vertexShader, other.vertexShader);
@@ -49,7 +53,7 @@ namespace EisEngine::rendering {
     }
 
     void Shader::Apply(Camera* camera) {
-        glUseProgram(shaderProgram);
+        GLStateCache::UseProgram(shaderProgram);
         DEBUG_OPENGL("Shader " + name)
         vpMatrix = camera->GetVPMatrix();
         auto mvpLoc = glGetUniformLocation(shaderProgram, "mvp");
@@ -66,17 +70,20 @@ namespace EisEngine::rendering {
         setInt("cubeMap", UniformSamplerIndices::CUBEMAP);
         setInt("backDepthMap", UniformSamplerIndices::DEPTH_BACK_FACE);
         setInt("frontDepthMap", UniformSamplerIndices::DEPTH_FRONT_FACE);
+        setInt("accumMap", UniformSamplerIndices::OIT_ACCUMULATION);
+        setInt("revealMap", UniformSamplerIndices::OIT_REVEALAGE);
         DEBUG_OPENGL("Shader " + name)
     }
 
+    void Shader::Use() const { GLStateCache::UseProgram(shaderProgram);}
+
     void Shader::ApplyTexture2D(const Texture2D& texture, UniformSamplerIndices type) const {
-        glActiveTexture(GL_TEXTURE0 + type);
-        texture.Bind();
+        // skipped if the texture is still bound, e.g. when consecutive meshes share a material.
+        GLStateCache::BindTexture(type, GL_TEXTURE_2D, texture.textureID);
     }
 
     void Shader::ApplyCubemap(const Cubemap& cubemap) const {
-        glActiveTexture(GL_TEXTURE0 + UniformSamplerIndices::CUBEMAP);
-        cubemap.Bind();
+        GLStateCache::BindTexture(UniformSamplerIndices::CUBEMAP, GL_TEXTURE_CUBE_MAP, cubemap.textureID);
         DEBUG_OPENGL("Shader " + name)
     }
 
@@ -100,6 +107,11 @@ namespace EisEngine::rendering {
         if(uniformLocation != -1)
             glUniform3fv(uniformLocation, 1, glm::value_ptr(vec3));
     }
+    void Shader::setVector(const std::string &uniformName, glm::vec2 vec2) const {
+        auto uniformLocation = glGetUniformLocation(shaderProgram, uniformName.c_str());
+        if(uniformLocation != -1)
+            glUniform2fv(uniformLocation, 1, glm::value_ptr(vec2));
+    }
 
     void Shader::setInt(const std::string &uniformName, const int &val) const {
         auto uniformLocation = glGetUniformLocation(shaderProgram, uniformName.c_str());
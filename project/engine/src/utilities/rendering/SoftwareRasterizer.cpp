@@ -0,0 +1,309 @@
+#include "engine/utilities/rendering/SoftwareRasterizer.h"
+#include "engine/utilities/ThreadPool.h"
+#include "engine/utilities/Simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+// the edge length of the square screen tiles rasterized by a single task, a multiple of four.
+#define TILE_SIZE 32
+// the amount of queued triangles clipped & set up per task.
+#define SETUP_CHUNK_SIZE 1024
+
+namespace EisEngine::rendering {
+    // packs a color into an RGBA8 pixel, red in the lowest byte.
+    uint32_t PackColor(const glm::vec4& c){
+        auto channel = [](float x){ return (uint32_t) std::lround(std::clamp(x, 0.0f, 1.0f) * 255.0f);};
+        return channel(c.x) | channel(c.y) << 8 | channel(c.z) << 16 | channel(c.w) << 24;
+    }
+
+    SoftwareRasterizer::SoftwareRasterizer(int width, int height) : width(width), height(height) { }
+
+    void SoftwareRasterizer::Resize(int newWidth, int newHeight) {
+        width = newWidth;
+        height = newHeight;
+    }
+
+    void SoftwareRasterizer::BeginFrame(const SoftwareShadingParameters &parameters, const glm::vec4 &clearColor) {
+        shading = parameters;
+        stride = (width + 3) & ~3;
+        tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+        tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+        color.assign((size_t) stride * height, PackColor(clearColor));
+        depth.assign((size_t) stride * height, 1.0f);
+        bins.resize((size_t) tilesX * tilesY);
+        for(auto& bin : bins)
+            bin.clear();
+
+        materials.clear();
+        lights.clear();
+        lightSets.clear();
+        vertices.clear();
+        queued.clear();
+        triangles.clear();
+        varyings.clear();
+    }
+
+    uint32_t SoftwareRasterizer::AddMaterial(SoftwareMaterial material) {
+        materials.push_back(std::move(material));
+        return (uint32_t) materials.size() - 1;
+    }
+
+    uint32_t SoftwareRasterizer::AddLightSet(const SoftwareLight *setLights, int count) {
+        lightSets.push_back({(uint32_t) lights.size(), count});
+        if(count > 0)
+            lights.insert(lights.end(), setLights, setLights + count);
+        return (uint32_t) lightSets.size() - 1;
+    }
+
+    void SoftwareRasterizer::DrawTriangles(const std::vector<SoftwareVertex> &meshVertices, const unsigned int *indices,
+                                           size_t indexCount, uint32_t material, uint32_t lightSet) {
+        auto base = (uint32_t) vertices.size();
+        vertices.insert(vertices.end(), meshVertices.begin(), meshVertices.end());
+        for(size_t i = 0; i + 2 < indexCount; i += 3)
+            queued.push_back({{base + indices[i], base + indices[i + 1], base + indices[i + 2]}, material, lightSet});
+    }
+
+    void SoftwareRasterizer::Setup(const QueuedTriangle &triangle, std::vector<SetupTriangle> &outTriangles,
+                                   std::vector<Varyings> &outVaryings) const {
+        // clip against the near plane (z >= -w); a triangle becomes a polygon of up to four corners.
+        SoftwareVertex polygon[4];
+        int corners = 0;
+        for(int i = 0; i < 3; i++){
+            const auto& a = vertices[triangle.vertices[i]];
+            const auto& b = vertices[triangle.vertices[(i + 1) % 3]];
+            auto da = a.clip.z + a.clip.w, db = b.clip.z + b.clip.w;
+            if(da >= 0.0f)
+                polygon[corners++] = a;
+            if((da >= 0.0f) != (db >= 0.0f)){
+                auto t = da / (da - db);
+                polygon[corners++] = {a.clip + (b.clip - a.clip) * t, a.position + (b.position - a.position) * t,
+                                      a.normal + (b.normal - a.normal) * t, a.uv + (b.uv - a.uv) * t};
+            }
+        }
+
+        for(int fan = 1; fan + 1 < corners; fan++){
+            const SoftwareVertex* v[3] = {&polygon[0], &polygon[fan], &polygon[fan + 1]};
+            glm::vec2 p[3];
+            SetupTriangle setup{};
+            for(int i = 0; i < 3; i++){
+                auto invW = 1.0f / v[i]->clip.w;
+                p[i] = {(v[i]->clip.x * invW * 0.5f + 0.5f) * (float) width,
+                        (v[i]->clip.y * invW * 0.5f + 0.5f) * (float) height};
+                setup.z[i] = v[i]->clip.z * invW * 0.5f + 0.5f;
+                setup.invW[i] = invW;
+            }
+
+            // twice the signed area; the sign tells the winding, so both windings yield positive barycentrics.
+            auto area = (p[2].x - p[1].x) * (p[0].y - p[1].y) - (p[2].y - p[1].y) * (p[0].x - p[1].x);
+            if(std::abs(area) < 1e-8f)
+                continue;
+
+            setup.minX = std::max(0, (int) std::floor(std::min({p[0].x, p[1].x, p[2].x})));
+            setup.minY = std::max(0, (int) std::floor(std::min({p[0].y, p[1].y, p[2].y})));
+            setup.maxX = std::min(width - 1, (int) std::ceil(std::max({p[0].x, p[1].x, p[2].x})));
+            setup.maxY = std::min(height - 1, (int) std::ceil(std::max({p[0].y, p[1].y, p[2].y})));
+            if(setup.minX > setup.maxX || setup.minY > setup.maxY)
+                continue;
+
+            // the barycentric coordinate of a corner is the edge function of the opposite edge over the area.
+            for(int i = 0; i < 3; i++){
+                const auto& a = p[(i + 1) % 3];
+                const auto& b = p[(i + 2) % 3];
+                setup.a[i] = -(b.y - a.y) / area;
+                setup.b[i] = (b.x - a.x) / area;
+                setup.c[i] = ((b.y - a.y) * a.x - (b.x - a.x) * a.y) / area;
+            }
+
+            setup.varyings = (uint32_t) outVaryings.size();
+            setup.material = triangle.material;
+            setup.lightSet = triangle.lightSet;
+            for(auto corner : v)
+                outVaryings.push_back({corner->position, corner->normal, corner->uv});
+            outTriangles.push_back(setup);
+        }
+    }
+
+    void SoftwareRasterizer::Resolve(ThreadPool *pool) {
+        // clip & set up chunks of triangles independently, then append them in submission order.
+        auto chunkCount = (queued.size() + SETUP_CHUNK_SIZE - 1) / SETUP_CHUNK_SIZE;
+        std::vector<std::vector<SetupTriangle>> chunkTriangles(chunkCount);
+        std::vector<std::vector<Varyings>> chunkVaryings(chunkCount);
+        auto setupChunks = [&](size_t begin, size_t end){
+            for(auto c = begin; c < end; c++){
+                auto last = std::min(queued.size(), (c + 1) * SETUP_CHUNK_SIZE);
+                for(auto i = c * SETUP_CHUNK_SIZE; i < last; i++)
+                    Setup(queued[i], chunkTriangles[c], chunkVaryings[c]);
+            }
+        };
+        if(pool)
+            pool->ParallelFor(chunkCount, setupChunks);
+        else
+            setupChunks(0, chunkCount);
+
+        for(size_t c = 0; c < chunkCount; c++){
+            auto offset = (uint32_t) varyings.size();
+            for(auto& triangle : chunkTriangles[c]){
+                triangle.varyings += offset;
+                triangles.push_back(triangle);
+            }
+            varyings.insert(varyings.end(), chunkVaryings[c].begin(), chunkVaryings[c].end());
+        }
+
+        // binning keeps the submission order within each tile, so depth ties resolve as on the GPU.
+        for(uint32_t t = 0; t < triangles.size(); t++){
+            const auto& triangle = triangles[t];
+            for(auto ty = triangle.minY / TILE_SIZE; ty <= triangle.maxY / TILE_SIZE; ty++)
+                for(auto tx = triangle.minX / TILE_SIZE; tx <= triangle.maxX / TILE_SIZE; tx++)
+                    bins[(size_t) ty * tilesX + tx].push_back(t);
+        }
+
+        // tiles cover disjoint pixels, so they can be rasterized without synchronization.
+        auto tileCount = (size_t) tilesX * tilesY;
+        auto rasterizeTiles = [&](size_t begin, size_t end){
+            for(auto tile = begin; tile < end; tile++)
+                RasterizeTile((int) tile);
+        };
+        if(pool)
+            pool->ParallelFor(tileCount, rasterizeTiles);
+        else
+            rasterizeTiles(0, tileCount);
+    }
+
+    void SoftwareRasterizer::RasterizeTile(int tile) {
+        auto tileX = (tile % tilesX) * TILE_SIZE;
+        auto tileY = (tile / tilesX) * TILE_SIZE;
+        auto tileMaxX = std::min(tileX + TILE_SIZE, width) - 1;
+        auto tileMaxY = std::min(tileY + TILE_SIZE, height) - 1;
+        const auto laneOffset = Float4::Ramp(0.5f);
+
+        for(auto index : bins[tile]){
+            const auto& t = triangles[index];
+            // start at a multiple of four pixels; the buffers' padded rows keep the last group in bounds.
+            auto x0 = std::max(t.minX, tileX) & ~3;
+            auto x1 = std::min(t.maxX, tileMaxX);
+            auto y0 = std::max(t.minY, tileY);
+            auto y1 = std::min(t.maxY, tileMaxY);
+            const Float4 a[3] = {Float4::Set(t.a[0]), Float4::Set(t.a[1]), Float4::Set(t.a[2])};
+            const Float4 z[3] = {Float4::Set(t.z[0]), Float4::Set(t.z[1]), Float4::Set(t.z[2])};
+            const auto zero = Float4::Set(0.0f);
+            const auto lastX = Float4::Set((float) x1 + 1.0f);
+
+            for(auto y = y0; y <= y1; y++){
+                auto py = (float) y + 0.5f;
+                Float4 rowBase[3];
+                for(int i = 0; i < 3; i++)
+                    rowBase[i] = Float4::Set(t.b[i] * py + t.c[i]);
+
+                auto* depthRow = &depth[(size_t) y * stride];
+                auto* colorRow = &color[(size_t) y * stride];
+                for(auto x = x0; x <= x1; x += 4){
+                    auto px = Float4::Set((float) x) + laneOffset;
+                    auto l0 = a[0] * px + rowBase[0];
+                    auto l1 = a[1] * px + rowBase[1];
+                    auto l2 = a[2] * px + rowBase[2];
+                    auto mask = l0.GreaterEqual(zero) & l1.GreaterEqual(zero) & l2.GreaterEqual(zero) & px.Less(lastX);
+                    if(!mask)
+                        continue;
+
+                    // depth is affine in screen space.
+                    auto fragDepth = l0 * z[0] + l1 * z[1] + l2 * z[2];
+                    mask &= fragDepth.Less(Float4::Load(depthRow + x)) & fragDepth.GreaterEqual(zero);
+                    if(!mask)
+                        continue;
+
+                    float b0[4], b1[4], b2[4], d[4];
+                    l0.Store(b0);
+                    l1.Store(b1);
+                    l2.Store(b2);
+                    fragDepth.Store(d);
+                    for(int lane = 0; lane < 4; lane++){
+                        if(!(mask & (1 << lane)))
+                            continue;
+                        // perspective-correct weights of the corners' attributes.
+                        auto w = glm::vec3(b0[lane], b1[lane], b2[lane]) * t.invW;
+                        w /= w.x + w.y + w.z;
+                        depthRow[x + lane] = d[lane];
+                        colorRow[x + lane] = PackColor(Shade(t, w));
+                    }
+                }
+            }
+        }
+    }
+
+    glm::vec4 SoftwareRasterizer::Shade(const SetupTriangle &triangle, const glm::vec3 &weights) const {
+        const auto* corner = &varyings[triangle.varyings];
+        auto fragPos = corner[0].position * weights.x + corner[1].position * weights.y + corner[2].position * weights.z;
+        auto uv = corner[0].uv * weights.x + corner[1].uv * weights.y + corner[2].uv * weights.z;
+        auto normal = corner[0].normal * weights.x + corner[1].normal * weights.y + corner[2].normal * weights.z;
+        auto length = glm::length(normal);
+        normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+
+        const auto& material = materials[triangle.material];
+        auto texel = material.texture ? material.texture(uv * material.tiling) : glm::vec4(1.0f);
+        if(shading.model == SoftwareShadingModel::Unlit)
+            return glm::vec4(material.diffuse, material.alpha) * texel;
+
+        const auto& set = lightSets[triangle.lightSet];
+        // out of range of all loaders: ambient only.
+        if(set.count < 0)
+            return glm::vec4(shading.ambient * material.diffuse * glm::vec3(texel), material.alpha);
+
+        auto result = shading.ambient * material.diffuse;
+        auto shiny = 1.0f - material.roughness;
+        auto shinyFactor = 1.0f + (shading.specular - 1.0f) * shiny;
+        auto view = glm::normalize(shading.cameraPosition - fragPos);
+        for(int i = 0; i < set.count; i++){
+            const auto& light = lights[set.offset + i];
+            auto toLight = light.position - fragPos;
+            auto distance = glm::length(toLight);
+            if(distance > light.range)
+                continue;
+            auto lightDir = toLight / std::max(distance, 1e-6f);
+            auto NdotL = glm::dot(normal, lightDir);
+
+            float intensity, diffuse;
+            if(shading.model == SoftwareShadingModel::Toon){
+                auto levels = (float) shading.toonLevels;
+                intensity = std::min(1.0f, light.intensity);
+                diffuse = 1.0f - std::floor(std::max(0.0f, -NdotL) * levels) / levels;
+            }
+            else{
+                auto dist = std::max(distance, 0.01f);
+                intensity = light.intensity / (dist * dist);
+                diffuse = std::max(0.0f, NdotL);
+            }
+            result += intensity * light.emission * material.diffuse * diffuse;
+
+            // specular only if the light is in front of the fragment.
+            if(NdotL > 0.0f){
+                auto half = glm::normalize(lightDir + view);
+                auto angle = std::max(0.001f, glm::dot(normal, half));
+                result += intensity * light.emission * std::pow(angle, shinyFactor);
+            }
+        }
+        return glm::vec4(result, material.alpha) * texel;
+    }
+
+    bool SoftwareRasterizer::WritePPM(const std::string &path) const {
+        std::ofstream file(path, std::ios::binary);
+        if(!file)
+            return false;
+
+        file << "P6\n" << width << " " << height << "\n255\n";
+        // PPM stores the top row first.
+        std::vector<char> row((size_t) width * 3);
+        for(auto y = height - 1; y >= 0; y--){
+            for(int x = 0; x < width; x++){
+                auto pixel = color[(size_t) y * stride + x];
+                row[3 * x] = (char) (pixel & 0xFF);
+                row[3 * x + 1] = (char) ((pixel >> 8) & 0xFF);
+                row[3 * x + 2] = (char) ((pixel >> 16) & 0xFF);
+            }
+            file.write(row.data(), (std::streamsize) row.size());
+        }
+        return (bool) file;
+    }
+}
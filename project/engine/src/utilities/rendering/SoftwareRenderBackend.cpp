@@ -0,0 +1,139 @@
+#include "engine/utilities/rendering/SoftwareRenderBackend.h"
+#include "engine/utilities/ThreadPool.h"
+#include "engine/components/meshes/Mesh3D.h"
+#include "engine/components/PointLight.h"
+#include "engine/components/Renderer.h"
+
+#include <limits>
+
+// the smallest amount of vertices transformed per task.
+#define VERTEX_CHUNK_SIZE 4096
+
+namespace EisEngine::rendering {
+    using components::Mesh3D;
+
+    SoftwareRenderBackend::SoftwareRenderBackend(ThreadPool *pool) : pool(pool) { }
+
+    SoftwareRenderBackend::SoftwareRenderBackend() : SoftwareRenderBackend(&ThreadPool::Global()) { }
+
+    // the shading model matching a 3D shader's name.
+    SoftwareShadingModel ShadingModelOf(const std::string& shader){
+        if(shader == "Toon")
+            return SoftwareShadingModel::Toon;
+        return SoftwareShadingModel::BlinnPhong;
+    }
+
+    void SoftwareRenderBackend::BeginFrame(const FrameParameters &parameters) {
+        frame = parameters;
+        rasterizer.Resize((int) parameters.screenSize.x, (int) parameters.screenSize.y);
+        rasterizer.BeginFrame({shadingOverride.value_or(ShadingModelOf(parameters.shader)), parameters.cameraPosition,
+                               parameters.ambient, parameters.specular, parameters.toonLevels}, clearColor);
+
+        std::vector<SoftwareLight> lights;
+        if(parameters.frameLights)
+            for(const auto& light : *parameters.frameLights)
+                lights.push_back({glm::vec3(light.posRange), glm::vec3(light.emissionIntensity),
+                                  light.emissionIntensity.w, light.posRange.w});
+        frameLightSet = rasterizer.AddLightSet(lights.data(), (int) lights.size());
+    }
+
+    void SoftwareRenderBackend::EndFrame() {
+        rasterizer.Resolve(pool);
+    }
+
+    void SoftwareRenderBackend::UploadInstances(const std::vector<InstanceData> &newInstances) {
+        instances = newInstances;
+    }
+
+    void SoftwareRenderBackend::Submit(const RenderCommandList &list, Shader *activeShader) {
+        auto material = rasterizer.AddMaterial({});
+        auto lightSet = rasterizer.AddLightSet(nullptr, -1);
+        TransformBlock transform = {glm::mat4(1.0f), glm::mat4(1.0f), glm::mat3(1.0f)};
+
+        // the indices of a mesh's current detail level.
+        auto lodIndices = [](const Mesh3D& mesh) -> const std::vector<unsigned int>& {
+            auto level = mesh.GetLODLevel();
+            return level == 0 ? mesh.primitive.indices : mesh.primitive.GetLODs()[level - 1].indices;
+        };
+        // runs the vertex stage of a mesh for one object.
+        auto transformVertices = [&](const Mesh3D& mesh, const glm::mat4& mvp, const glm::mat4& model,
+                                     const glm::mat3& normalMat){
+            const auto& positions = mesh.primitive.GetPositionData();
+            const auto& normals = mesh.primitive.GetNormalData();
+            const auto& uvs = mesh.primitive.GetUVData();
+            transformed.resize(positions.size());
+            auto transformRange = [&](size_t begin, size_t end){
+                for(auto i = begin; i < end; i++){
+                    auto position = glm::vec4(positions[i], 1.0f);
+                    transformed[i] = {mvp * position, glm::vec3(model * position),
+                                      i < normals.size() ? normalMat * normals[i] : glm::vec3(0.0f),
+                                      i < uvs.size() ? uvs[i] : glm::vec2(0.0f)};
+                }
+            };
+            if(pool)
+                pool->ParallelFor(positions.size(), transformRange, VERTEX_CHUNK_SIZE);
+            else
+                transformRange(0, positions.size());
+        };
+
+        for(const auto& command : list.GetCommands()){
+            switch(command.type){
+                case RenderCommandType::SetMaterial: {
+                    auto renderer = list.GetMaterial(command.payload);
+                    const auto& mat = *renderer->material;
+                    glm::vec3 diffuse = renderer->material->GetDiffuse();
+                    SoftwareMaterial softwareMaterial = {diffuse, mat.GetOpacity(), mat.GetTiling(), mat.GetRoughness()};
+                    if(auto texture = renderer->GetDiffuseTexture())
+                        softwareMaterial.texture = [texture](const glm::vec2& uv){ return texture->Sample(uv);};
+                    material = rasterizer.AddMaterial(std::move(softwareMaterial));
+                    break;
+                }
+                case RenderCommandType::SetTransform:
+                    transform = list.GetTransform(command.payload);
+                    break;
+                case RenderCommandType::SetLights: {
+                    const auto& block = list.GetLights(command.payload);
+                    // lit per fragment (clustered lighting) by all of the frame's lights in range.
+                    if(block.count == 0 && frame.frameLights){
+                        lightSet = frameLightSet;
+                        break;
+                    }
+                    std::array<SoftwareLight, MAX_LIGHTS> lights;
+                    for(int i = 0; i < block.count; i++)
+                        lights[i] = {block.lights[i]->position(), block.lights[i]->GetEmission(),
+                                     block.lights[i]->GetIntensity(), std::numeric_limits<float>::infinity()};
+                    lightSet = rasterizer.AddLightSet(lights.data(), block.count);
+                    break;
+                }
+                case RenderCommandType::DrawMesh: {
+                    const auto& draw = list.GetDraw(command.payload);
+                    const auto& mesh = *draw.mesh;
+                    const auto& indices = lodIndices(mesh);
+
+                    if(draw.instanceCount == 0){
+                        transformVertices(mesh, transform.mvp, transform.model, transform.normalMat);
+                        rasterizer.DrawTriangles(transformed, indices.data(), indices.size(), material, lightSet);
+                        break;
+                    }
+                    for(auto i = draw.firstInstance; i < draw.firstInstance + draw.instanceCount; i++){
+                        const auto& instance = instances[i];
+                        transformVertices(mesh, frame.vp * instance.model, instance.model, instance.normalMat);
+                        rasterizer.DrawTriangles(transformed, indices.data(), indices.size(), material, lightSet);
+                    }
+                    break;
+                }
+                case RenderCommandType::DrawMeshes: {
+                    const auto& draw = list.GetMultiDraw(command.payload);
+                    for(int i = 0; i < draw.drawCount; i++){
+                        const auto& mesh = *list.GetMultiDrawMesh(draw.firstMesh + i);
+                        const auto& indices = lodIndices(mesh);
+                        const auto& instance = instances[draw.firstDraw + i];
+                        transformVertices(mesh, frame.vp * instance.model, instance.model, instance.normalMat);
+                        rasterizer.DrawTriangles(transformed, indices.data(), indices.size(), material, lightSet);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#include "engine/utilities/rendering/SpriteBatcher.h"
+#include "engine/utilities/rendering/PrimitiveSpriteMesh.h"
+#include "engine/utilities/ThreadPool.h"
+#include "engine/utilities/Simd.h"
+
+#include <algorithm>
+#include <cmath>
+
+// the smallest amount of sprites transformed per task.
+#define SPRITE_CHUNK_SIZE 256
+
+namespace EisEngine::rendering {
+    uint32_t SpriteBatcher::PackColor(const glm::vec4 &color) {
+        auto toByte = [](float v){ return (uint32_t) std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f);};
+        return toByte(color.x) | toByte(color.y) << 8 | toByte(color.z) << 16 | toByte(color.w) << 24;
+    }
+
+    void SpriteBatcher::Begin() {
+        sprites.clear();
+        pages.clear();
+    }
+
+    void SpriteBatcher::Add(const PrimitiveSpriteMesh &mesh, const glm::mat4 &model, uint32_t color,
+                            Texture2D *texture, const glm::vec4 &uvRect) {
+        auto page = pages.emplace(texture, (uint32_t) pages.size()).first->second;
+        sprites.push_back({&mesh, model, uvRect, texture, color, page, 0, 0});
+    }
+
+    void SpriteBatcher::Build(bool sortByDepth, ThreadPool *pool) {
+        // depth (if sorted) in the high bits, so that textures are only grouped among sprites of equal depth.
+        order.resize(sprites.size());
+        for(uint32_t i = 0; i < sprites.size(); i++){
+            uint64_t depth = sortByDepth ? OrderedFloatBits(sprites[i].model[3].z) : 0;
+            order[i] = {depth << 32 | sprites[i].page, i};
+        }
+        RadixSort(order, sortScratch);
+
+        // assign the output ranges in draw order & split batches at texture changes.
+        batches.clear();
+        uint32_t vertexCount = 0, indexCount = 0;
+        for(const auto& entry : order){
+            auto& sprite = sprites[entry.index];
+            sprite.firstVertex = vertexCount;
+            sprite.firstIndex = indexCount;
+            vertexCount += (uint32_t) sprite.mesh->GetSpriteVertices().size();
+            indexCount += (uint32_t) sprite.mesh->indices.size();
+
+            if(batches.empty() || batches.back().texture != sprite.texture)
+                batches.push_back({sprite.texture, sprite.firstIndex, 0});
+            batches.back().indexCount = indexCount - batches.back().firstIndex;
+        }
+        vertices.resize(vertexCount);
+        indices.resize(indexCount);
+
+        auto writeRange = [this](size_t begin, size_t end){
+            for(auto i = begin; i < end; i++)
+                WriteSprite(sprites[i]);
+        };
+        if(pool)
+            pool->ParallelFor(sprites.size(), writeRange, SPRITE_CHUNK_SIZE);
+        else
+            writeRange(0, sprites.size());
+    }
+
+    void SpriteBatcher::WriteSprite(const Sprite &sprite) {
+        const auto& meshVertices = sprite.mesh->GetSpriteVertices();
+        auto* out = vertices.data() + sprite.firstVertex;
+        // position = model[0] * x + model[1] * y + model[2] * z + model[3], one column per Float4.
+        const auto c0 = Float4::Load(&sprite.model[0][0]);
+        const auto c1 = Float4::Load(&sprite.model[1][0]);
+        const auto c2 = Float4::Load(&sprite.model[2][0]);
+        const auto c3 = Float4::Load(&sprite.model[3][0]);
+        float result[4];
+        for(size_t v = 0; v < meshVertices.size(); v++){
+            const auto& p = meshVertices[v].modelPosition;
+            auto position = c0 * Float4::Set(p.x) + c1 * Float4::Set(p.y) + (c2 * Float4::Set(p.z) + c3);
+            position.Store(result);
+            out[v].position = glm::vec3(result[0], result[1], result[2]);
+            out[v].uv = glm::vec2(sprite.uvRect.x, sprite.uvRect.y) +
+                        meshVertices[v].texturePosition * glm::vec2(sprite.uvRect.z, sprite.uvRect.w);
+            out[v].color = sprite.color;
+        }
+
+        const auto& meshIndices = sprite.mesh->indices;
+        for(size_t i = 0; i < meshIndices.size(); i++)
+            indices[sprite.firstIndex + i] = sprite.firstVertex + meshIndices[i];
+    }
+}
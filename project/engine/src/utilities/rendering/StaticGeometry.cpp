@@ -0,0 +1,75 @@
+#include "engine/utilities/rendering/StaticGeometry.h"
+#include "engine/utilities/rendering/GLStateCache.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// the initial capacities of the vertex & index arenas in bytes; all double when full.
+#define VERTEX_ARENA_CAPACITY (16 << 20)
+#define SHORT_INDEX_ARENA_CAPACITY (4 << 20)
+#define INDEX_ARENA_CAPACITY (4 << 20)
+// meshes with fewer vertices are indexed with 16 bits.
+#define SHORT_INDEX_VERTEX_LIMIT 65536
+
+namespace EisEngine::rendering {
+    // vertex allocations are aligned to whole vertices, so that their offsets translate into base vertices.
+    GeometryArena StaticGeometry::vertexArena = GeometryArena(VERTEX_ARENA_CAPACITY, sizeof(StaticVertex));
+    GeometryArena StaticGeometry::shortIndexArena = GeometryArena(SHORT_INDEX_ARENA_CAPACITY, sizeof(uint16_t));
+    GeometryArena StaticGeometry::indexArena = GeometryArena(INDEX_ARENA_CAPACITY, sizeof(unsigned int));
+
+    // points a vertex attribute to a member of the interleaved vertices, if the program uses it.
+    void BindAttribute(GLuint shaderProgram, const char* name, GLint size, size_t offset){
+        auto location = glGetAttribLocation(shaderProgram, name);
+        if(location == -1)
+            return;
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, size, GL_FLOAT, GL_FALSE, sizeof(StaticVertex), (GLvoid*) offset);
+    }
+
+    StaticGeometryRange StaticGeometry::Upload(const std::vector<StaticVertex> &vertices,
+                                               const std::vector<unsigned int> &indices) {
+        StaticGeometryRange range;
+        range.vertices = vertexArena.Allocate(vertices.data(), vertices.size() * sizeof(StaticVertex));
+        if(vertices.size() >= SHORT_INDEX_VERTEX_LIMIT){
+            range.indices = indexArena.Allocate(indices.data(), indices.size() * sizeof(unsigned int));
+            return range;
+        }
+        std::vector<uint16_t> shortIndices(indices.begin(), indices.end());
+        range.indexType = GL_UNSIGNED_SHORT;
+        range.indices = shortIndexArena.Allocate(shortIndices.data(), shortIndices.size() * sizeof(uint16_t));
+        return range;
+    }
+
+    void StaticGeometry::Release(const StaticGeometryRange &range) {
+        vertexArena.Free(range.vertices);
+        (range.indexType == GL_UNSIGNED_SHORT ? shortIndexArena : indexArena).Free(range.indices);
+    }
+
+    GLint StaticGeometry::GetBaseVertex(const StaticGeometryRange &range) {
+        if(range.vertices == GeometryArena::INVALID_HANDLE)
+            return 0;
+        return (GLint) (vertexArena.GetOffset(range.vertices) / sizeof(StaticVertex));
+    }
+
+    GLuint StaticGeometry::GetFirstIndex(const StaticGeometryRange &range) {
+        if(range.indices == GeometryArena::INVALID_HANDLE)
+            return 0;
+        return (GLuint) (GetIndexArena(range.indexType).GetOffset(range.indices) / GetIndexSize(range.indexType));
+    }
+
+    void StaticGeometry::Bind(GLuint shaderProgram, GLenum indexType) {
+        GLStateCache::BindBuffer(GL_ARRAY_BUFFER, vertexArena.GetBufferID());
+        BindAttribute(shaderProgram, "aPos", 3, offsetof(StaticVertex, position));
+        BindAttribute(shaderProgram, "normal", 3, offsetof(StaticVertex, normal));
+        BindAttribute(shaderProgram, "texCoords", 2, offsetof(StaticVertex, uv));
+        BindAttribute(shaderProgram, "tan", 3, offsetof(StaticVertex, tangent));
+        BindAttribute(shaderProgram, "bitan", 3, offsetof(StaticVertex, bitangent));
+        GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, GetIndexArena(indexType).GetBufferID());
+    }
+
+    void StaticGeometry::Defragment() {
+        vertexArena.Defragment();
+        shortIndexArena.Defragment();
+        indexArena.Defragment();
+    }
+}
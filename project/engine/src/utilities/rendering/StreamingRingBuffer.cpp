@@ -0,0 +1,112 @@
+#include "engine/utilities/rendering/StreamingRingBuffer.h"
+#include "engine/utilities/Debug.h"
+#include "engine/utilities/rendering/GLStateCache.h"
+
+#include <cstring>
+#include <string>
+
+namespace EisEngine::rendering {
+    StreamingRingBuffer::StreamingRingBuffer(size_t capacity) : capacity(capacity) {
+        // immutable storage can stay mapped while the GPU reads it; coherent mapping makes writes
+        // visible without explicit flushes.
+        auto flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glGenBuffers(1, &buffer);
+        GLStateCache::BindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferStorage(GL_ARRAY_BUFFER, (GLsizeiptr) capacity, nullptr, flags);
+        mapped = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr) capacity, flags));
+        DEBUG_OPENGL("Streaming Ring Buffer")
+        if(!mapped)
+            DEBUG_RUNTIME_ERROR("Could not map the streaming ring buffer.")
+    }
+
+    StreamingRingBuffer::~StreamingRingBuffer() {
+        for(auto& fence : fences)
+            glDeleteSync(fence.sync);
+        GLStateCache::BindBuffer(GL_ARRAY_BUFFER, buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        GLStateCache::OnBufferDeleted(buffer);
+        glDeleteBuffers(1, &buffer);
+    }
+
+    StreamingAllocation StreamingRingBuffer::Allocate(size_t size, size_t alignment) {
+        if(size > capacity){
+            DEBUG_ERROR("Streaming allocation of " + std::to_string(size) + " bytes exceeds the buffer's capacity.")
+            return {};
+        }
+
+        auto offset = (head + alignment - 1) / alignment * alignment;
+        // the bytes between the head & the allocation are padding.
+        auto required = offset - head + size;
+        auto wrapped = offset + size > capacity;
+        if(wrapped){
+            // the remainder of the buffer is skipped & released together with the frame allocating it.
+            offset = 0;
+            required = capacity - head + size;
+        }
+
+        while(capacity - used < required){
+            // nothing in flight anymore: the skipped remainder does not need to be reserved.
+            if(used == 0){
+                required = size;
+                break;
+            }
+            // the current frame alone fills the buffer: its memory is not read until its draws are submitted,
+            // so it cannot be reused within the frame.
+            if(fences.empty()){
+                stats.failedAllocations++;
+                return {};
+            }
+            RetireOldestFence();
+        }
+
+        if(wrapped)
+            stats.wrapArounds++;
+        head = offset + size;
+        used += required;
+        pending += required;
+        stats.allocations++;
+        stats.bytes += required;
+        return {mapped + offset, (GLintptr) offset};
+    }
+
+    StreamingAllocation StreamingRingBuffer::Write(const void *data, size_t size, size_t alignment) {
+        auto allocation = Allocate(size, alignment);
+        if(allocation.data)
+            std::memcpy(allocation.data, data, size);
+        return allocation;
+    }
+
+    void StreamingRingBuffer::EndFrame() {
+        if(pending > 0)
+            PushFence();
+        // release frames the GPU already finished without waiting.
+        while(!fences.empty() && glClientWaitSync(fences.front().sync, 0, 0) != GL_TIMEOUT_EXPIRED)
+            RetireOldestFence();
+        stats.bytesInFlight = used;
+    }
+
+    void StreamingRingBuffer::ResetStats() { stats = {0, 0, 0, 0, 0, 0, used};}
+
+    void StreamingRingBuffer::PushFence() {
+        fences.push_back({glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), pending});
+        pending = 0;
+    }
+
+    void StreamingRingBuffer::RetireOldestFence() {
+        auto fence = fences.front();
+        fences.pop_front();
+        auto status = glClientWaitSync(fence.sync, 0, 0);
+        if(status == GL_TIMEOUT_EXPIRED){
+            stats.stalls++;
+            // flush so that the fence is guaranteed to be signaled eventually.
+            do status = glClientWaitSync(fence.sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+            while(status == GL_TIMEOUT_EXPIRED);
+        }
+        else
+            stats.fencesRetired++;
+        if(status == GL_WAIT_FAILED)
+            DEBUG_ERROR("Waiting for a streaming ring buffer fence failed.")
+        glDeleteSync(fence.sync);
+        used -= fence.bytes;
+    }
+}
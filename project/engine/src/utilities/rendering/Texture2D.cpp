@@ -1,16 +1,30 @@
 #include "engine/utilities/rendering/Texture2D.h"
 #include "engine/utilities/rendering/Shader.h"
+#include "engine/Context.h"
+#include "engine/utilities/rendering/GLStateCache.h"
+
+#include <algorithm>
+#include <cmath>
 
 namespace EisEngine {
     Texture2D::Texture2D() :
     Width(0), Height(0), internalFormat(GL_RGB), imageFormat(GL_RGB), wrapS(GL_REPEAT), wrapT(GL_REPEAT),
     minFilterMode(GL_LINEAR_MIPMAP_LINEAR), maxFilterMode(GL_LINEAR)
-    { glGenTextures(1, &textureID);}
+    {
+        if(ctx::Context::HasGraphics())
+            glGenTextures(1, &textureID);
+    }
 
     void Texture2D::Generate(unsigned int width, unsigned int height, unsigned char *data) {
         Width = width;
         Height = height;
-        glBindTexture(GL_TEXTURE_2D, textureID);
+        // keep the image on the CPU for software rendering.
+        if(!ctx::Context::HasGraphics()){
+            auto channels = imageFormat == GL_RED ? 1 : imageFormat == GL_RGB ? 3 : 4;
+            pixels.assign(data, data + (size_t) width * height * channels);
+            return;
+        }
+        rendering::GLStateCache::BindTexture(GL_TEXTURE_2D, textureID);
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
         glTexImage2D(GL_TEXTURE_2D, 0, (GLint) internalFormat, (GLint) width,
                      (GLint) height,0,imageFormat,GL_UNSIGNED_BYTE,data);
@@ -22,10 +36,62 @@ namespace EisEngine {
 
         glGenerateMipmap(GL_TEXTURE_2D);
 
-        glBindTexture(GL_TEXTURE_2D, 0);
+        rendering::GLStateCache::BindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    void Texture2D::UpdateRegion(unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+                                 unsigned int rowLength, const unsigned char *data) {
+        auto channels = imageFormat == GL_RED ? 1 : imageFormat == GL_RGB ? 3 : 4;
+        if(!ctx::Context::HasGraphics()){
+            for(unsigned int row = 0; row < height; row++)
+                std::copy_n(data + (size_t) row * rowLength * channels, (size_t) width * channels,
+                            pixels.begin() + ((size_t) (y + row) * Width + x) * channels);
+            return;
+        }
+        rendering::GLStateCache::BindTexture(GL_TEXTURE_2D, textureID);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, (GLint) rowLength);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, (GLint) x, (GLint) y, (GLsizei) width, (GLsizei) height,
+                        imageFormat, GL_UNSIGNED_BYTE, data);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        rendering::GLStateCache::BindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    std::vector<unsigned char> Texture2D::ReadPixels() const {
+        std::vector<unsigned char> rgba((size_t) Width * Height * 4);
+        if(ctx::Context::HasGraphics()){
+            rendering::GLStateCache::BindTexture(GL_TEXTURE_2D, textureID);
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+            rendering::GLStateCache::BindTexture(GL_TEXTURE_2D, 0);
+            return rgba;
+        }
+        if(pixels.empty())
+            return rgba;
+        // expand the CPU-side copy like GL does: missing color channels are 0, missing alpha is opaque.
+        auto channels = pixels.size() / ((size_t) Width * Height);
+        for(size_t i = 0; i < (size_t) Width * Height; i++)
+            for(size_t c = 0; c < 4; c++)
+                rgba[4 * i + c] = c < channels ? pixels[channels * i + c] : c == 3 ? 255 : 0;
+        return rgba;
+    }
+
+    glm::vec4 Texture2D::Sample(const glm::vec2 &uv) const {
+        if(pixels.empty())
+            return glm::vec4(1.0f);
+
+        auto channels = pixels.size() / ((size_t) Width * Height);
+        auto x = (unsigned int) ((uv.x - std::floor(uv.x)) * (float) Width) % Width;
+        auto y = (unsigned int) ((uv.y - std::floor(uv.y)) * (float) Height) % Height;
+        auto texel = &pixels[((size_t) y * Width + x) * channels];
+        if(channels == 1)
+            return glm::vec4(texel[0] / 255.0f, 0.0f, 0.0f, 1.0f);
+        return glm::vec4(texel[0] / 255.0f, texel[1] / 255.0f, texel[2] / 255.0f,
+                         channels == 4 ? texel[3] / 255.0f : 1.0f);
     }
 
     void Texture2D::Bind() const {
-        glBindTexture(GL_TEXTURE_2D, textureID);
+        rendering::GLStateCache::BindTexture(GL_TEXTURE_2D, textureID);
     }
 }
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include "engine/utilities/rendering/TextureAtlas.h"
+#include "engine/utilities/rendering/Texture2D.h"
+#include "engine/utilities/Debug.h"
+#include "engine/Context.h"
+#include "engine/utilities/rendering/GLStateCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <tuple>
+
+// the rect packer vendored with ImGui, compiled privately into this translation unit.
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "gui/imstb_rectpack.h"
+
+namespace EisEngine::rendering {
+    struct TextureAtlas::Page {
+        stbrp_context context;
+        std::vector<stbrp_node> nodes;
+        /// \n The page's image as rows of RGBA8 pixels.
+        std::vector<unsigned char> pixels;
+        /// \n The page's texture (AtlasMode::Pages).
+        std::unique_ptr<Texture2D> texture;
+        /// \n The rectangle modified since the last flush; empty if minX > maxX.
+        int minX, minY, maxX, maxY;
+
+        void Reset(int size){
+            nodes.resize(size);
+            stbrp_init_target(&context, size, size, nodes.data(), (int) nodes.size());
+            pixels.assign((size_t) size * size * 4, 0);
+            MarkDirty(0, 0, size, size);
+        }
+
+        void MarkDirty(int x, int y, int width, int height){
+            minX = std::min(minX, x);
+            minY = std::min(minY, y);
+            maxX = std::max(maxX, x + width);
+            maxY = std::max(maxY, y + height);
+        }
+
+        void ClearDirty(){
+            minX = minY = std::numeric_limits<int>::max();
+            maxX = maxY = std::numeric_limits<int>::lowest();
+        }
+    };
+
+    TextureAtlas::TextureAtlas(int pageSize, int padding, AtlasMode mode) :
+    pageSize(pageSize), padding(padding), mode(mode) { }
+
+    TextureAtlas::~TextureAtlas() = default;
+
+    const AtlasRegion *TextureAtlas::Add(const Texture2D *source, int width, int height, const unsigned char *rgba) {
+        if(width + 2 * padding > pageSize || height + 2 * padding > pageSize){
+            DEBUG_WARN("Texture of size " + std::to_string(width) + "x" + std::to_string(height) +
+                       " does not fit into an atlas page.")
+            return nullptr;
+        }
+        if(auto existing = Find(source))
+            return existing;
+
+        auto& entry = entries[source];
+        entry.region.width = width;
+        entry.region.height = height;
+        entry.pixels.assign(rgba, rgba + (size_t) width * height * 4);
+
+        if(Place(entry))
+            Blit(entry);
+        // reclaim the space of removed textures before growing.
+        else if(fragmented)
+            Repack();
+        else {
+            AddPage();
+            Place(entry);
+            Blit(entry);
+        }
+        return &entry.region;
+    }
+
+    const AtlasRegion *TextureAtlas::Find(const Texture2D *source) const {
+        auto it = entries.find(source);
+        return it == entries.end() ? nullptr : &it->second.region;
+    }
+
+    void TextureAtlas::Remove(const Texture2D *source) {
+        if(entries.erase(source) > 0)
+            fragmented = true;
+    }
+
+    void TextureAtlas::Repack() {
+        std::vector<Entry*> sorted;
+        sorted.reserve(entries.size());
+        for(auto& [source, entry] : entries)
+            sorted.push_back(&entry);
+        // tall textures first leave the fewest gaps in the packer's skyline.
+        std::sort(sorted.begin(), sorted.end(), [](const Entry* a, const Entry* b){
+            return std::tie(a->region.height, a->region.width) > std::tie(b->region.height, b->region.width);
+        });
+
+        for(auto& page : pages)
+            page->Reset(pageSize);
+        for(auto entry : sorted){
+            if(!Place(*entry)){
+                AddPage();
+                Place(*entry);
+            }
+            Blit(*entry);
+        }
+        fragmented = false;
+    }
+
+    bool TextureAtlas::Place(Entry &entry) {
+        auto& region = entry.region;
+        for(size_t i = 0; i < pages.size(); i++){
+            stbrp_rect rect = {0, region.width + 2 * padding, region.height + 2 * padding};
+            stbrp_pack_rects(&pages[i]->context, &rect, 1);
+            if(!rect.was_packed)
+                continue;
+            region.page = pages[i]->texture.get();
+            region.layer = (int) i;
+            region.x = rect.x + padding;
+            region.y = rect.y + padding;
+            auto size = (float) pageSize;
+            region.uvRect = glm::vec4((float) region.x / size, (float) region.y / size,
+                                      (float) region.width / size, (float) region.height / size);
+            return true;
+        }
+        return false;
+    }
+
+    void TextureAtlas::Blit(const Entry &entry) {
+        const auto& region = entry.region;
+        auto& page = *pages[region.layer];
+        for(int row = -padding; row < region.height + padding; row++){
+            auto sourceRow = std::clamp(row, 0, region.height - 1);
+            auto* target = &page.pixels[((size_t) (region.y + row) * pageSize + region.x - padding) * 4];
+            auto* source = &entry.pixels[(size_t) sourceRow * region.width * 4];
+            // the padding repeats the edge pixels.
+            for(int column = -padding; column < region.width + padding; column++, target += 4)
+                std::memcpy(target, source + std::clamp(column, 0, region.width - 1) * 4, 4);
+        }
+        page.MarkDirty(region.x - padding, region.y - padding, region.width + 2 * padding, region.height + 2 * padding);
+    }
+
+    TextureAtlas::Page &TextureAtlas::AddPage() {
+        auto& page = *pages.emplace_back(std::make_unique<Page>());
+        page.ClearDirty();
+        page.Reset(pageSize);
+        if(mode == AtlasMode::Pages){
+            page.texture = std::unique_ptr<Texture2D>(new Texture2D());
+            page.texture->internalFormat = GL_RGBA;
+            page.texture->imageFormat = GL_RGBA;
+            page.texture->wrapS = GL_CLAMP_TO_EDGE;
+            page.texture->wrapT = GL_CLAMP_TO_EDGE;
+            page.texture->Generate(pageSize, pageSize, page.pixels.data());
+            page.ClearDirty();
+        }
+        return page;
+    }
+
+    void TextureAtlas::Flush() {
+        auto hasGraphics = ctx::Context::HasGraphics();
+        if(mode == AtlasMode::Pages){
+            for(auto& page : pages){
+                if(page->minX < page->maxX)
+                    page->texture->UpdateRegion(page->minX, page->minY, page->maxX - page->minX,
+                                                page->maxY - page->minY, pageSize,
+                                                &page->pixels[((size_t) page->minY * pageSize + page->minX) * 4]);
+                page->ClearDirty();
+            }
+            return;
+        }
+
+        if(!hasGraphics){
+            for(auto& page : pages)
+                page->ClearDirty();
+            return;
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        // new layers require new storage: reallocate & upload all layers.
+        if(arrayLayers != pages.size()){
+            if(arrayTexture){
+                GLStateCache::OnTextureDeleted(arrayTexture);
+                glDeleteTextures(1, &arrayTexture);
+            }
+            glGenTextures(1, &arrayTexture);
+            GLStateCache::BindTexture(GL_TEXTURE_2D_ARRAY, arrayTexture);
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, pageSize, pageSize, (GLsizei) pages.size(), 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            arrayLayers = pages.size();
+            for(auto& page : pages)
+                page->MarkDirty(0, 0, pageSize, pageSize);
+        }
+        else
+            GLStateCache::BindTexture(GL_TEXTURE_2D_ARRAY, arrayTexture);
+
+        auto modified = false;
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, pageSize);
+        for(size_t layer = 0; layer < pages.size(); layer++){
+            auto& page = *pages[layer];
+            if(page.minX < page.maxX){
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, page.minX, page.minY, (GLint) layer,
+                                page.maxX - page.minX, page.maxY - page.minY, 1, GL_RGBA, GL_UNSIGNED_BYTE,
+                                &page.pixels[((size_t) page.minY * pageSize + page.minX) * 4]);
+                modified = true;
+            }
+            page.ClearDirty();
+        }
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        if(modified)
+            glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+        GLStateCache::BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        DEBUG_OPENGL("Texture Atlas")
+    }
+
+    void TextureAtlas::BindArray() const { GLStateCache::BindTexture(GL_TEXTURE_2D_ARRAY, arrayTexture);}
+
+    void TextureAtlas::Clear() {
+        if(ctx::Context::HasGraphics()){
+            for(auto& page : pages)
+                if(page->texture){
+                    GLStateCache::OnTextureDeleted(page->texture->textureID);
+                    glDeleteTextures(1, &page->texture->textureID);
+                }
+            if(arrayTexture){
+                GLStateCache::OnTextureDeleted(arrayTexture);
+                glDeleteTextures(1, &arrayTexture);
+            }
+        }
+        arrayTexture = 0;
+        arrayLayers = 0;
+        entries.clear();
+        pages.clear();
+        fragmented = false;
+    }
+}